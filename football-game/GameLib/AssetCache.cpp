@@ -0,0 +1,386 @@
+/**
+ * @file AssetCache.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "AssetCache.h"
+#include "LevelData.h"
+#include "Telemetry.h"
+#include "ImageDiskCache.h"
+#include "MappedFile.h"
+#include "AssetPack.h"
+#include "WorkerPool.h"
+
+#include <wx/mstream.h>
+#include <algorithm>
+#include <thread>
+
+/**
+ * Constructor
+ * @param headless True to make no bitmaps, for running without a display
+ */
+AssetCache::AssetCache(bool headless) : mHeadless(headless)
+{
+    SetDecodeThreads(0);
+}
+
+/**
+ * Destructor
+ */
+AssetCache::~AssetCache()
+{
+}
+
+/**
+ * Set the number of threads Preload decodes images on
+ * @param threads Number of threads, 0 for one per core.
+ * 1 decodes on the calling thread, one image at a time.
+ */
+void AssetCache::SetDecodeThreads(int threads)
+{
+    if (threads <= 0)
+    {
+        threads = int(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mDecodeThreads = threads;
+    mDecodePool.reset();
+}
+
+/**
+ * Keep decoded images in a directory on disk, so later runs can
+ * map them instead of decoding them again. Set it before the
+ * cache is shared or any image is loaded.
+ * @param directory Directory for the cache files, empty for none
+ */
+void AssetCache::SetDiskCache(const std::wstring& directory)
+{
+    if (directory.empty())
+    {
+        mDiskCache.reset();
+    }
+    else
+    {
+        mDiskCache = std::make_unique<ImageDiskCache>(directory);
+    }
+}
+
+/**
+ * Get the disk cache
+ * @return The disk cache, nullptr when not used
+ */
+const ImageDiskCache* AssetCache::GetDiskCache() const
+{
+    return mDiskCache.get();
+}
+
+/**
+ * Read images and levels from a pack where it has them. Open
+ * it before the cache is shared or anything is loaded.
+ * @param filename Pack file
+ * @return False if the pack cannot be opened. Everything is
+ * then read from loose files.
+ */
+bool AssetCache::OpenPack(const std::wstring& filename)
+{
+    auto pack = std::make_unique<AssetPack>();
+    if (!pack->Open(filename))
+    {
+        mPack.reset();
+        return false;
+    }
+
+    mPack = std::move(pack);
+    return true;
+}
+
+/**
+ * Get the open pack
+ * @return The pack, nullptr when not used
+ */
+const AssetPack* AssetCache::GetPack() const
+{
+    return mPack.get();
+}
+
+/**
+ * Decode an image, from the pack if it is in it, or else from
+ * the disk cache if it has a valid copy. Takes no lock. The
+ * image may use the mapped file's memory, so the file must
+ * outlive it.
+ * @param filename Image file name
+ * @param file Mapping of the cache file, if one is used
+ * @param image Set to the decoded image
+ */
+void AssetCache::Decode(const std::wstring& filename, MappedFile& file, wxImage& image) const
+{
+    const char* data;
+    size_t size;
+    if (mPack && mPack->Find(filename, data, size))
+    {
+        wxMemoryInputStream stream(data, size);
+        image.LoadFile(stream, wxBITMAP_TYPE_ANY);
+        return;
+    }
+
+    if (mDiskCache && mDiskCache->Load(filename, file, image))
+    {
+        return;
+    }
+
+    image.LoadFile(filename, wxBITMAP_TYPE_ANY);
+    if (mDiskCache && image.IsOk())
+    {
+        mDiskCache->Store(filename, image);
+    }
+}
+
+/**
+ * Load a bitmap into the cache. The lock must be held.
+ * @param filename Image file name
+ * @return The bitmap, or nullptr when headless
+ */
+std::shared_ptr<wxBitmap> AssetCache::LoadImage(const std::wstring& filename)
+{
+    auto found = mImages.find(filename);
+    if (found != mImages.end())
+    {
+        return found->second;
+    }
+
+    std::shared_ptr<wxBitmap> bitmap;
+    if (!mHeadless)
+    {
+        MappedFile file;
+        wxImage image;
+        Decode(filename, file, image);
+        bitmap = std::make_shared<wxBitmap>(image);
+        Telemetry::Count(Telemetry::Counter::BitmapsLoaded);
+    }
+
+    mImages[filename] = bitmap;
+    return bitmap;
+}
+
+/**
+ * Get the size of an image for a headless cache, reading it
+ * if it is not known. The lock must be held.
+ * @param filename Image file name
+ * @return Width and height in pixels
+ */
+std::pair<int, int> AssetCache::ImageSize(const std::wstring& filename)
+{
+    auto found = mSizes.find(filename);
+    if (found != mSizes.end())
+    {
+        return found->second;
+    }
+
+    MappedFile file;
+    wxImage image;
+    Decode(filename, file, image);
+    auto size = std::make_pair(image.GetWidth(), image.GetHeight());
+    mSizes[filename] = size;
+    return size;
+}
+
+/**
+ * Decode images that are not cached yet, several at a time, so
+ * the items built next find them ready. The images are decoded
+ * on the cache's pool of threads, one load at a time; the bitmaps
+ * are made afterwards on the calling thread.
+ * @param filenames Image file names, repeats allowed
+ * @return Number of images decoded
+ */
+int AssetCache::Preload(const std::vector<std::wstring>& filenames)
+{
+    // The images not loaded yet, once each
+    std::vector<std::wstring> needed;
+    WorkerPool* pool;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto& filename : filenames)
+        {
+            bool loaded = mHeadless ? mSizes.count(filename) > 0 : mImages.count(filename) > 0;
+            if (!loaded && std::find(needed.begin(), needed.end(), filename) == needed.end())
+            {
+                needed.push_back(filename);
+            }
+        }
+
+        if (!mDecodePool && !needed.empty())
+        {
+            mDecodePool = std::make_unique<WorkerPool>(mDecodeThreads);
+        }
+        pool = mDecodePool.get();
+    }
+
+    if (needed.empty())
+    {
+        return 0;
+    }
+
+    // Decoding takes no lock, so games can keep using the cache.
+    // Images from the disk cache use the mappings until the
+    // bitmaps are made, so the mappings are destroyed last.
+    std::vector<MappedFile> files(needed.size());
+    std::vector<wxImage> images(needed.size());
+    pool->Run(needed.size(), [&](size_t i) {
+        Decode(needed[i], files[i], images[i]);
+    });
+
+    // Another game may have loaded some of them in the meantime
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (size_t i = 0; i < needed.size(); i++)
+    {
+        if (mHeadless)
+        {
+            mSizes.emplace(needed[i], std::make_pair(images[i].GetWidth(), images[i].GetHeight()));
+        }
+        else if (mImages.count(needed[i]) == 0)
+        {
+            mImages[needed[i]] = std::make_shared<wxBitmap>(images[i]);
+            Telemetry::Count(Telemetry::Counter::BitmapsLoaded);
+        }
+    }
+
+    return int(needed.size());
+}
+
+/**
+ * Get a cached image, loading it if necessary
+ * @param filename Image file name
+ * @return Shared pointer to the bitmap, nullptr when headless
+ */
+std::shared_ptr<wxBitmap> AssetCache::GetImage(const std::wstring& filename)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return LoadImage(filename);
+}
+
+/**
+ * Get the archetype shared by all items with the same image
+ * and collision class, creating it if necessary
+ * @param filename Image file name
+ * @param collision What the item is to the football
+ * @return Archetype owned by the cache
+ */
+const ItemArchetype* AssetCache::GetArchetype(const std::wstring& filename, CollisionClass collision)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto key = std::make_pair(filename, collision);
+    auto found = mArchetypeIndex.find(key);
+    if (found != mArchetypeIndex.end())
+    {
+        return found->second;
+    }
+
+    ItemArchetype archetype;
+    archetype.bitmap = LoadImage(filename);
+    if (archetype.bitmap)
+    {
+        archetype.width = archetype.bitmap->GetWidth();
+        archetype.height = archetype.bitmap->GetHeight();
+    }
+    else
+    {
+        // Headless, only the size is needed
+        auto size = ImageSize(filename);
+        archetype.width = size.first;
+        archetype.height = size.second;
+    }
+    archetype.collision = collision;
+    archetype.layer = CollisionLayer::Of(collision);
+    mArchetypes.push_back(archetype);
+
+    const ItemArchetype* result = &mArchetypes.back();
+    mArchetypeIndex[key] = result;
+    return result;
+}
+
+/**
+ * Get the number of distinct item archetypes
+ * @return Number of archetypes
+ */
+size_t AssetCache::GetArchetypeCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mArchetypes.size();
+}
+
+/**
+ * Get the memory the decoded images take, at 32 bits per pixel.
+ *
+ * A headless cache makes no bitmaps. It reports what they would
+ * take, from the archetype sizes, so levels can be compared in
+ * either mode.
+ *
+ * @return Bytes of decoded images
+ */
+size_t AssetCache::GetImageBytes() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::map<std::wstring, size_t> bytes;
+    for (auto& image : mImages)
+    {
+        if (image.second)
+        {
+            bytes[image.first] = size_t(image.second->GetWidth()) * image.second->GetHeight() * 4;
+        }
+    }
+    for (auto& entry : mArchetypeIndex)
+    {
+        // Does not replace an image that has a bitmap
+        bytes.emplace(entry.first.first, size_t(entry.second->width * entry.second->height) * 4);
+    }
+
+    size_t total = 0;
+    for (auto& image : bytes)
+    {
+        total += image.second;
+    }
+    return total;
+}
+
+/**
+ * Get a level, reading it if it is not cached. A level in
+ * the pack is read from it. Levels that fail to read are
+ * not cached.
+ * @param filename Level file name
+ * @return The level. Check its error.
+ */
+std::shared_ptr<const LevelData> AssetCache::GetLevel(const std::wstring& filename)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto found = mLevels.find(filename);
+    if (found != mLevels.end())
+    {
+        return found->second;
+    }
+
+    const char* data;
+    size_t size;
+    auto level = std::make_shared<LevelData>();
+    bool loaded = mPack && mPack->Find(filename, data, size) ? level->Load(data, size) : level->Load(filename);
+    if (loaded)
+    {
+        mLevels[filename] = level;
+    }
+    return level;
+}
+
+/**
+ * Replace a cached level, after its file has been edited
+ * @param filename Level file name
+ * @param level The level as read again
+ */
+void AssetCache::SetLevel(const std::wstring& filename, std::shared_ptr<const LevelData> level)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mLevels[filename] = std::move(level);
+}
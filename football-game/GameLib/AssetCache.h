@@ -0,0 +1,127 @@
+/**
+ * @file AssetCache.h
+ * @author Brennan Eagle
+ *
+ * Images, archetypes and levels shared by games
+ */
+
+#ifndef ASSETCACHE_H
+#define ASSETCACHE_H
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ItemArchetype.h"
+
+class LevelData;
+class ImageDiskCache;
+class MappedFile;
+class AssetPack;
+class WorkerPool;
+
+/**
+ * Images, archetypes and levels shared by games.
+ *
+ * Everything here is loaded once and never changed after, so
+ * any number of games, on any threads, can share one cache.
+ * Loading is done under a lock; pointers handed out stay valid
+ * for the life of the cache.
+ *
+ * A headless cache reads only the size of each image and makes
+ * no bitmaps, so it can be used without a display and from
+ * threads other than the main one.
+ *
+ * Preload decodes many images at once on a pool of threads.
+ * The threads are started the first time they are needed and
+ * wait between loads. Only the decoding is done there; bitmaps
+ * are made on the thread that called it, which must be the main
+ * one unless the cache is headless.
+ *
+ * With a disk cache set, images decoded once are kept on disk
+ * and mapped on later runs instead of decoded again.
+ *
+ * With a pack open, images and levels in it are read from the
+ * mapped pack. Anything not in the pack is read from its own
+ * file, so loose files still work.
+ */
+class AssetCache
+{
+private:
+    /// Are we running without a display?
+    bool mHeadless;
+
+    /// Protects everything below
+    mutable std::mutex mMutex;
+
+    /// Bitmaps by file name. Empty when headless.
+    std::map<std::wstring, std::shared_ptr<wxBitmap>> mImages;
+
+    /// Image sizes by file name, when headless
+    std::map<std::wstring, std::pair<int, int>> mSizes;
+
+    /// Threads Preload decodes images on
+    int mDecodeThreads;
+
+    /// Threads kept for Preload, started on first use
+    std::unique_ptr<WorkerPool> mDecodePool;
+
+    /// Decoded images kept between runs, nullptr when not used
+    std::unique_ptr<ImageDiskCache> mDiskCache;
+
+    /// Images and levels in one mapped file, nullptr when not used
+    std::unique_ptr<AssetPack> mPack;
+
+    /// Archetypes. A deque, so items can keep pointers into it.
+    std::deque<ItemArchetype> mArchetypes;
+
+    /// Finds the archetype for an image and collision class
+    std::map<std::pair<std::wstring, CollisionClass>, const ItemArchetype*> mArchetypeIndex;
+
+    /// Levels by file name
+    std::map<std::wstring, std::shared_ptr<const LevelData>> mLevels;
+
+    void Decode(const std::wstring& filename, MappedFile& file, wxImage& image) const;
+    std::shared_ptr<wxBitmap> LoadImage(const std::wstring& filename);
+    std::pair<int, int> ImageSize(const std::wstring& filename);
+
+public:
+    explicit AssetCache(bool headless = false);
+    ~AssetCache();
+
+    /// Copy constructor (disabled)
+    AssetCache(const AssetCache &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AssetCache &) = delete;
+
+    /**
+     * Are we running without a display?
+     * @return True if no bitmaps are made
+     */
+    bool IsHeadless() const { return mHeadless; }
+
+    /**
+     * Get the number of threads Preload decodes images on
+     * @return Number of threads
+     */
+    int GetDecodeThreads() const { return mDecodeThreads; }
+
+    std::shared_ptr<wxBitmap> GetImage(const std::wstring& filename);
+    int Preload(const std::vector<std::wstring>& filenames);
+    void SetDecodeThreads(int threads);
+    void SetDiskCache(const std::wstring& directory);
+    const ImageDiskCache* GetDiskCache() const;
+    bool OpenPack(const std::wstring& filename);
+    const AssetPack* GetPack() const;
+    const ItemArchetype* GetArchetype(const std::wstring& filename, CollisionClass collision);
+    size_t GetArchetypeCount() const;
+    size_t GetImageBytes() const;
+
+    std::shared_ptr<const LevelData> GetLevel(const std::wstring& filename);
+    void SetLevel(const std::wstring& filename, std::shared_ptr<const LevelData> level);
+};
+
+#endif //ASSETCACHE_H
@@ -0,0 +1,200 @@
+/**
+ * @file AssetPack.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "AssetPack.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+/// Identifies a pack file
+const char PackMagic[4] = {'S', 'P', 'T', 'K'};
+
+/// Version of the pack format
+const uint32_t PackVersion = 1;
+
+/// Each asset starts on a multiple of this many bytes
+const uint64_t AssetAlignment = 16;
+
+/// Start of a pack file
+struct PackHeader
+{
+    char magic[4];          ///< PackMagic
+    uint32_t version;       ///< PackVersion
+    uint64_t count;         ///< Number of assets
+    uint64_t index;         ///< Offset of the index from the start of the file
+};
+
+/// An asset in the index. Its name follows it.
+struct PackRecord
+{
+    uint64_t offset;        ///< Offset of the asset from the start of the file
+    uint64_t size;          ///< Size of the asset in bytes
+    uint64_t nameBytes;     ///< Length of the name in bytes, UTF-8
+};
+
+/**
+ * Put an asset name in the form the pack stores it
+ * @param name Path from the directory the game runs in
+ * @return The path with forward slashes and without . or ..
+ */
+std::wstring AssetPack::Normalize(const std::wstring& name)
+{
+    return std::filesystem::path(name).lexically_normal().generic_wstring();
+}
+
+/**
+ * Write a pack
+ * @param filename Pack file to write
+ * @param root Directory the assets are named from
+ * @param names Assets to put in the pack, named by their path from root
+ * @return True if every asset was read and the pack written
+ */
+bool AssetPack::Write(const std::wstring& filename, const std::wstring& root,
+                      const std::vector<std::wstring>& names)
+{
+    std::ofstream out(std::filesystem::path(filename), std::ios::binary);
+    if (!out)
+    {
+        return false;
+    }
+
+    PackHeader header = {};
+    std::memcpy(header.magic, PackMagic, sizeof(PackMagic));
+    header.version = PackVersion;
+    header.count = names.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<PackRecord> records;
+    std::vector<std::string> storedNames;
+    uint64_t position = sizeof(header);
+    for (auto& name : names)
+    {
+        std::ifstream in(std::filesystem::path(root) / std::filesystem::path(name), std::ios::binary);
+        if (!in)
+        {
+            return false;
+        }
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        const char padding[AssetAlignment] = {};
+        uint64_t start = (position + AssetAlignment - 1) / AssetAlignment * AssetAlignment;
+        out.write(padding, std::streamsize(start - position));
+        out.write(data.data(), std::streamsize(data.size()));
+        position = start + data.size();
+
+        PackRecord record;
+        record.offset = start;
+        record.size = data.size();
+        storedNames.push_back(std::filesystem::path(Normalize(name)).u8string());
+        record.nameBytes = storedNames.back().size();
+        records.push_back(record);
+    }
+
+    header.index = position;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        out.write(reinterpret_cast<const char*>(&records[i]), sizeof(PackRecord));
+        out.write(storedNames[i].data(), std::streamsize(storedNames[i].size()));
+    }
+
+    // The index offset is known now
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return bool(out);
+}
+
+/**
+ * Open a pack, closing any pack already open
+ * @param filename Pack file
+ * @return True if the file is a pack we can read
+ */
+bool AssetPack::Open(const std::wstring& filename)
+{
+    Close();
+    if (!mFile.Open(filename))
+    {
+        return false;
+    }
+
+    const char* data = reinterpret_cast<const char*>(mFile.GetData());
+    uint64_t size = mFile.GetSize();
+
+    PackHeader header;
+    if (size < sizeof(header))
+    {
+        Close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, PackMagic, sizeof(PackMagic)) != 0 || header.version != PackVersion ||
+        header.index > size)
+    {
+        Close();
+        return false;
+    }
+
+    uint64_t position = header.index;
+    for (uint64_t i = 0; i < header.count; i++)
+    {
+        PackRecord record;
+        if (size - position < sizeof(record))
+        {
+            Close();
+            return false;
+        }
+        std::memcpy(&record, data + position, sizeof(record));
+        position += sizeof(record);
+
+        if (size - position < record.nameBytes || record.offset > header.index ||
+            record.size > header.index - record.offset)
+        {
+            Close();
+            return false;
+        }
+
+        std::string name(data + position, size_t(record.nameBytes));
+        position += record.nameBytes;
+
+        Entry entry;
+        entry.data = data + record.offset;
+        entry.size = size_t(record.size);
+        mEntries[std::filesystem::u8path(name).generic_wstring()] = entry;
+    }
+
+    return true;
+}
+
+/**
+ * Close the pack. Pointers into it are no longer valid.
+ */
+void AssetPack::Close()
+{
+    mEntries.clear();
+    mFile.Close();
+}
+
+/**
+ * Find an asset in the pack
+ * @param name Path from the directory the game runs in
+ * @param data Set to the first byte of the asset
+ * @param size Set to the number of bytes
+ * @return False if the pack has no such asset
+ */
+bool AssetPack::Find(const std::wstring& name, const char*& data, size_t& size) const
+{
+    auto found = mEntries.find(Normalize(name));
+    if (found == mEntries.end())
+    {
+        return false;
+    }
+
+    data = found->second.data;
+    size = found->second.size;
+    return true;
+}
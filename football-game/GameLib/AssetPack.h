@@ -0,0 +1,77 @@
+/**
+ * @file AssetPack.h
+ * @author Brennan Eagle
+ *
+ * Levels and images bundled into one mapped file
+ */
+
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+/**
+ * Levels and images bundled into one mapped file.
+ *
+ * Starting the game opens and reads every image and level on its
+ * own. A pack holds all of them in one file with an index of
+ * their names, so it is opened once and mapped, and each asset is
+ * read from memory as the pages are touched.
+ *
+ * Assets are named by their path from the directory the game runs
+ * in, such as images/coin10.png, with forward slashes. The assets
+ * are stored as they are on disk; images are still decoded.
+ *
+ * The file is a header, the assets one after another, each on a
+ * 16 byte boundary, then the index. Everything is checked against
+ * the size of the file when it is opened, so a damaged pack is not
+ * opened rather than read past its end.
+ */
+class AssetPack
+{
+private:
+    /// An asset in the mapped file
+    struct Entry
+    {
+        const char* data;   ///< First byte
+        size_t size;        ///< Number of bytes
+    };
+
+    /// The mapped pack
+    MappedFile mFile;
+
+    /// Assets by name
+    std::map<std::wstring, Entry> mEntries;
+
+public:
+    static std::wstring Normalize(const std::wstring& name);
+    static bool Write(const std::wstring& filename, const std::wstring& root,
+                      const std::vector<std::wstring>& names);
+
+    bool Open(const std::wstring& filename);
+    void Close();
+    bool Find(const std::wstring& name, const char*& data, size_t& size) const;
+
+    /**
+     * Is a pack open?
+     * @return True if Open succeeded
+     */
+    bool IsOpen() const { return mFile.IsOpen(); }
+
+    /**
+     * Get the number of assets in the pack
+     * @return Number of assets
+     */
+    size_t GetCount() const { return mEntries.size(); }
+
+    /**
+     * Get the size of the pack file
+     * @return Bytes mapped
+     */
+    size_t GetSize() const { return mFile.GetSize(); }
+};
+
+#endif //ASSETPACK_H
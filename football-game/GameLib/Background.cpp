@@ -12,7 +12,17 @@
  * @param game the game
  * @param BackgroundImage the background image
  */
-Background::Background(Game *game, const std::wstring& BackgroundImage) : Item(game, BackgroundImage)
+Background::Background(Game *game, const std::wstring& BackgroundImage) : ItemOf(game, BackgroundImage)
+{
+
+}
+
+/**
+ * Constructor
+ * @param game the game
+ * @param archetype the background archetype
+ */
+Background::Background(Game *game, const ItemArchetype* archetype) : ItemOf(game, archetype)
 {
 
 }
@@ -11,7 +11,7 @@
 /**
  * Background class
  */
-class Background : public Item
+class Background : public ItemOf<Background>
 {
 private:
 
@@ -26,6 +26,7 @@ public:
     void operator=(const Background &) = delete;
 
     Background(Game* game, const std::wstring& filename);
+    Background(Game* game, const ItemArchetype* archetype);
     wxXmlNode* XmlSave(wxXmlNode* node) override;
 
     bool IsCollidable() override { return false; }
@@ -0,0 +1,115 @@
+/**
+ * @file BatchRunner.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "BatchRunner.h"
+#include "Game.h"
+#include "Telemetry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/**
+ * Constructor
+ * @param assets Assets shared by every game, usually headless
+ * @param threads Number of threads, 0 for one per core
+ */
+BatchRunner::BatchRunner(std::shared_ptr<AssetCache> assets, int threads) :
+    mAssets(std::move(assets)), mPolicy(DefaultPolicy)
+{
+    if (threads <= 0)
+    {
+        threads = int(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    mThreads = threads;
+}
+
+/**
+ * Play a batch of games.
+ * @param instances Number of games
+ * @param level Level every game plays
+ * @param ticks Ticks to run each game for, unless it reaches the goal first
+ * @param elapsed Time of one tick in seconds
+ * @return What the batch did
+ */
+BatchRunner::Result BatchRunner::Run(int instances, int level, long ticks, double elapsed)
+{
+    Result result;
+    result.instances = instances;
+    result.threads = std::min(mThreads, std::max(instances, 1));
+
+    // Warm the cache on this thread, so the games only read it
+    Game warm(mAssets);
+    warm.LoadLevel(level);
+
+    std::atomic<int> next(0);
+    std::atomic<long long> totalTicks(0);
+    std::atomic<int> completed(0);
+
+    auto worker = [&]() {
+        long long ourTicks = 0;
+        for (int instance = next++; instance < instances; instance = next++)
+        {
+            Game game(mAssets);
+            game.SetRewindEnabled(false);
+            game.SetAdvanceOnGoal(false);
+            game.LoadLevel(level);
+
+            long tick = 0;
+            for ( ; tick < ticks; tick++)
+            {
+                auto tickStart = std::chrono::steady_clock::now();
+                mPolicy(game, instance, tick);
+                game.Update(elapsed);
+                std::chrono::duration<double> tickTime = std::chrono::steady_clock::now() - tickStart;
+                Telemetry::EndFrame(tickTime.count());
+
+                if (game.IsLevelComplete())
+                {
+                    completed++;
+                    tick++;
+                    break;
+                }
+            }
+            ourTicks += tick;
+        }
+        totalTicks += ourTicks;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < result.threads; t++)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+    result.seconds = wall.count();
+    result.ticks = totalTicks;
+    result.completed = completed;
+    return result;
+}
+
+/**
+ * Default way to play: run right and jump on a rhythm
+ * that is different for each game
+ * @param game Game to set the input of
+ * @param instance Number of the game in the batch
+ * @param tick Tick about to run
+ */
+void BatchRunner::DefaultPolicy(Game& game, int instance, long tick)
+{
+    const long period = 10 + instance % 23;
+    game.ApplyInput(false, true, tick % period == 0);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file BatchRunner.h
+ * @author Brennan Eagle
+ *
+ * Runs many headless games at once across a pool of threads
+ */
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <functional>
+#include <memory>
+#include "AssetCache.h"
+
+class Game;
+
+/**
+ * Runs many headless games at once across a pool of threads.
+ *
+ * Every game is independent apart from the asset cache, which
+ * holds the images and levels and is only read once it is warm.
+ * Each thread takes the next game that has not been run, plays
+ * it for a number of fixed ticks and moves on. Each tick is a
+ * telemetry frame on the thread that runs it.
+ */
+class BatchRunner
+{
+public:
+    /// What a batch did
+    struct Result
+    {
+        /// Number of games played
+        int instances = 0;
+        /// Number of threads used
+        int threads = 0;
+        /// Ticks simulated over all games
+        long long ticks = 0;
+        /// Games that reached the goal post
+        int completed = 0;
+        /// Wall clock time in seconds
+        double seconds = 0;
+
+        /**
+         * Get the simulation rate of the whole batch
+         * @return Simulated ticks per second
+         */
+        double TicksPerSecond() const { return seconds > 0 ? ticks / seconds : 0; }
+
+        /**
+         * Get the simulation rate of each thread
+         * @return Simulated ticks per second per core
+         */
+        double TicksPerSecondPerCore() const { return threads > 0 ? TicksPerSecond() / threads : 0; }
+    };
+
+    /// Sets the input of one game before each tick
+    typedef std::function<void(Game& game, int instance, long tick)> Policy;
+
+private:
+    /// Assets shared by every game
+    std::shared_ptr<AssetCache> mAssets;
+
+    /// Number of threads to run on
+    int mThreads;
+
+    /// Input for each game
+    Policy mPolicy;
+
+public:
+    BatchRunner(std::shared_ptr<AssetCache> assets, int threads = 0);
+
+    /**
+     * Set how the games are played
+     * @param policy Sets the input of one game before each tick
+     */
+    void SetPolicy(Policy policy) { mPolicy = std::move(policy); }
+
+    /**
+     * Get the number of threads the batch runs on
+     * @return Number of threads
+     */
+    int GetThreads() const { return mThreads; }
+
+    Result Run(int instances, int level, long ticks, double elapsed = 1.0 / 60);
+
+    static void DefaultPolicy(Game& game, int instance, long tick);
+};
+
+#endif //BATCHRUNNER_H
@@ -14,31 +14,31 @@
 #include "GoalPost.h"
 #include "Football.h"
 #include "PowerUp.h"
+#include "Telemetry.h"
 
 
 
 /**
- * Handle collision with a platform (terrain)
+ * Handle collision with a platform (terrain). The game resolves
+ * terrain once all of it has been gathered for the tick.
  * @param platform The platform collided with
  */
 void CollisionVisitor::VisitPlatform(Platform* platform)
 {
+    Telemetry::Count(Telemetry::Counter::VisitPlatform);
     mLastWasTerrain = true;
     mShouldRemove = false;
-    if (auto football = mGame->GetFootball())
-    {
-        football->CollisionResolve(platform);
-    }
 }
 
+/**
+ * Handle collision with a wall (terrain)
+ * @param wall The wall collided with
+ */
 void CollisionVisitor::VisitWall(Wall* wall)
 {
+    Telemetry::Count(Telemetry::Counter::VisitWall);
     mLastWasTerrain = true;
     mShouldRemove = false;
-    if (auto football = mGame->GetFootball())
-    {
-        football->CollisionResolve(wall);
-    }
 }
 
 
@@ -48,6 +48,7 @@ void CollisionVisitor::VisitWall(Wall* wall)
  */
 void CollisionVisitor::VisitCoin10(ItemCoin10* coin)
 {
+    Telemetry::Count(Telemetry::Counter::VisitCoin10);
     mLastWasTerrain = false;
     mShouldRemove = true;
 
@@ -66,6 +67,7 @@ void CollisionVisitor::VisitCoin10(ItemCoin10* coin)
  */
 void CollisionVisitor::VisitCoin100(ItemCoin100* coin)
 {
+    Telemetry::Count(Telemetry::Counter::VisitCoin100);
     mLastWasTerrain = false;
     mShouldRemove = true;
 
@@ -84,6 +86,7 @@ void CollisionVisitor::VisitCoin100(ItemCoin100* coin)
  */
 void CollisionVisitor::VisitEnemy(Enemy* enemy)
 {
+    Telemetry::Count(Telemetry::Counter::VisitEnemy);
     mLastWasTerrain = false;
     mShouldRemove = false;
     mGame->ReloadCurrentLevel();
@@ -95,6 +98,7 @@ void CollisionVisitor::VisitEnemy(Enemy* enemy)
  */
 void CollisionVisitor::VisitGoalPost(GoalPost* goal)
 {
+    Telemetry::Count(Telemetry::Counter::VisitGoalPost);
     mLastWasTerrain = false;
     mShouldRemove = false;
 
@@ -107,6 +111,7 @@ void CollisionVisitor::VisitGoalPost(GoalPost* goal)
  */
 void CollisionVisitor::VisitPowerUp(PowerUp* powerup)
 {
+    Telemetry::Count(Telemetry::Counter::VisitPowerUp);
     mLastWasTerrain = false;
     mShouldRemove = false;
     
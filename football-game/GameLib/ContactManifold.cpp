@@ -0,0 +1,106 @@
+/**
+ * @file ContactManifold.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "ContactManifold.h"
+#include "Item.h"
+
+#include <algorithm>
+#include <cmath>
+
+/// Edges closer than this in virtual pixels are the same edge
+const double Tolerance = 0.01;
+
+/**
+ * Are two edges the same?
+ * @param a First edge
+ * @param b Second edge
+ * @return True if they are within the tolerance
+ */
+static bool Same(double a, double b)
+{
+    return std::abs(a - b) <= Tolerance;
+}
+
+/**
+ * Can two contacts be merged into one box? Only stationary
+ * terrain is merged, so the football still rides the moving
+ * platform it stands on.
+ * @param a First contact
+ * @param b Second contact
+ * @return True if they share a top and bottom and touch end
+ * to end, or share a left and right and touch top to bottom
+ */
+static bool Coplanar(const ContactManifold::Contact& a, const ContactManifold::Contact& b)
+{
+    if (!a.fixed || !b.fixed)
+    {
+        return false;
+    }
+
+    if (Same(a.top, b.top) && Same(a.bottom, b.bottom))
+    {
+        return a.left <= b.right + Tolerance && b.left <= a.right + Tolerance;
+    }
+
+    if (Same(a.left, b.left) && Same(a.right, b.right))
+    {
+        return a.top <= b.bottom + Tolerance && b.top <= a.bottom + Tolerance;
+    }
+
+    return false;
+}
+
+/**
+ * Add an item the football overlaps. It is merged with any
+ * contact it lines up with, and the merged box with any it
+ * then lines up with.
+ * @param item Terrain item
+ */
+void ContactManifold::Add(Item* item)
+{
+    Contact contact;
+    contact.left = item->GetX() - item->GetWidth() / 2;
+    contact.top = item->GetY() - item->GetHeight() / 2;
+    contact.right = item->GetX() + item->GetWidth() / 2;
+    contact.bottom = item->GetY() + item->GetHeight() / 2;
+    contact.item = item;
+    contact.fixed = !item->CanMove();
+    Add(contact);
+}
+
+/**
+ * Add a box the football overlaps, merging it as for an item
+ * @param contact Box, with the item it came from if any
+ */
+void ContactManifold::Add(Contact contact)
+{
+    int i = 0;
+    while (i < mCount)
+    {
+        auto& other = mContacts[i];
+        if (!Coplanar(other, contact))
+        {
+            i++;
+            continue;
+        }
+
+        contact.left = std::min(contact.left, other.left);
+        contact.top = std::min(contact.top, other.top);
+        contact.right = std::max(contact.right, other.right);
+        contact.bottom = std::max(contact.bottom, other.bottom);
+        contact.item = other.item;
+        mMerged++;
+
+        // Take the merged contact out and check the rest again
+        other = mContacts[--mCount];
+        i = 0;
+    }
+
+    if (mCount < MaxContacts)
+    {
+        mContacts[mCount++] = contact;
+    }
+}
@@ -0,0 +1,83 @@
+/**
+ * @file ContactManifold.h
+ * @author Brennan Eagle
+ *
+ * The terrain the football touches in one tick
+ */
+
+#ifndef CONTACTMANIFOLD_H
+#define CONTACTMANIFOLD_H
+
+#include <array>
+
+class Item;
+
+/**
+ * The terrain the football touches in one tick.
+ *
+ * Platforms are built from segments, so a football resting on a
+ * floor overlaps two segments at every seam. Resolving against
+ * each segment in turn can find the side of the second segment
+ * closer than its top and push the football sideways. Contacts
+ * are gathered here instead, and boxes that share a top and bottom
+ * and touch end to end, or share a left and right and touch top
+ * to bottom, are merged into one as they are added. The football
+ * then resolves against the merged boxes once.
+ *
+ * Contacts are kept in a fixed array so a tick allocates nothing.
+ */
+class ContactManifold
+{
+public:
+    /// A box the football touches
+    struct Contact
+    {
+        double left;    ///< Left edge in virtual pixels
+        double top;     ///< Top edge in virtual pixels
+        double right;   ///< Right edge in virtual pixels
+        double bottom;  ///< Bottom edge in virtual pixels
+        Item* item;     ///< Item the box came from, one of them if merged
+        bool fixed;     ///< Is every item in the box stationary?
+    };
+
+    /// Most contacts after merging. Further ones are ignored.
+    static const int MaxContacts = 32;
+
+private:
+    /// The contacts
+    std::array<Contact, MaxContacts> mContacts;
+
+    /// Number of contacts in use
+    int mCount = 0;
+
+    /// Number of contacts merged into another since the last clear
+    int mMerged = 0;
+
+public:
+    /// Remove every contact
+    void Clear() { mCount = 0; mMerged = 0; }
+
+    void Add(Item* item);
+    void Add(Contact contact);
+
+    /**
+     * Get the number of contacts after merging
+     * @return Number of contacts
+     */
+    int GetCount() const { return mCount; }
+
+    /**
+     * Get a contact
+     * @param i Index less than GetCount()
+     * @return Contact
+     */
+    const Contact& GetContact(int i) const { return mContacts[i]; }
+
+    /**
+     * Get the number of contacts merged into another
+     * @return Contacts merged since the last clear
+     */
+    int GetMerged() const { return mMerged; }
+};
+
+#endif //CONTACTMANIFOLD_H
@@ -6,12 +6,22 @@
 #include "pch.h"
 #include "Enemy.h"
 #include "CollisionVisitor.h"
+#include "Game.h"
 
 /**
  * Constructor
  * @param game amd file of image
  */
-Enemy::Enemy(Game* game, const std::wstring& filename) : Item(game, filename)
+Enemy::Enemy(Game* game, const std::wstring& filename) : ItemOf(game, filename, CollisionClass::Hazard)
+{
+
+}
+
+/**
+ * Constructor
+ * @param game and archetype of the enemy
+ */
+Enemy::Enemy(Game* game, const ItemArchetype* archetype) : ItemOf(game, archetype)
 {
 
 }
@@ -29,31 +39,33 @@ wxXmlNode* Enemy::XmlSave(wxXmlNode* node)
 }
 
 /**
- * move left/right or animate
- * @param elapsed
- *
+ * Compute the enemy position from the level clock.
+ * The enemy moves up from its base and back down with
+ * a constant speed, so the position is a triangle wave of time.
+ * @param time Level time in seconds
+ * @return Enemy center at that time
  */
-void Enemy::Update(double elapsed)
+wxPoint2DDouble Enemy::PositionAt(double time) const
 {
-    // Get bottom position for the first time we update
-    if (!mHasBase)
-    {
-        mBaseY = GetY();
-        mHasBase = true;
-    }
-
-    // Advance local time
-    mTime += elapsed;
-
     // Compute the progress of the wave
     const double cycle = 2.0 * mHalfPeriod;
-    double t = fmod(mTime, cycle);
+    double t = fmod(time, cycle);
     double phase = t / mHalfPeriod;
     double progress = (phase <= 1.0) ? phase : (2.0 - phase);
 
     // Move upward from base, then back down
-    double y = mBaseY - progress * mAmplitude;
-    SetLocation(GetX(), y);
+    return wxPoint2DDouble(GetX(), mBaseY - progress * mAmplitude);
+}
+
+/**
+ * Move the enemy to where it is on the level clock
+ * @param elapsed
+ *
+ */
+void Enemy::Update(double elapsed)
+{
+    auto position = PositionAt(mGame->GetLevelTime());
+    SetLocation(position.m_x, position.m_y);
 }
 
 /**
@@ -9,15 +9,11 @@
 #include "Item.h"
 
 
-class Enemy : public Item
+class Enemy : public ItemOf<Enemy>
 {
 private:
     /// Bottom Y position from which the enemy moves
     double mBaseY = 0;
-    /// Time accumulator used to compute motion phase
-    double mTime = 0;
-    /// If the bottom position has been captured from initial position
-    bool mHasBase = false;
     /// Distance to move upward from the bottom position in pixels
     double mAmplitude = 300;
     /// Time to move from bottom position to top in seconds
@@ -36,11 +32,36 @@ public:
     /// Constructor
     Enemy(Game* game, const std::wstring& filename);
 
+    /// Constructor
+    Enemy(Game* game, const ItemArchetype* archetype);
+
     /// Save enemy to XML
     wxXmlNode* XmlSave(wxXmlNode* node) override;
 
+    /**
+     * Set the bottom Y position the enemy moves up from
+     * @param y Bottom Y position in pixels
+     */
+    void SetBaseY(double y) { mBaseY = y; }
+
+    /**
+     * Move the enemy and the bottom of its motion
+     * @param dx Distance to move in X
+     * @param dy Distance to move in Y
+     */
+    void MoveBy(double dx, double dy) override { Item::MoveBy(dx, dy); mBaseY += dy; }
+
+    /// Compute the enemy position at a point on the level clock
+    wxPoint2DDouble PositionAt(double time) const;
+
     /// Update logic for enemy movement
     void Update(double elapsed) override;
+
+    /**
+     * Enemies are always moving
+     * @return true
+     */
+    bool IsDynamic() const override { return true; }
     void Accept(CollisionVisitor* visitor) override;
 };
 
@@ -0,0 +1,229 @@
+/**
+ * @file EventScheduler.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "EventScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Constructor
+ * @param resolution Seconds per tick of the wheel
+ * @param slots Number of slots in the wheel
+ * @param capacity Number of events to allocate up front
+ */
+EventScheduler::EventScheduler(double resolution, int slots, int capacity) :
+    mResolution(resolution), mSlots(slots, -1)
+{
+    mEvents.resize(capacity);
+    for (int i = capacity - 1; i >= 0; i--)
+    {
+        mEvents[i].next = mFree;
+        mFree = i;
+    }
+}
+
+/**
+ * Take an entry from the free list, growing the pool if it is empty
+ * @return Index of the entry
+ */
+int EventScheduler::Allocate()
+{
+    if (mFree < 0)
+    {
+        mEvents.emplace_back();
+        return int(mEvents.size()) - 1;
+    }
+
+    int index = mFree;
+    mFree = mEvents[index].next;
+    return index;
+}
+
+/**
+ * Put an event into the slot for the tick it is due on
+ * @param index Index of the event
+ */
+void EventScheduler::Link(int index)
+{
+    auto& slot = mSlots[mEvents[index].due % mSlots.size()];
+    mEvents[index].next = slot;
+    slot = index;
+}
+
+/**
+ * Return an entry to the free list
+ * @param index Index of the entry
+ */
+void EventScheduler::Release(int index)
+{
+    auto& event = mEvents[index];
+    event.callback = nullptr;
+    event.generation++;
+    event.next = mFree;
+    mFree = index;
+}
+
+/**
+ * Add an event to the wheel
+ * @param delay Seconds until the event first fires
+ * @param interval Seconds between firings, 0 for one-shot
+ * @param callback Function to run
+ * @return Handle to the event
+ */
+EventScheduler::Handle EventScheduler::Add(double delay, double interval, Callback callback)
+{
+    // Events always fire on a later tick than the current one
+    long long ticks = std::max(1LL, (long long)std::ceil(delay / mResolution));
+
+    int index = Allocate();
+    auto& event = mEvents[index];
+    event.callback = std::move(callback);
+    event.due = mTick + ticks;
+    event.interval = interval > 0 ? std::max(1LL, (long long)std::ceil(interval / mResolution)) : 0;
+    event.active = true;
+    Link(index);
+    mPending++;
+
+    Handle handle;
+    handle.index = index;
+    handle.generation = event.generation;
+    return handle;
+}
+
+/**
+ * Schedule an event to fire once
+ * @param delay Seconds of game time until it fires
+ * @param callback Function to run
+ * @return Handle that can be used to cancel the event
+ */
+EventScheduler::Handle EventScheduler::Schedule(double delay, Callback callback)
+{
+    return Add(delay, 0, std::move(callback));
+}
+
+/**
+ * Schedule an event to fire over and over until it is cancelled
+ * @param interval Seconds of game time between firings
+ * @param callback Function to run
+ * @return Handle that can be used to cancel the event
+ */
+EventScheduler::Handle EventScheduler::ScheduleRepeating(double interval, Callback callback)
+{
+    return Add(interval, interval, std::move(callback));
+}
+
+/**
+ * Cancel a pending event. The handle is reset so it
+ * no longer refers to any event.
+ * @param handle Handle of the event to cancel
+ * @return True if the event was still pending
+ */
+bool EventScheduler::Cancel(Handle& handle)
+{
+    bool pending = IsPending(handle);
+    if (pending)
+    {
+        // The entry stays in its slot until the wheel comes
+        // around to it, so cancelling never walks a list
+        mEvents[handle.index].active = false;
+        mPending--;
+    }
+
+    handle = Handle();
+    return pending;
+}
+
+/**
+ * Is an event still waiting to fire?
+ * @param handle Handle of the event
+ * @return True if the event is pending
+ */
+bool EventScheduler::IsPending(const Handle& handle) const
+{
+    if (handle.index < 0 || handle.index >= int(mEvents.size()))
+    {
+        return false;
+    }
+
+    auto& event = mEvents[handle.index];
+    return event.generation == handle.generation && event.active;
+}
+
+/**
+ * Advance the scheduler clock, firing any events that come due
+ * @param elapsed Seconds of game time that have passed
+ */
+void EventScheduler::Advance(double elapsed)
+{
+    mAccumulated += elapsed;
+    while (mAccumulated >= mResolution)
+    {
+        mAccumulated -= mResolution;
+        mTick++;
+
+        // Detach the slot for this tick so callbacks
+        // can schedule new events while we walk it
+        auto& slot = mSlots[mTick % mSlots.size()];
+        int index = slot;
+        slot = -1;
+
+        while (index >= 0)
+        {
+            int next = mEvents[index].next;
+
+            if (!mEvents[index].active)
+            {
+                Release(index);
+            }
+            else if (mEvents[index].due != mTick)
+            {
+                // Due on a later lap of the wheel
+                Link(index);
+            }
+            else
+            {
+                // Run the callback from a local. It may schedule
+                // new events, which can grow the pool.
+                Callback callback = std::move(mEvents[index].callback);
+                bool repeating = mEvents[index].interval > 0;
+                if (!repeating)
+                {
+                    mEvents[index].active = false;
+                    mPending--;
+                }
+
+                callback();
+
+                auto& event = mEvents[index];
+                if (repeating && event.active)
+                {
+                    event.callback = std::move(callback);
+                    event.due = mTick + event.interval;
+                    Link(index);
+                }
+                else
+                {
+                    Release(index);
+                }
+            }
+
+            index = next;
+        }
+    }
+}
+
+/**
+ * Cancel every pending event. Safe to call from inside a callback.
+ */
+void EventScheduler::Clear()
+{
+    for (auto& event : mEvents)
+    {
+        event.active = false;
+    }
+    mPending = 0;
+}
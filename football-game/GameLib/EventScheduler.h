@@ -0,0 +1,103 @@
+/**
+ * @file EventScheduler.h
+ * @author Brennan Eagle
+ *
+ * Timing wheel scheduler for timed game events
+ */
+
+#ifndef EVENTSCHEDULER_H
+#define EVENTSCHEDULER_H
+
+#include <functional>
+#include <vector>
+
+/**
+ * Schedules one-shot and repeating events on the game clock.
+ *
+ * Time only moves when Advance is called, so events fire in
+ * step with the simulation instead of the wall clock. Events
+ * live in a fixed pool and are hashed into the slots of a
+ * timing wheel by the tick they are due on, so scheduling and
+ * firing do not allocate once the pool has been sized.
+ */
+class EventScheduler
+{
+public:
+    /// Function run when an event fires
+    typedef std::function<void()> Callback;
+
+    /**
+     * Handle to a scheduled event, used to cancel it.
+     * A default handle does not refer to any event.
+     */
+    struct Handle
+    {
+        /// Index of the event in the pool
+        int index = -1;
+        /// Generation of the pool entry when it was scheduled
+        unsigned generation = 0;
+    };
+
+private:
+    /// An event in the pool
+    struct Event
+    {
+        /// Function to run
+        Callback callback;
+        /// Tick this event is due on
+        long long due = 0;
+        /// Ticks between firings, 0 for one-shot events
+        long long interval = 0;
+        /// Bumped every time the entry is reused
+        unsigned generation = 0;
+        /// Next event in the same slot or free list
+        int next = -1;
+        /// False once fired or cancelled
+        bool active = false;
+    };
+
+    /// Seconds per tick of the wheel
+    double mResolution;
+    /// Time accumulated toward the next tick
+    double mAccumulated = 0;
+    /// Current tick
+    long long mTick = 0;
+
+    /// Pool of events
+    std::vector<Event> mEvents;
+    /// First event in each slot of the wheel
+    std::vector<int> mSlots;
+    /// First free entry in the pool
+    int mFree = -1;
+    /// Number of events waiting to fire
+    int mPending = 0;
+
+    int Allocate();
+    void Link(int index);
+    void Release(int index);
+    Handle Add(double delay, double interval, Callback callback);
+
+public:
+    EventScheduler(double resolution = 0.01, int slots = 256, int capacity = 32);
+
+    /// Copy constructor (disabled)
+    EventScheduler(const EventScheduler &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const EventScheduler &) = delete;
+
+    Handle Schedule(double delay, Callback callback);
+    Handle ScheduleRepeating(double interval, Callback callback);
+    bool Cancel(Handle& handle);
+    bool IsPending(const Handle& handle) const;
+    void Advance(double elapsed);
+    void Clear();
+
+    /**
+     * Get the number of events waiting to fire
+     * @return Number of pending events
+     */
+    int GetPendingCount() const { return mPending; }
+};
+
+#endif //EVENTSCHEDULER_H
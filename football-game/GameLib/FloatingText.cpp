@@ -4,6 +4,7 @@
  */
  
 #include "FloatingText.h"
+#include "RenderState.h"
 
 /**
  * Constructor
@@ -36,20 +37,51 @@ void FloatingText::Update(double elapsed)
  */
 void FloatingText::Draw(std::shared_ptr<wxGraphicsContext> gc, double xOffset)
 {
-
-    double alpha = 1.0 - (mLifetime / mMaxLifetime);
-    if (alpha < 0) alpha = 0;
-    if (alpha > 1) alpha = 1;
-
     wxFont font(wxSize(0, 24), wxFONTFAMILY_SWISS,
                 wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
 
-    wxColour color;
-    if (mPoints >= 100)
-        color = wxColour(255, 215, 0, static_cast<int>(alpha * 255)); // Gold
-    else
-        color = wxColour(255, 255, 0, static_cast<int>(alpha * 255)); // Yellow
-
-    gc->SetFont(font, color);
+    gc->SetFont(font, GetColour());
     gc->DrawText(mText, mX - xOffset, mY);
 }
+
+/**
+ * Add this object to a render state, to be drawn as Draw would
+ * @param state Render state being captured
+ */
+void FloatingText::Capture(RenderState& state) const
+{
+    uint8_t red, green, blue, alpha;
+    GetColour(red, green, blue, alpha);
+    state.AddText(mText, mX, mY, red, green, blue, alpha);
+}
+
+/**
+ * Get the colour of the text as bytes, fading as it ages.
+ * Gold for big scores, yellow otherwise.
+ * @param red Set to the red component
+ * @param green Set to the green component
+ * @param blue Set to the blue component
+ * @param alpha Set to the opacity
+ */
+void FloatingText::GetColour(uint8_t& red, uint8_t& green, uint8_t& blue, uint8_t& alpha) const
+{
+    double fade = 1.0 - (mLifetime / mMaxLifetime);
+    if (fade < 0) fade = 0;
+    if (fade > 1) fade = 1;
+
+    red = 255;
+    green = mPoints >= 100 ? 215 : 255; // Gold or yellow
+    blue = 0;
+    alpha = static_cast<uint8_t>(fade * 255);
+}
+
+/**
+ * Get the colour of the text, fading as it ages
+ * @return Gold for big scores, yellow otherwise
+ */
+wxColour FloatingText::GetColour() const
+{
+    uint8_t red, green, blue, alpha;
+    GetColour(red, green, blue, alpha);
+    return wxColour(red, green, blue, alpha);
+}
@@ -8,7 +8,9 @@
 #ifndef FLOATINGTEXT_H
 #define FLOATINGTEXT_H
 
+#include <cstdint>
 
+class RenderState;
 
 class FloatingText {
 private:
@@ -24,11 +26,15 @@ private:
     double mMaxLifetime;
     ///points
     int mPoints;
+
+    void GetColour(uint8_t& red, uint8_t& green, uint8_t& blue, uint8_t& alpha) const;
+    wxColour GetColour() const;
 public:
     FloatingText();
     FloatingText(const wxString& text, double x, double y, int points);
     void Update(double elapsed);
     void Draw(std::shared_ptr<wxGraphicsContext> gc, double xOffset);
+    void Capture(RenderState& state) const;
     void SetVelocityY(double vy) { mVelocityY = vy; }
     /**
      * Check age of floating text
@@ -11,6 +11,9 @@
 #include <string>
 #include "Football.h"
 #include "Game.h"
+#include "GameSnapshot.h"
+#include "ContactManifold.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -19,15 +22,30 @@ const wstring FootballImageLeftName = L"images/footballLeft.png";
 const wstring FootballImageMidName = L"images/footballMid.png";
 const wstring FootballImageRightName = L"images/footballRight.png";
 
+/**
+ * Get the images the football is drawn with, so they can be
+ * loaded ahead of making one
+ * @return Image file names
+ */
+std::vector<std::wstring> Football::GetImageNames()
+{
+    return {FootballImageLeftName, FootballImageMidName, FootballImageRightName};
+}
+
 /**
  * Constructor
  * @param game the game this football lives in
  */
-Football::Football(Game* game) : Item(game, FootballImageMidName)
+Football::Football(Game* game) : ItemOf(game, FootballImageMidName)
 {
-    mItemBitmapLeft = game->GetCachedImage(FootballImageLeftName);
-    mItemBitmapMid = game->GetCachedImage(FootballImageMidName);
-    mItemBitmapRight = game->GetCachedImage(FootballImageRightName);
+    mArchetypeLeft = game->GetArchetype(FootballImageLeftName, CollisionClass::Decoration);
+    mArchetypeMid = game->GetArchetype(FootballImageMidName, CollisionClass::Decoration);
+    mArchetypeRight = game->GetArchetype(FootballImageRightName, CollisionClass::Decoration);
+
+    // The football does the collision tests. Backgrounds
+    // and anything else on the decoration layer are skipped.
+    SetCollisionMask(CollisionLayer::Terrain | CollisionLayer::Pickup |
+            CollisionLayer::Hazard | CollisionLayer::Trigger);
 }
 
 /**
@@ -80,75 +98,92 @@ bool Football::CollisionTest(Item* item)
 }
 
 /**
- * Handles collision with an object
+ * Resolve a collision with one terrain item
  * @param item The item we have collided with
  */
-/**
-void Football::OnCollide(Item& item)
-{
-    CollisionResolve(item);
-}*/
-
 void Football::CollisionResolve(Item* item)
 {
-    double itemTop = item->GetY() - item->GetHeight() / 2;
-    double itemBottom = item->GetY() + item->GetHeight() / 2;
-    double itemLeft = item->GetX() - item->GetWidth() / 2;
-    double itemRight = item->GetX() + item->GetWidth() / 2;
+    ContactManifold contacts;
+    contacts.Add(item);
+    CollisionResolve(contacts);
+}
 
+/**
+ * Move the football out of the terrain it overlaps. Each contact
+ * pushes the football out through the side of it the football
+ * overlaps least. The largest push on each axis is applied, so
+ * the football moves once however many contacts there are.
+ * @param contacts The terrain the football touches
+ */
+void Football::CollisionResolve(const ContactManifold& contacts)
+{
     double thisTop = GetY() - GetHeight() / 2;
     double thisBottom = GetY() + GetHeight() / 2;
     double thisLeft = GetX() - GetWidth() / 2;
     double thisRight = GetX() + GetWidth() / 2;
 
-    if (thisBottom <= itemTop || thisTop >= itemBottom ||
-        thisRight <= itemLeft || thisLeft >= itemRight)
-    {
-        return;
-    }
+    // Largest push in each direction
+    double pushLeft = 0;
+    double pushRight = 0;
+    double pushUp = 0;
+    double pushDown = 0;
+    Item* standingOn = nullptr;
+    bool overlapped = false;
 
-    double overlapFromTop = thisBottom - itemTop;       /// The overlap from the top of the item
-    double overlapFromBottom = itemBottom - thisTop;    /// The overlap from the bottom of the item
-    double overlapFromLeft = thisRight - itemLeft;      /// The overlap from the left of the item
-    double overlapFromRight = itemRight - thisLeft;     /// The overlap from the right of the item
-
-    double newY = GetY();
-    double newX = GetX();
-
-    mGrounded = false;
-    mStandingOn = nullptr;
+    for (int i = 0; i < contacts.GetCount(); i++)
+    {
+        auto& contact = contacts.GetContact(i);
+        if (thisBottom <= contact.top || thisTop >= contact.bottom ||
+            thisRight <= contact.left || thisLeft >= contact.right)
+        {
+            continue;
+        }
+        overlapped = true;
 
-    enum MinSide {leftS=0, rightS, topS, bottomS}; /// The direction of the minimum overlap from the view of the item
-    MinSide minSide=leftS;
-    std::vector<double> overlaps = {overlapFromLeft, overlapFromRight, overlapFromTop, overlapFromBottom};
+        double overlapFromTop = thisBottom - contact.top;       /// The overlap from the top of the item
+        double overlapFromBottom = contact.bottom - thisTop;    /// The overlap from the bottom of the item
+        double overlapFromLeft = thisRight - contact.left;      /// The overlap from the left of the item
+        double overlapFromRight = contact.right - thisLeft;     /// The overlap from the right of the item
 
-    // Find min side
-    for (int i = 0; i<4; i++)
-    {
-        if (overlaps[i]<overlaps[minSide])
+        // Ties go to the sides, then the top
+        if (overlapFromLeft <= std::min({overlapFromRight, overlapFromTop, overlapFromBottom}))
         {
-            minSide = (MinSide)i;
+            pushLeft = std::max(pushLeft, overlapFromLeft);
+        }
+        else if (overlapFromRight <= std::min(overlapFromTop, overlapFromBottom))
+        {
+            pushRight = std::max(pushRight, overlapFromRight);
+        }
+        else if (overlapFromTop <= overlapFromBottom)
+        {
+            if (overlapFromTop > pushUp)
+            {
+                pushUp = overlapFromTop;
+                standingOn = contact.item;
+            }
+        }
+        else
+        {
+            pushDown = std::max(pushDown, overlapFromBottom);
         }
     }
 
-    switch (minSide)
+    // Only touching leaves the football as it was
+    if (!overlapped)
+    {
+        return;
+    }
+
+    double newX = GetX() + (pushRight > pushLeft ? pushRight : -pushLeft);
+    double newY = GetY() + (pushDown > pushUp ? pushDown : -pushUp);
+
+    mGrounded = false;
+    mStandingOn = nullptr;
+    if (pushUp > 0 && pushUp >= pushDown)
     {
-    case leftS:
-        newX = itemLeft - GetWidth()/2;
-        break;
-    case rightS:
-        newX = itemRight + GetWidth()/2;
-        break;
-    case topS:
-        newY = itemTop - GetHeight()/2;
         mYVelocity = 0;
         mGrounded = true;
-        mStandingOn = item;
-        break;
-    case bottomS:
-        newY = itemBottom + GetHeight()/2;
-        break;
-
+        mStandingOn = standingOn;
     }
 
     SetLocation(newX,newY);
@@ -187,14 +222,44 @@ void Football::Update(double elapsed)
 
     if (mXVelocity > 0)
     {
-        this->SetBitmap(mItemBitmapRight);
+        this->SetArchetype(mArchetypeRight);
     } else if (mXVelocity < 0)
     {
-        this->SetBitmap(mItemBitmapLeft);
+        this->SetArchetype(mArchetypeLeft);
     } else
     {
-        this->SetBitmap(mItemBitmapMid);
+        this->SetArchetype(mArchetypeMid);
     }
 }
 
+/**
+ * Save the football state to a snapshot
+ * @param snapshot Snapshot to write to
+ */
+void Football::SaveState(GameSnapshot& snapshot) const
+{
+    Item::SaveState(snapshot);
+    snapshot.Write(mXVelocity);
+    snapshot.Write(mYVelocity);
+    snapshot.Write(mGrounded);
+
+    // What we stand on is saved by its place in the level roster
+    int standingOn = mStandingOn != nullptr ? mStandingOn->GetRosterIndex() : -1;
+    snapshot.Write(standingOn);
+}
 
+/**
+ * Load the football state from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void Football::LoadState(GameSnapshot& snapshot)
+{
+    Item::LoadState(snapshot);
+    snapshot.Read(mXVelocity);
+    snapshot.Read(mYVelocity);
+    snapshot.Read(mGrounded);
+
+    int standingOn = -1;
+    snapshot.Read(standingOn);
+    mStandingOn = mGame->GetRosterItem(standingOn);
+}
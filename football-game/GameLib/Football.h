@@ -11,10 +11,12 @@
 
 #include "Item.h"
 
+class ContactManifold;
+
 /**
  * The football in our game
  */
-class Football : public Item
+class Football : public ItemOf<Football>
 {
 private:
     /// X Velocity
@@ -22,7 +24,7 @@ private:
     /// Y Velocity
     double mYVelocity = 0;
     /// Y Acceleration
-    double mGravity = 1000;
+    double mGravity = Gravity;
     /// The terminal velocity
     double mTerminalVelocity = 500;
     /// Tells the football whether it is on the ground or not
@@ -30,12 +32,19 @@ private:
     /// What item we are standing on
     Item* mStandingOn = nullptr;
 
-    /// Each of the directional bitmaps
+    /// Each of the directional archetypes
     /// Left
-    std::shared_ptr<wxBitmap> mItemBitmapLeft;
-    std::shared_ptr<wxBitmap> mItemBitmapMid;
-    std::shared_ptr<wxBitmap> mItemBitmapRight;
+    const ItemArchetype* mArchetypeLeft;
+    const ItemArchetype* mArchetypeMid;
+    const ItemArchetype* mArchetypeRight;
 public:
+    /// Running speed in virtual pixels per second
+    static constexpr double RunSpeed = 300;
+    /// Upward speed at the start of a jump in virtual pixels per second
+    static constexpr double JumpSpeed = 750;
+    /// Downward acceleration in virtual pixels per second squared
+    static constexpr double Gravity = 1000;
+
     /// Default constructor (disabled)
     Football() = delete;
 
@@ -48,6 +57,8 @@ public:
     /// Constructor
     Football(Game* game);
 
+    static std::vector<std::wstring> GetImageNames();
+
     /// Set X velocity
     void SetXVelocity(double x);
     /// Set Y velocity
@@ -59,6 +70,12 @@ public:
     /// Apply the motion of the platform
     void ApplyPlatformMotion(double dx, double dy){ SetLocation(GetX()+dx, GetY()+dy); }
 
+    /**
+     * Get the X velocity
+     * @return X velocity in virtual pixels per second
+     */
+    double GetXVelocity() const { return mXVelocity; }
+
     /**
      * Returns the y velocity
      * @return Y acceleration
@@ -81,10 +98,24 @@ public:
     bool IsCollidable() override { return false; };
     /// Resolves collion with an object
     void CollisionResolve(Item* item);
+    /// Resolves collision with all the terrain touched in a tick
+    void CollisionResolve(const ContactManifold& contacts);
 
 
     /// Updates position
     void Update(double elapsed) override;
+
+    /// Save velocity and grounded state to a snapshot
+    void SaveState(GameSnapshot& snapshot) const override;
+
+    /// Load velocity and grounded state from a snapshot
+    void LoadState(GameSnapshot& snapshot) override;
+
+    /**
+     * The football is always moving
+     * @return true
+     */
+    bool IsDynamic() const override { return true; }
 };
 
 
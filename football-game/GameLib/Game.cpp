@@ -18,6 +18,17 @@
 #include "MovingPlatform.h"
 #include "Platform.h"
 #include "FloatingText.h"
+#include "LevelData.h"
+#include "GameSnapshot.h"
+#include "Telemetry.h"
+#include "RenderState.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <tuple>
+#include <typeinfo>
+#include <unordered_map>
 
 using namespace std;
 
@@ -33,12 +44,48 @@ const wstring Level2File = L"levels/level2.xml";
 /// Level 3's xml file
 const wstring Level3File = L"levels/level3.xml";
 
-const vector<wstring> Levels = {Level0File,Level1File,Level2File,Level3File};
+/// Levels a game plays unless told otherwise
+const vector<wstring> DefaultLevels = {Level0File,Level1File,Level2File,Level3File};
+
+/// Longest step in seconds an item catches up in after waking
+const double CatchUpStep = 1.0 / 60;
+
+/// Most steps an item catches up in, however long it slept
+const int MaxCatchUpSteps = 600;
+
 /**
  * Constructor
  */
-Game::Game()
+Game::Game() : Game(std::make_shared<AssetCache>())
+{
+}
+
+/**
+ * Constructor for a game that shares its images and
+ * levels with other games. Games share nothing else, so
+ * each one can be constructed and run on its own thread.
+ * @param assets Asset cache to share
+ * @param loadFirstLevel False for a game with only the football,
+ * for tools that load a level of their own with LoadLevelData
+ */
+Game::Game(std::shared_ptr<AssetCache> assets, bool loadFirstLevel) :
+    mAssets(std::move(assets)), mLevels(DefaultLevels)
 {
+    if (!loadFirstLevel)
+    {
+        mFootball = std::make_shared<Football>(this);
+        Add(mFootball);
+        return;
+    }
+
+    // The football and the first level's items are made from
+    // images decoded together, not one at a time as they are met
+    auto first = mAssets->GetLevel(mLevels[1 % mLevels.size()]);
+    if (first->GetError().empty())
+    {
+        PreloadImages(*first);
+    }
+
     mFootball = std::make_shared<Football>(this);
     Add(mFootball);
     LoadLevel(1);
@@ -53,30 +100,139 @@ Game::Game()
  */
 void Game::OnDraw(shared_ptr<wxGraphicsContext> graphics, int width, int height)
 {
+    SetViewSize(width, height);
+    auto virtualWidth = mVirtualWidth;
+
     //
-    // Automatic Scaling
+    // Items are drawn in device pixels from bitmaps already
+    // at the display scale. Items outside the view are skipped.
+    // Tiles go over the backgrounds and under everything else.
     //
-    mScale = double(height) / double(Height);
-    graphics->Scale(mScale, mScale);
+    mDrawnCount = 0;
+    IndexItems();
+    mItemIndex.Query(mXOffset, mXOffset + virtualWidth, mNearby);
+    mDrawVisitCount = int(mNearby.size());
+    if (mSoftwareRendering)
+    {
+        // Composite into a pixel buffer, shown with one bitmap draw
+        mSoftwareRenderer.SetScale(mScale);
+        mSoftwareRenderer.Begin(width, height);
+        bool tilesDrawn = false;
+        for (int i : mNearby)
+        {
+            auto& item = mItems[i];
+            if (!tilesDrawn && item->GetCollisionLayer() != CollisionLayer::Decoration)
+            {
+                mTileMap.DrawSoftware(mSoftwareRenderer, mXOffset, virtualWidth);
+                tilesDrawn = true;
+            }
+            if (item->InRange(mXOffset, mXOffset + virtualWidth))
+            {
+                item->DrawSoftware(mSoftwareRenderer, mXOffset);
+                mDrawnCount++;
+            }
+        }
+        if (!tilesDrawn)
+        {
+            mTileMap.DrawSoftware(mSoftwareRenderer, mXOffset, virtualWidth);
+        }
+        mSoftwareRenderer.Present(graphics);
+    }
+    else
+    {
+        mScaledBitmaps.SetScale(mScale);
+        bool tilesDrawn = false;
+        for (int i : mNearby)
+        {
+            auto& item = mItems[i];
+            if (!tilesDrawn && item->GetCollisionLayer() != CollisionLayer::Decoration)
+            {
+                mTileMap.DrawScaled(graphics, mScaledBitmaps, mXOffset, virtualWidth);
+                tilesDrawn = true;
+            }
+            if (item->InRange(mXOffset, mXOffset + virtualWidth))
+            {
+                item->DrawScaled(graphics, mScaledBitmaps, mXOffset);
+                mDrawnCount++;
+            }
+        }
+        if (!tilesDrawn)
+        {
+            mTileMap.DrawScaled(graphics, mScaledBitmaps, mXOffset, virtualWidth);
+        }
+    }
+    Telemetry::Count(Telemetry::Counter::ItemsDrawn, mDrawnCount);
 
-    auto virtualWidth = (double)width / mScale;
+    //
+    // Draw in virtual pixels on the graphics context
+    //
     graphics->PushState();
+    graphics->Scale(mScale, mScale);
 
+    for (auto& text : mFloatingTexts)
+    {
+        text->Draw(graphics, mXOffset);
+    }
+
+    graphics->PopState();
+}
+
+/**
+ * Set the size of the window the game is shown in
+ * @param width The width of the client window
+ * @param height The height of the client window
+ */
+void Game::SetViewSize(int width, int height)
+{
     //
-    // Draw in virtual pixels on the graphics context
+    // Automatic Scaling
     //
+    mScale = double(height) / double(Height);
+    mVirtualWidth = (double)width / mScale;
+}
 
-    for (auto item : mItems)
+/**
+ * Capture what OnDraw would draw, so it can be drawn without
+ * looking at the game, such as on another thread
+ * @param state Render state to fill
+ */
+void Game::Capture(RenderState& state)
+{
+    state.Clear();
+    state.SetView(mXOffset, Height, mSoftwareRendering);
+
+    // In the order OnDraw draws them
+    IndexItems();
+    mItemIndex.Query(mXOffset, mXOffset + mVirtualWidth, mNearby);
+    mDrawVisitCount = int(mNearby.size());
+    bool tilesCaptured = false;
+    for (int i : mNearby)
     {
-        item->Draw(graphics, mXOffset);
+        auto& item = mItems[i];
+        if (!tilesCaptured && item->GetCollisionLayer() != CollisionLayer::Decoration)
+        {
+            mTileMap.Capture(state, mXOffset, mVirtualWidth);
+            tilesCaptured = true;
+        }
+        if (item->InRange(mXOffset, mXOffset + mVirtualWidth))
+        {
+            state.AddSprite(item->GetArchetype(), item->GetX() - item->GetWidth() / 2.0,
+                            item->GetY() - item->GetHeight() / 2.0, item->GetWidth(), item->GetHeight());
+        }
+    }
+    if (!tilesCaptured)
+    {
+        mTileMap.Capture(state, mXOffset, mVirtualWidth);
     }
 
     for (auto& text : mFloatingTexts)
     {
-        text->Draw(graphics, mXOffset);
+        text->Capture(state);
     }
 
-    graphics->PopState();
+    long time = mStopWatch ? mStopWatch->Time() : 0;
+    state.SetScoreboard(time, mScoreboard ? mScoreboard->GetScore() : 0);
+    state.SetMessages(mMessage, mLevelMessage);
 }
 
 /**
@@ -85,16 +241,139 @@ void Game::OnDraw(shared_ptr<wxGraphicsContext> graphics, int width, int height)
  */
 void Game::Update(double elapsed)
 {
-    for (auto item : mItems)
+    // Timed events run even while the world is frozen
+    mScheduler.Advance(elapsed);
+    if (mScheduler.IsPending(mRespawnEvent))
     {
-        item->UpdatePrev();
+        return;
     }
 
-    for (auto item : mItems)
+    mLevelTime += elapsed;
+    mChanged.clear();
+    mTick++;
+    mUpdateVisitCount = 0;
+    mIndexVisits = mItemIndex.GetVisitCount();
+
+    // Only entities near the view are updated. The rest sleep
+    // until the view comes back within range of them.
+    const double activeLeft = mXOffset - mActivityMargin * mVirtualWidth;
+    const double activeRight = mXOffset + (1 + mActivityMargin) * mVirtualWidth;
+
+    // A new index may hold movers that are awake but were not
+    // updated last tick, such as those of a level just loaded
+    bool rebuilt = !mItemIndex.IsValid();
+    IndexItems();
+    if (rebuilt)
     {
+        mUpdateVisitCount += int(mItems.size());
+        for (auto& item : mItems)
+        {
+            if (item != mFootball && item->CanMove() && !item->IsAsleep() &&
+                item->GetAwakeTick() != mTick - 1)
+            {
+                item->Sleep(mLevelTime - elapsed);
+            }
+        }
+    }
+
+    // Items away from the view are asleep and do not move
+    mItemIndex.Query(activeLeft, activeRight, mActive);
+    mUpdateVisitCount += int(mActive.size());
+    for (int i : mActive)
+    {
+        mItems[i]->UpdatePrev();
+    }
+
+    // Items updated are stamped with the tick, so what was awake
+    // last tick can be told from what is awake now without a search
+    mActiveCount = 0;
+    mAwakeNext.clear();
+    for (int i : mActive)
+    {
+        auto& item = mItems[i];
+        if (!item->IsDynamic())
+        {
+            continue;
+        }
+
+        if (item != mFootball && !item->InRange(activeLeft, activeRight))
+        {
+            continue;
+        }
+
+        mActiveCount++;
+        item->SetAwakeTick(mTick);
+        mAwakeNext.push_back(item);
+        if (item->IsAsleep())
+        {
+            // Catch up on the time missed while asleep, in steps
+            // small enough that nothing jumps far in any one of them
+            double missed = item->Wake(mLevelTime);
+            int steps = std::min(MaxCatchUpSteps, std::max(1, int(std::ceil(missed / CatchUpStep))));
+            for (int step = 0; step < steps; step++)
+            {
+                item->Update(missed / steps);
+            }
+        }
+        else
+        {
+            item->Update(elapsed);
+        }
+        mItemIndex.Moved(i, *item);
+    }
+
+    // What was awake last tick and was not updated now goes to
+    // sleep, unless it must stay awake wherever the view is
+    mKept.clear();
+    mUpdateVisitCount += int(mAwake.size());
+    for (auto& item : mAwake)
+    {
+        if (item->IsAsleep() || item->GetAwakeTick() == mTick)
+        {
+            continue;
+        }
+
+        mChanged.push_back(item->GetRosterIndex());
+        if (!item->StaysAwake())
+        {
+            item->Sleep(mLevelTime - elapsed);
+            continue;
+        }
+
+        // Items of a level since replaced are let go
+        int position = Position(item.get());
+        if (position < 0)
+        {
+            continue;
+        }
+
+        mActiveCount++;
+        item->SetAwakeTick(mTick);
+        item->UpdatePrev();
         item->Update(elapsed);
+        mItemIndex.Moved(position, *item);
+        mKept.push_back(item);
+    }
+    mAwakeNext.insert(mAwakeNext.end(), mKept.begin(), mKept.end());
+    std::swap(mAwake, mAwakeNext);
+    mAwakeNext.clear();
+    mSleepingCount = mMoverCount - mActiveCount;
+
+    // Rewind only looks at what may have changed
+    mCaptureAll = rebuilt;
+    for (int i : mActive)
+    {
+        if (mItems[i]->CanMove())
+        {
+            mChanged.push_back(mItems[i]->GetRosterIndex());
+        }
+    }
+    Telemetry::Count(Telemetry::Counter::ItemsUpdated, mActiveCount);
+
+    if (mScoreboard)
+    {
+        mScoreboard->Update(elapsed);
     }
-    mScoreboard->Update(elapsed);
 
     if (mFootball)
     {
@@ -102,23 +381,79 @@ void Game::Update(double elapsed)
         CollisionVisitor visitor(this);
         std::vector<std::shared_ptr<Item>> itemsToRemove;  // Collect items to remove
 
-        for (auto& item : mItems)
+        // Items near the view that may remove themselves, kept
+        // before collisions remove items and invalidate the index
+        mNearView.clear();
+        for (int i : mActive)
+        {
+            if (mItems[i]->CanMove())
+            {
+                mNearView.push_back(mItems[i]);
+            }
+        }
+        mNearView.insert(mNearView.end(), mKept.begin(), mKept.end());
+
+        // Only items near the football can touch it. The margin
+        // covers the football being pushed out of what it hits.
+        double reach = mFootball->GetWidth() * 1.5;
+        mItemIndex.Query(mFootball->GetX() - reach, mFootball->GetX() + reach, mNearby);
+        mUpdateVisitCount += int(mNearby.size());
+
+        // Static terrain is collided as merged rectangles
+        if (!mTerrainMesh.IsValid())
+        {
+            mTerrainMesh.Build(mItems);
+        }
+
+        // Reaching the goal or an enemy can replace the level
+        // while its items are being collided with
+        const unsigned generation = mLevelGeneration;
+
+        mMaskRejects = 0;
+        mNarrowTests = 0;
+        mContacts.Clear();
+        for (int i : mNearby)
         {
+            auto& item = mItems[i];
             if (item.get() == mFootball.get())
             {
                 continue;
             }
 
+            // Layers the football does not test against are
+            // rejected here, before any virtual call
+            if (!mFootball->CanCollideWith(item.get()))
+            {
+                mMaskRejects++;
+                continue;
+            }
+
+            if (TerrainMesh::Covers(*item))
+            {
+                continue;
+            }
+
+            mNarrowTests++;
             if (mFootball->CollisionTest(item.get()))
             {
+                // What the football touches may change, as a power-up does
+                mChanged.push_back(item->GetRosterIndex());
+
                 // Use visitor to handle collision
                 item->Accept(&visitor);
 
-                // Check if this was a terrain collision for grounding
+                // Terrain is resolved once it has all been found
                 if (visitor.HasTerrainCollision())
                 {
                     hasTerrainCollision = true;
-                    mFootball->CollisionResolve(item.get());
+                    mContacts.Add(item.get());
+                }
+
+                // A power-up set falling is kept awake from now on
+                if (item->StaysAwake() && item->GetAwakeTick() != mTick)
+                {
+                    item->SetAwakeTick(mTick);
+                    mAwake.push_back(item);
                 }
 
                 // Check if this item should be removed
@@ -126,18 +461,57 @@ void Game::Update(double elapsed)
                 {
                     itemsToRemove.push_back(item);
                 }
+
+                // Reaching the goal loads the next level
+                if (mLevelGeneration != generation)
+                {
+                    break;
+                }
             }
         }
 
+        // Static terrain, from the cells of the tile map and the
+        // rectangles of the mesh under the football
+        if (mLevelGeneration == generation)
+        {
+            double left = mFootball->GetX() - mFootball->GetWidth() / 2;
+            double top = mFootball->GetY() - mFootball->GetHeight() / 2;
+            double right = mFootball->GetX() + mFootball->GetWidth() / 2;
+            double bottom = mFootball->GetY() + mFootball->GetHeight() / 2;
+            if (mTileMap.FindContacts(left, top, right, bottom, mContacts))
+            {
+                hasTerrainCollision = true;
+            }
+
+            int rects = mTerrainMesh.FindContacts(left, top, right, bottom, mContacts);
+            mNarrowTests += rects;
+            if (rects > 0)
+            {
+                hasTerrainCollision = true;
+            }
+        }
+
+        Telemetry::Count(Telemetry::Counter::NarrowTests, mNarrowTests);
+
+        // Reaching the goal or an enemy replaced the level and
+        // the terrain found is gone
+        if (mLevelGeneration == generation && mContacts.GetCount() > 0)
+        {
+            mFootball->CollisionResolve(mContacts);
+            Telemetry::Count(Telemetry::Counter::ContactsMerged, mContacts.GetMerged());
+        }
+
         // Now safely remove items after iteration
         for (auto& item : itemsToRemove)
         {
             Remove(item);
         }
 
-        // Remove any items that should be removed after update
+        // Remove any items that should be removed after update.
+        // Only items that can move remove themselves, and those
+        // away from the view are asleep.
         std::vector<std::shared_ptr<Item>> itemsAutoRemove;
-        for (auto& item : mItems)
+        for (auto& item : mNearView)
         {
             if (item->ShouldRemove(this))
             {
@@ -175,6 +549,11 @@ void Game::Update(double elapsed)
         const double footballY = mFootball->GetY();
         if (footballY <= 0 || footballY >= screenBottom)
         {
+            // Capture the fall, so stepping back can undo it
+            if (mRewindEnabled)
+            {
+                CaptureTick(elapsed);
+            }
             ReloadCurrentLevel();
             return;
         }
@@ -182,6 +561,11 @@ void Game::Update(double elapsed)
         const double worldCenter = 500;
         mXOffset = mFootball->GetX()-worldCenter;
     }
+
+    if (mRewindEnabled)
+    {
+        CaptureTick(elapsed);
+    }
 }
 
 /**
@@ -190,7 +574,18 @@ void Game::Update(double elapsed)
  */
 void Game::Add(std::shared_ptr<Item> item)
 {
+    // Items that say they are not collidable are taken
+    // off the collision layers when they are added
+    if (!item->IsCollidable())
+    {
+        item->SetCollisionLayer(CollisionLayer::None);
+    }
     mItems.push_back(item);
+    mItemIndex.Invalidate();
+    if (TerrainMesh::Covers(*item))
+    {
+        mTerrainMesh.Invalidate();
+    }
 }
 
 /**
@@ -200,87 +595,811 @@ void Game::Add(std::shared_ptr<Item> item)
  * @param y location
  * @param points to display
  */
-void Game::AddFloatingText(const wxString& text, double x, double y, int points)
+void Game::AddFloatingText(const wxString& text, double x, double y, int points)
+{
+    mFloatingTexts.push_back(
+        std::make_unique<FloatingText>(text, x, y, points)
+    );
+}
+
+/**
+ * Remove item from game
+ * @param item to remove
+ */
+void Game::Remove(std::shared_ptr<Item>& item)
+{
+    int position = Position(item.get());
+    if (position >= 0)
+    {
+        mRewind.LogRemoval(item->GetRosterIndex(), position);
+        if (TerrainMesh::Covers(*item))
+        {
+            mTerrainMesh.Invalidate();
+        }
+        // Only the columns it covers change, so the index is kept
+        mItemIndex.Removed(position);
+        mItems.erase(mItems.begin() + position);
+    }
+}
+
+/**
+ * Find where an item is in the item list. The index is asked
+ * first, so only the items near it are looked at.
+ * @param item Item to find
+ * @return Position in the item list, or -1 if it is not there
+ */
+int Game::Position(const Item* item)
+{
+    if (mItemIndex.IsValid())
+    {
+        int position = mItemIndex.Find(mItems, *item);
+        if (position >= 0)
+        {
+            return position;
+        }
+    }
+
+    mUpdateVisitCount += int(mItems.size());
+    auto loc = std::find_if(mItems.begin(), mItems.end(), [item](const auto& other) { return other.get() == item; });
+    return loc != mItems.end() ? int(loc - mItems.begin()) : -1;
+}
+
+/**
+ * Load the game from a .xml file.
+ * Streams the XML file and creates items as appropriate.
+ *
+ * @param filename The filename of the file to load the game from.
+ */
+void Game::Load(const wxString& filename)
+{
+    GameSnapshot saved;
+    if (saved.Load(filename.ToStdWstring()))
+    {
+        LoadSaved(saved, filename);
+        return;
+    }
+
+    LevelData level;
+    if (level.Load(filename.ToStdWstring()))
+    {
+        LoadLevelData(level, filename.ToStdWstring());
+    }
+    else
+    {
+        Clear();
+        ResetCoinMultiplier();
+    }
+}
+
+/**
+ * Continue a saved game.
+ *
+ * The save names the level file it was played on, which may be
+ * one opened with File>Open rather than a numbered level. That
+ * file is read before anything is changed, and if the saved state
+ * does not fit the level the game is put back as it was.
+ *
+ * @param saved Contents of the saved game file
+ * @param filename File the save was read from, for messages
+ */
+void Game::LoadSaved(GameSnapshot& saved, const wxString& filename)
+{
+    uint32_t nameSize = 0;
+    saved.Read(nameSize);
+    const char* name = saved.ReadBytes(nameSize);
+    uint32_t stateSize = 0;
+    saved.Read(stateSize);
+    const char* stateBytes = saved.ReadBytes(stateSize);
+    if (name == nullptr || stateBytes == nullptr)
+    {
+        wxLogError(L"Saved game is damaged: %s", filename);
+        return;
+    }
+
+    GameSnapshot state;
+    state.WriteBytes(stateBytes, stateSize);
+    int index = 0;
+    state.Read(index);
+
+    const std::wstring levelFile = wxString::FromUTF8(name, nameSize).ToStdWstring();
+    auto level = mAssets->GetLevel(levelFile);
+    if (!level->GetError().empty() || !state.IsOk())
+    {
+        wxLogError(L"Cannot load the level of saved game %s: %s", filename, level->GetError());
+        return;
+    }
+
+    // What to go back to if the state does not fit the level
+    GameSnapshot current;
+    Snapshot(current);
+    const std::wstring currentFile = mLevelFile;
+    const int currentIndex = mLevel;
+
+    mLevel = index;
+    LoadLevelData(*level, levelFile);
+    if (Restore(state))
+    {
+        return;
+    }
+
+    wxLogError(L"Saved game does not match its level: %s", filename);
+    mLevel = currentIndex;
+    auto previous = mAssets->GetLevel(currentFile);
+    if (previous->GetError().empty())
+    {
+        LoadLevelData(*previous, currentFile);
+        Restore(current);
+    }
+    else
+    {
+        Clear();
+    }
+}
+
+/**
+ * Replace the items with those of a level that has already been read
+ * @param level The level
+ * @param filename File the level was read from
+ */
+void Game::LoadLevelData(const LevelData& level, const std::wstring& filename)
+{
+    Clear();
+    // Reset power-up state when loading or restarting a level
+    ResetCoinMultiplier();
+
+    mLevelFile = filename;
+    Telemetry::Count(Telemetry::Counter::LevelLoads);
+
+    // Position football at start
+    mStartX = level.GetStartX();
+    mStartY = level.GetStartY();
+    if (mFootball)
+    {
+        mFootball->SetLocation(mStartX, mStartY);
+    }
+
+    ResetTileMap(level);
+    CompilePrototypes(level);
+    for (auto& record : level.GetItems())
+    {
+        AddLevelItem(record);
+    }
+
+    BuildRoster();
+}
+
+/**
+ * Save the game as a binary snapshot file.
+ *
+ * The file holds the name of the level file being played followed
+ * by the state of play. Load accepts the file in place of a level
+ * file and continues the game where it was saved.
+ *
+ * @param filename The filename of the file to save the game to
+ */
+void Game::Save(const wxString &filename)
+{
+    GameSnapshot state;
+    Snapshot(state);
+
+    const std::string name = wxString(mLevelFile).utf8_string();
+    GameSnapshot snapshot;
+    snapshot.Write(uint32_t(name.length()));
+    snapshot.WriteBytes(name.data(), name.length());
+    snapshot.Write(uint32_t(state.GetSize()));
+    snapshot.WriteBytes(state.GetData().data(), state.GetSize());
+    if (!snapshot.Save(filename.ToStdWstring()))
+    {
+        wxLogError(L"Unable to save game to %s", filename);
+    }
+}
+
+/**
+ * Number the items the level started with. Snapshots refer
+ * to items by their roster index, so they stay valid as items
+ * are removed from the game.
+ */
+void Game::BuildRoster()
+{
+    for (auto& item : mRoster)
+    {
+        item->SetRosterIndex(-1);
+    }
+    mRoster.clear();
+
+    for (auto& item : mItems)
+    {
+        // The football can be in the item list twice
+        if (item->GetRosterIndex() < 0)
+        {
+            item->SetRosterIndex(int(mRoster.size()));
+            mRoster.push_back(item);
+        }
+    }
+
+    mLevelStart.Clear();
+    Snapshot(mLevelStart);
+
+    mGlobals.Clear();
+    WriteGlobals(mGlobals);
+    mRewind.Reset(mRoster, mGlobals);
+}
+
+/**
+ * Build the item index again if the item list has changed since
+ * it was last built. Items that cannot move are given their
+ * previous location here, as it is not updated every tick.
+ */
+void Game::IndexItems()
+{
+    if (mItemIndex.IsValid())
+    {
+        return;
+    }
+
+    mItemIndex.Build(mItems, mFootball.get());
+    mMoverCount = 0;
+    for (auto& item : mItems)
+    {
+        if (item->CanMove())
+        {
+            mMoverCount++;
+        }
+        else
+        {
+            item->UpdatePrev();
+        }
+    }
+}
+
+/**
+ * Get an item by its roster index
+ * @param index Roster index
+ * @return Item or nullptr if the index is not in the roster
+ */
+Item* Game::GetRosterItem(int index) const
+{
+    if (index < 0 || index >= int(mRoster.size()))
+    {
+        return nullptr;
+    }
+    return mRoster[index].get();
+}
+
+/**
+ * Account for the memory the game and its current level use.
+ *
+ * Items removed during play are still counted while the roster
+ * holds them for rewinding. Images and archetypes are shared
+ * with every game on the same asset cache.
+ *
+ * @return Bytes by category and items by type
+ */
+MemoryReport Game::GetMemoryReport() const
+{
+    MemoryReport report;
+
+    // make_shared puts the counts and a vtable pointer in front of
+    // each item. The layout is up to the standard library, so this
+    // is an estimate and is reported as one.
+    const size_t controlBlock = 2 * sizeof(long) + sizeof(void*);
+
+    size_t items = 0;
+    auto addItem = [&](const Item& item) {
+        report.AddItem(MemoryReport::TypeName(typeid(item)), item.GetMemorySize());
+        items++;
+    };
+    for (auto& item : mRoster)
+    {
+        addItem(*item);
+    }
+    for (auto& item : mItems)
+    {
+        if (item->GetRosterIndex() < 0)
+        {
+            addItem(*item);
+        }
+    }
+    report.Add(L"control blocks (estimated)", items * controlBlock);
+
+    report.Add(L"item lists", (mItems.capacity() + mRoster.capacity()) * sizeof(shared_ptr<Item>) +
+        mPlacements.capacity() * sizeof(Placement) + mDeclarations.capacity() * sizeof(LevelData::Declaration));
+    for (auto& placement : mPlacements)
+    {
+        report.Add(L"item lists", placement.items.capacity() * sizeof(placement.items[0]));
+    }
+
+    size_t texts = mFloatingTexts.capacity() * sizeof(unique_ptr<FloatingText>);
+    texts += mFloatingTexts.size() * sizeof(FloatingText);
+    report.Add(L"floating texts", texts);
+
+    report.Add(L"images", mAssets->GetImageBytes());
+    report.Add(L"archetypes", mAssets->GetArchetypeCount() * sizeof(ItemArchetype));
+    report.Add(L"scaled bitmaps", mScaledBitmaps.GetMemoryUsed());
+    report.Add(L"software renderer", mSoftwareRenderer.GetMemoryUsed());
+    report.Add(L"snapshots", mLevelStart.GetData().capacity() + mGlobals.GetData().capacity());
+    report.Add(L"rewind", mRewind.GetMemoryUsed());
+    report.Add(L"item index", mItemIndex.GetMemoryUsed() + mNearby.capacity() * sizeof(int));
+    report.Add(L"tile map", mTileMap.GetMemoryUsed());
+    report.Add(L"terrain mesh", mTerrainMesh.GetMemoryUsed());
+
+    return report;
+}
+
+/**
+ * Write the state of the simulation to a snapshot.
+ *
+ * Only values are written: the level, clock, scroll, score,
+ * the dynamic state of every roster item, and which roster
+ * items are still in the game. Movers need nothing beyond
+ * the level clock.
+ *
+ * Everything of fixed size comes first, so two snapshots of
+ * the same level line up byte for byte and differ only where
+ * the state differs. The item list is written as runs of
+ * consecutive roster indices, which stays a few runs long as
+ * items are removed.
+ *
+ * @param snapshot Snapshot to append to
+ */
+void Game::Snapshot(GameSnapshot& snapshot) const
+{
+    snapshot.Write(mLevel);
+    snapshot.Write(int(mRoster.size()));
+    WriteGlobals(snapshot);
+
+    for (auto& item : mRoster)
+    {
+        item->SaveState(snapshot);
+    }
+
+    // Runs of roster indices, each as first index and length
+    std::vector<std::pair<int, int>> runs;
+    for (auto& item : mItems)
+    {
+        int index = item->GetRosterIndex();
+        if (!runs.empty() && runs.back().first + runs.back().second == index)
+        {
+            runs.back().second++;
+        }
+        else
+        {
+            runs.emplace_back(index, 1);
+        }
+    }
+
+    snapshot.Write(int(runs.size()));
+    for (auto& run : runs)
+    {
+        snapshot.Write(run.first);
+        snapshot.Write(run.second);
+    }
+}
+
+/**
+ * Put the simulation back to the state in a snapshot.
+ *
+ * The snapshot must have been taken on the level that is
+ * currently loaded. Nothing is changed if it was not.
+ *
+ * @param snapshot Snapshot to read from the beginning
+ * @return True if the snapshot was restored
+ */
+bool Game::Restore(GameSnapshot& snapshot)
+{
+    snapshot.Rewind();
+
+    int level = 0;
+    int rosterSize = 0;
+    snapshot.Read(level);
+    snapshot.Read(rosterSize);
+    if (!snapshot.IsOk() || level != mLevel || rosterSize != int(mRoster.size()))
+    {
+        return false;
+    }
+
+    ReadGlobals(snapshot);
+
+    for (auto& item : mRoster)
+    {
+        item->LoadState(snapshot);
+    }
+
+    int runs = 0;
+    snapshot.Read(runs);
+    mItems.clear();
+    for (int r = 0; r < runs && snapshot.IsOk(); r++)
+    {
+        int first = 0;
+        int length = 0;
+        snapshot.Read(first);
+        snapshot.Read(length);
+        for (int index = std::max(first, 0); index < first + length && index < rosterSize; index++)
+        {
+            mItems.push_back(mRoster[index]);
+        }
+    }
+    mItemIndex.Invalidate();
+    mLevelGeneration++;
+
+    mFloatingTexts.clear();
+    mLevelComplete = false;
+
+    // A loss that happened after the snapshot is undone
+    if (mScheduler.Cancel(mRespawnEvent))
+    {
+        mMessage.clear();
+        if (mStopWatch)
+        {
+            mStopWatch->Start();
+        }
+    }
+
+    // The history leads up to a state we are no longer in
+    if (mRewindEnabled)
+    {
+        mGlobals.Clear();
+        WriteGlobals(mGlobals);
+        mRewind.Reset(mRoster, mGlobals);
+    }
+
+    return snapshot.IsOk();
+}
+
+/**
+ * Write the values that are not part of any item
+ * @param snapshot Snapshot to append to
+ */
+void Game::WriteGlobals(GameSnapshot& snapshot) const
+{
+    snapshot.Write(mLevelTime);
+    snapshot.Write(mXOffset);
+    snapshot.Write(mYOffset);
+    snapshot.Write(mCoinMultiplier);
+
+    bool hasScoreboard = mScoreboard != nullptr;
+    snapshot.Write(hasScoreboard);
+    if (hasScoreboard)
+    {
+        mScoreboard->SaveState(snapshot);
+    }
+}
+
+/**
+ * Read the values written by WriteGlobals
+ * @param snapshot Snapshot to read from
+ */
+void Game::ReadGlobals(GameSnapshot& snapshot)
+{
+    snapshot.Read(mLevelTime);
+    snapshot.Read(mXOffset);
+    snapshot.Read(mYOffset);
+    snapshot.Read(mCoinMultiplier);
+
+    bool hasScoreboard = false;
+    snapshot.Read(hasScoreboard);
+    if (hasScoreboard)
+    {
+        if (mScoreboard)
+        {
+            mScoreboard->LoadState(snapshot);
+        }
+        else
+        {
+            // Skip the score, there is nothing to show it
+            Scoreboard unused;
+            unused.LoadState(snapshot);
+        }
+    }
+}
+
+/**
+ * Record the tick that just ran so it can be undone
+ * @param elapsed Time covered by the tick in seconds
+ */
+void Game::CaptureTick(double elapsed)
+{
+    mGlobals.Clear();
+    WriteGlobals(mGlobals);
+    if (mCaptureAll)
+    {
+        mUpdateVisitCount += int(mRoster.size());
+        mRewind.Capture(elapsed, mRoster, mGlobals);
+    }
+    else
+    {
+        // Only the items updated or touched this tick are compared
+        std::sort(mChanged.begin(), mChanged.end());
+        mChanged.erase(std::unique(mChanged.begin(), mChanged.end()), mChanged.end());
+        mUpdateVisitCount += int(mChanged.size());
+        mRewind.Capture(elapsed, mRoster, mGlobals, mChanged);
+    }
+}
+
+/**
+ * Undo the last tick of play
+ * @return True if there was a tick to undo
+ */
+bool Game::StepBack()
+{
+    if (!mRewind.StepBack(mRoster, mItems, mGlobals))
+    {
+        return false;
+    }
+    mItemIndex.Invalidate();
+
+    mGlobals.Rewind();
+    ReadGlobals(mGlobals);
+
+    // Going back to before losing cancels the respawn
+    if (mScheduler.Cancel(mRespawnEvent))
+    {
+        mMessage.clear();
+        if (mStopWatch)
+        {
+            mStopWatch->Start();
+        }
+    }
+
+    mFloatingTexts.clear();
+    return true;
+}
+
+/**
+ * Undo ticks covering up to an amount of play
+ * @param seconds Seconds of play to undo
+ * @return Seconds of play actually undone
+ */
+double Game::Rewind(double seconds)
+{
+    double undone = 0;
+    while (undone < seconds && mRewind.CanStepBack())
+    {
+        double elapsed = mRewind.GetDuration();
+        if (!StepBack())
+        {
+            break;
+        }
+        undone += elapsed - mRewind.GetDuration();
+    }
+    return undone;
+}
+
+/**
+ * Are two declarations the same, apart from their interned index?
+ * @param a First declaration
+ * @param b Second declaration
+ * @return True if items built from them would be the same
+ */
+static bool SameDeclaration(const LevelData::Declaration& a, const LevelData::Declaration& b)
 {
-    mFloatingTexts.push_back(
-        std::make_unique<FloatingText>(text, x, y, points)
-    );
+    return a.type == b.type && a.image == b.image && a.leftImage == b.leftImage &&
+        a.midImage == b.midImage && a.rightImage == b.rightImage && a.value == b.value;
 }
 
 /**
- * Remove item from game
- * @param item to remove
+ * Are two level entries the same, apart from where they are?
+ * @param a First entry
+ * @param b Second entry
+ * @return True if moving one gives the other
  */
-void Game::Remove(std::shared_ptr<Item>& item)
+static bool SameShape(const LevelData::ItemRecord& a, const LevelData::ItemRecord& b)
 {
-    auto loc = find(begin(mItems), end(mItems), item);
-    if(loc != end(mItems))
-    {
-        mItems.erase(loc);
-    }
+    return a.width == b.width && a.height == b.height &&
+        a.radius == b.radius && a.omega == b.omega &&
+        a.cx - a.x == b.cx - b.x && a.cy - a.y == b.cy - b.y;
 }
 
 /**
- * Load the game from a .xml file.
- * Opens the XML file and reads the nodes, creating items as appropriate.
+ * Apply a new version of the current level file to the running game.
  *
- * @param filename The filename of the file to load the game from.
+ * Entries are matched with the live items by declaration ID and
+ * position. Entries that did not change keep their items, entries
+ * that only moved have their items moved, and only the remaining
+ * entries are removed or created. The state of play, including
+ * the football, coins already collected and the level clock, is
+ * kept. The new layout also becomes the level's starting state.
+ *
+ * @param level The level file as read again
  */
-void Game::Load(const wxString& filename)
+void Game::HotReload(const LevelData& level)
 {
-    Clear();
-    // Reset power-up state when loading or restarting a level
-    ResetCoinMultiplier();
+    // Keep the state of play to put back afterwards
+    GameSnapshot liveGlobals;
+    WriteGlobals(liveGlobals);
+    std::vector<std::shared_ptr<Item>> liveItems = mItems;
+    std::unordered_map<const Item*, GameSnapshot> liveStates;
+    for (auto& item : mRoster)
+    {
+        item->SaveState(liveStates[item.get()]);
+    }
 
-    wxXmlDocument doc;
-    if (!doc.Load(filename))
+    // The changes are made to the level as it started
+    if (!Restore(mLevelStart))
     {
+        wxLogError(L"Unable to reload the level in place");
         return;
     }
 
-    auto root = doc.GetRoot();
-    if (root->GetName() != L"level")
+    // Items of a declaration that changed are all built again
+    std::map<std::string, const LevelData::Declaration*> oldDeclarations;
+    for (auto& decl : mDeclarations)
     {
-        return;
+        oldDeclarations[decl.id] = &decl;
     }
 
-    // Parse start position - football starting position
-    double startX, startY;
-    root->GetAttribute(L"start-x", L"0").ToDouble(&startX);
-    root->GetAttribute(L"start-y", L"0").ToDouble(&startY);
-    
-    // Position football at start
-    if (mFootball)
+    // Tiles are not kept by entry, so with a tile map all the
+    // static terrain is built again
+    bool tiled = mTileMap.IsActive();
+    std::set<std::string> changed;
+    for (auto& decl : level.GetDeclarations())
     {
-        mFootball->SetLocation(startX, startY);
+        auto found = oldDeclarations.find(decl.id);
+        bool terrain = decl.type == LevelData::Type::Platform || decl.type == LevelData::Type::Wall;
+        if (found == oldDeclarations.end() || !SameDeclaration(*found->second, decl) || (tiled && terrain))
+        {
+            changed.insert(decl.id);
+        }
     }
 
-    // Process items section
-    auto child = root->GetChildren();
-    while (child)
+    // Match the new entries with the live ones. First the ones
+    // that did not move at all, then the ones that moved.
+    const auto& declarations = level.GetDeclarations();
+    const auto& records = level.GetItems();
+    std::vector<int> source(records.size(), -1);
+    std::vector<bool> used(mPlacements.size(), false);
+
+    std::multimap<std::tuple<std::string, double, double>, int> byPosition;
+    std::multimap<std::string, int> byId;
+    for (int i = 0; i < int(mPlacements.size()); i++)
     {
-        if (child->GetName() == L"declarations")
+        auto& placement = mPlacements[i];
+        if (changed.count(placement.id) == 0)
         {
-            XmlDeclarations(child);
+            byPosition.emplace(std::make_tuple(placement.id, placement.record.x, placement.record.y), i);
+            byId.emplace(placement.id, i);
         }
-        else if (child->GetName() == L"items")
+    }
+
+    for (size_t r = 0; r < records.size(); r++)
+    {
+        auto& record = records[r];
+        auto range = byPosition.equal_range(
+                std::make_tuple(declarations[record.declaration].id, record.x, record.y));
+        for (auto it = range.first; it != range.second; ++it)
         {
-            XmlItems(child);
+            if (!used[it->second] && SameShape(mPlacements[it->second].record, record))
+            {
+                source[r] = it->second;
+                used[it->second] = true;
+                break;
+            }
         }
-        child = child->GetNext();
     }
-}
 
-/**
- * Save the game as a .xml file.
- *
- * Open an XML file and stream the game data to it.
- *
- * @param filename The filename of the file to save the game to
- */
-void Game::Save(const wxString &filename)
-{
-    // This will be filled in with XML saving logic
+    for (size_t r = 0; r < records.size(); r++)
+    {
+        if (source[r] >= 0)
+        {
+            continue;
+        }
+
+        auto& record = records[r];
+        auto range = byId.equal_range(declarations[record.declaration].id);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (!used[it->second] && SameShape(mPlacements[it->second].record, record))
+            {
+                source[r] = it->second;
+                used[it->second] = true;
+                break;
+            }
+        }
+    }
+
+    // Remove the items of entries that are gone
+    std::set<const Item*> removed;
+    for (size_t i = 0; i < mPlacements.size(); i++)
+    {
+        if (!used[i])
+        {
+            for (auto& item : mPlacements[i].items)
+            {
+                removed.insert(item.get());
+            }
+        }
+    }
+
+    auto isRemoved = [&removed](const std::shared_ptr<Item>& item) {
+        return removed.count(item.get()) > 0;
+    };
+    mItems.erase(std::remove_if(mItems.begin(), mItems.end(), isRemoved), mItems.end());
+    liveItems.erase(std::remove_if(liveItems.begin(), liveItems.end(), isRemoved), liveItems.end());
+
+    // Move the entries that moved and create the new ones
+    if (tiled)
+    {
+        mTileMap.Reset(level.GetWidth(), level.GetHeight());
+    }
+    CompilePrototypes(level);
+
+    std::vector<Placement> placements;
+    std::unordered_map<const Item*, std::pair<double, double>> moved;
+    std::vector<std::shared_ptr<Item>> added;
+    for (size_t r = 0; r < records.size(); r++)
+    {
+        auto& record = records[r];
+        if (source[r] >= 0)
+        {
+            Placement placement = std::move(mPlacements[source[r]]);
+            double dx = record.x - placement.record.x;
+            double dy = record.y - placement.record.y;
+            if (dx != 0 || dy != 0)
+            {
+                for (auto& item : placement.items)
+                {
+                    item->MoveBy(dx, dy);
+                    moved[item.get()] = std::make_pair(dx, dy);
+                }
+            }
+            placement.record = record;
+            placements.push_back(std::move(placement));
+        }
+        else
+        {
+            AddLevelItem(record);
+            placements.push_back(std::move(mPlacements.back()));
+            mPlacements.pop_back();
+            added.insert(added.end(), placements.back().items.begin(), placements.back().items.end());
+        }
+    }
+    mPlacements = std::move(placements);
+
+    mStartX = level.GetStartX();
+    mStartY = level.GetStartY();
+
+    // This is now how the level starts
+    BuildRoster();
+
+    // Put the state of play back
+    mItems = liveItems;
+    mItems.insert(mItems.end(), added.begin(), added.end());
+    mItemIndex.Invalidate();
+    mLevelGeneration++;
+    mTerrainMesh.Invalidate();
+    for (auto& item : mRoster)
+    {
+        auto live = liveStates.find(item.get());
+        if (live == liveStates.end())
+        {
+            continue;
+        }
+
+        live->second.Rewind();
+        item->LoadState(live->second);
+
+        // The saved position is from before the move. The center
+        // of a mover's motion is not saved and has already moved.
+        auto offset = moved.find(item.get());
+        if (offset != moved.end())
+        {
+            item->Item::MoveBy(offset->second.first, offset->second.second);
+        }
+    }
+
+    // What the football stood on may be gone or moved,
+    // the next update finds it again
+    if (mFootball)
+    {
+        mFootball->SetStandingOn(nullptr);
+    }
+
+    liveGlobals.Rewind();
+    ReadGlobals(liveGlobals);
+
+    mGlobals.Clear();
+    WriteGlobals(mGlobals);
+    mRewind.Reset(mRoster, mGlobals);
 }
 
 /**
@@ -299,13 +1418,21 @@ void Game::Clear()
     
     // Clear all other items
     mItems.clear();
-    
-    // Clear image cache for new level
-    mImageCache.clear();
+    mItemIndex.Invalidate();
+    mLevelGeneration++;
+    mTerrainMesh.Invalidate();
+    mPlacements.clear();
+    mTileMap.Clear();
+
+    // The image cache and archetypes are kept. The football
+    // points into them, and the next level reuses most images.
 
     // Reset coin multiplier when level cleared
     ResetCoinMultiplier();
 
+    // Movers start over from the beginning of their motion
+    mLevelTime = 0;
+
     // Re-add football
     if (mFootball)
     {
@@ -315,63 +1442,58 @@ void Game::Clear()
 
 /**
  * Load the game from a .xml file.
- * Opens the XML file and reads the nodes, creating items as appropriate.
+ * Streams the XML file and creates items as appropriate.
  *
  * @param level The level to load the game from.
  */
 void Game::LoadLevel(int level)
 {
     Clear();
-    if (Levels.empty())
+    if (mLevels.empty())
     {
-        wxMessageBox(L"No levels defined!");
+        wxLogError(L"No levels defined!");
         return;
     }
 
-    mLevel = level % Levels.size();
-    const std::wstring filename = Levels[mLevel];
+    mLevel = level % mLevels.size();
+    mLevelComplete = false;
+    const std::wstring filename = mLevels[mLevel];
     // Set the on-screen message
     SetLevelMessage(L"Level " + std::to_wstring(mLevel ));
 
-    wxTimer* timer = new wxTimer();
-    timer->Bind(wxEVT_TIMER, [this, level, timer](wxTimerEvent&) {
-        mLevelMessage.clear(); // remove the message
-        delete timer;
-    });
-    timer->StartOnce(2000); // 2000 ms = 2 seconds
-
-    wxXmlDocument doc;
-    if (!doc.Load(filename))
+    // A respawn from the level we are leaving must not fire
+    if (mScheduler.Cancel(mRespawnEvent))
     {
-        wxMessageBox(L"Cannot load level file: " + filename);
-        return;
+        mMessage.clear();
     }
 
-    Clear();
+    mScheduler.Cancel(mLevelMessageEvent);
+    mLevelMessageEvent = mScheduler.Schedule(2.0, [this]() {
+        mLevelMessage.clear(); // remove the message
+    });
 
-    auto root = doc.GetRoot();
-    if (!root || root->GetName() != L"level")
+    // Levels are read once and shared by every game using the cache
+    auto levelData = mAssets->GetLevel(filename);
+    if (!levelData->GetError().empty())
     {
-        wxMessageBox(L"Invalid level file format");
+        wxLogError(L"%s", levelData->GetError());
         return;
     }
+    const LevelData& data = *levelData;
+    Telemetry::Count(Telemetry::Counter::LevelLoads);
 
-    root->GetAttribute(L"start-x",L"0").ToDouble(&mStartX);
-    root->GetAttribute(L"start-y",L"0").ToDouble(&mStartY);
-
-    /// Load declarations first
-    for (auto node = root->GetChildren(); node; node = node->GetNext())
-    {
-        if (node->GetName() == L"declarations")
-            XmlDeclarations(node);
+    Clear();
+    mLevelFile = filename;
 
-    }
+    mStartX = data.GetStartX();
+    mStartY = data.GetStartY();
 
-    /// Load items
-    for (auto node = root->GetChildren(); node; node = node->GetNext())
+    /// Compile the declarations, then build the items from them
+    ResetTileMap(data);
+    CompilePrototypes(data);
+    for (auto& record : data.GetItems())
     {
-        if (node->GetName() == L"items")
-            XmlItems(node);
+        AddLevelItem(record);
     }
     Add(mFootball);
 
@@ -383,238 +1505,339 @@ void Game::LoadLevel(int level)
     mFootball->SetGrounded(false);
     mFootball->SetStandingOn(nullptr);
 
-    //wxLogStatus(L"Level " + std::to_wstring(level) + L" loaded!");
-    wxLogStatus(wxString::Format("Level %d loaded!", level));
+    BuildRoster();
+}
+
+
+/**
+ * Decode every image a level's declarations name, and the
+ * football's, at the same time before any items are made
+ * @param level Level about to be built
+ */
+void Game::PreloadImages(const LevelData& level)
+{
+    auto names = Football::GetImageNames();
+    for (auto& decl : level.GetDeclarations())
+    {
+        for (auto name : {&decl.image, &decl.leftImage, &decl.midImage, &decl.rightImage})
+        {
+            if (!name->empty())
+            {
+                names.push_back(L"images/" + *name);
+            }
+        }
+    }
+    mAssets->Preload(names);
 }
 
+/**
+ * Decode the images of every level now, so loading a level
+ * later makes no bitmaps. Bitmaps may only be made on the
+ * main thread, so call this there before running the game
+ * on another thread.
+ */
+void Game::PreloadLevels()
+{
+    for (auto& filename : mLevels)
+    {
+        auto level = mAssets->GetLevel(filename);
+        if (level->GetError().empty())
+        {
+            PreloadImages(*level);
+        }
+    }
+}
 
 /**
- * Handle an XML node of type Declarations.
- * @param node XML node
+ * Compile the declarations of a level into item prototypes.
+ * Images are resolved here, once per declaration, so building
+ * the items needs no file names or lookups.
+ * @param level Level to compile the declarations of
  */
-void Game::XmlDeclarations(wxXmlNode* node)
+void Game::CompilePrototypes(const LevelData& level)
 {
-    for (auto child = node->GetChildren(); child; child = child->GetNext())
+    PreloadImages(level);
+
+    mPrototypes.clear();
+    mDeclarations = level.GetDeclarations();
+
+    auto archetype = [this](const std::wstring& name, CollisionClass collision) {
+        return name.empty() ? ItemArchetype::Empty() : GetArchetype(L"images/" + name, collision);
+    };
+
+    for (auto& decl : level.GetDeclarations())
     {
-        DeclarationInfo info;
-        info.type = child->GetName().ToStdWstring();
+        ItemPrototype prototype;
+        prototype.type = decl.type;
+        prototype.value = decl.value;
 
-        /// Store all attributes
-        for (auto attr = child->GetAttributes(); attr; attr = attr->GetNext())
+        switch (decl.type)
         {
-            info.attributes[attr->GetName().ToStdWstring()] = attr->GetValue().ToStdWstring();
+        case LevelData::Type::Background:
+            prototype.image = archetype(decl.image, CollisionClass::Decoration);
+            break;
+
+        case LevelData::Type::Enemy:
+            if (decl.image.empty())
+            {
+                wxLogError(L"Enemy declaration missing image attribute for id %s", decl.id);
+                prototype.type = LevelData::Type::Unknown;
+                break;
+            }
+            prototype.image = archetype(decl.image, CollisionClass::Hazard);
+            break;
+
+        case LevelData::Type::Wall:
+            if (decl.image.empty())
+            {
+                wxLogError(L"Wall declaration missing image attribute for id %s", decl.id);
+                prototype.type = LevelData::Type::Unknown;
+                break;
+            }
+            prototype.image = archetype(decl.image, CollisionClass::Terrain);
+            break;
+
+        case LevelData::Type::Platform:
+        case LevelData::Type::MovingPlatform:
+            if (decl.leftImage.empty() || decl.midImage.empty() || decl.rightImage.empty())
+            {
+                wxLogError(L"Platform declaration missing segment images for id %s", decl.id);
+                prototype.type = LevelData::Type::Unknown;
+                break;
+            }
+            prototype.left = archetype(decl.leftImage, CollisionClass::Terrain);
+            prototype.mid = archetype(decl.midImage, CollisionClass::Terrain);
+            prototype.right = archetype(decl.rightImage, CollisionClass::Terrain);
+            break;
+
+        case LevelData::Type::Coin:
+            // Coin images are fixed by their value
+            if (decl.value == 10)
+            {
+                prototype.image = ItemCoin10::ResolveArchetype(this);
+            }
+            else if (decl.value == 100)
+            {
+                prototype.image = ItemCoin100::ResolveArchetype(this);
+            }
+            break;
+
+        default:
+            break;
         }
 
-        std::wstring id = child->GetAttribute(L"id", L"").ToStdWstring();
-        if (!id.empty())
-            mDeclarations[id] = info;
+        mPrototypes.push_back(prototype);
     }
+}
 
+/**
+ * Size the tile map for a level if tiled terrain is on,
+ * or stop using it if not
+ * @param level Level about to be built
+ */
+void Game::ResetTileMap(const LevelData& level)
+{
+    if (mTiledTerrain)
+    {
+        mTileMap.Reset(level.GetWidth(), level.GetHeight());
+    }
+    else
+    {
+        mTileMap.Clear();
+    }
 }
 
 /**
- * Handle an XML node of type items.
- * @param node XML node
+ * Add a segment of static terrain. It goes on the tile map if
+ * it fits a cell, and is made into an item if not.
+ * @tparam T Item class for the segment
+ * @param archetype Archetype of the segment
+ * @param x X location of the center of the segment
+ * @param y Y location of the center of the segment
  */
-void Game::XmlItems(wxXmlNode* itemsNode)
+template <class T>
+void Game::AddTerrain(const ItemArchetype* archetype, double x, double y)
 {
-    for (auto child = itemsNode->GetChildren(); child; child = child->GetNext())
+    if (mTileMap.Place(archetype, x, y))
     {
-        std::wstring id = child->GetAttribute(L"id", L"").ToStdWstring();
-        auto it = mDeclarations.find(id);
-        if (it == mDeclarations.end())
-            continue;
+        return;
+    }
+
+    auto item = std::make_shared<T>(this, archetype);
+    item->SetLocation(x, y);
+    Add(item);
+}
+
+/**
+ * Create the items for one entry of a level's <items> section
+ * @param record Item entry from the level
+ */
+void Game::AddLevelItem(const LevelData::ItemRecord& record)
+{
+    const auto& proto = mPrototypes[record.declaration];
+
+    // Remember which items came from this entry
+    const size_t first = mItems.size();
+
+    double x = record.x;
+    double y = record.y;
+    double width = record.width;
+    double height = record.height;
+
+    /// Handle different item types
+    switch (proto.type)
+    {
+    case LevelData::Type::Background:
+    {
+        auto item = std::make_shared<Background>(this, proto.image);
+        item->SetLocation(x, y);
+        Add(item);
+        break;
+    }
+
+    case LevelData::Type::Platform:
+    {
+        int imgPixelWidth = int(proto.mid->width);
+
+        // Without a middle image the segments are the usual size
+        int segmentWidth = imgPixelWidth > 0 ? imgPixelWidth : 32;
+        int numMid = int((width - 2 * segmentWidth) / segmentWidth);
 
-        const auto& decl = it->second;
-        std::wstring type = decl.type;
+        int adjustedWidth = (numMid+2)*segmentWidth;
 
-        double x = wxAtof(child->GetAttribute(L"x", L"0"));
-        double y = wxAtof(child->GetAttribute(L"y", L"0"));
-        double width = wxAtof(child->GetAttribute(L"width", L"0"));
-        double height = wxAtof(child->GetAttribute(L"height", L"0"));
+        // Left
+        AddTerrain<Platform>(proto.left, x - adjustedWidth / 2 + segmentWidth / 2, y);
 
-        /// Handle different item types
-        if (type == L"background")
+        // Middle segments
+        for (int i = 0; i < numMid; i++)
         {
-            std::wstring imageFile = L"images/" + decl.attributes.at(L"image");
-            auto item = std::make_shared<Background>(this, imageFile);
-            item->SetLocation(x, y);
-            Add(item);
+            AddTerrain<Platform>(proto.mid, x - adjustedWidth / 2 + segmentWidth + i * segmentWidth + segmentWidth / 2, y);
         }
-        else if (type == L"platform")
-        {
-            std::wstring leftImg  = L"images/" + decl.attributes.at(L"left-image");
-            std::wstring midImg   = L"images/" + decl.attributes.at(L"mid-image");
-            std::wstring rightImg = L"images/" + decl.attributes.at(L"right-image");
 
-            auto img = GetCachedImage(midImg);
+        // Right
+        AddTerrain<Platform>(proto.right, x + adjustedWidth / 2 - segmentWidth / 2, y);
+        break;
+    }
 
-            int imgPixelWidth = img->GetWidth();
+    case LevelData::Type::MovingPlatform:
+    {
+        double cx = record.cx;
+        double cy = record.cy;
+        double radius = record.radius;
+        double omega = record.omega;
+        int segmentWidth = 32;
 
-            int segmentWidth = imgPixelWidth;
+        if (width > 0)
+        {
             int numMid = int((width - 2 * segmentWidth) / segmentWidth);
 
-            int adjustedWidth = (numMid+2)*segmentWidth;
-
             // Left
-            auto left = std::make_shared<Platform>(this, leftImg);
-            left->SetLocation(x - adjustedWidth / 2 + segmentWidth / 2, y);
+            auto left = std::make_shared<MovingPlatform>(this, proto.left);
+            double leftOffsetX = -width / 2 + segmentWidth / 2;
+            left->SetLocation(cx + leftOffsetX, cy);
+            left->SetMotion(cx + leftOffsetX, cy, radius, omega);
             Add(left);
 
-
-
             // Middle segments
             for (int i = 0; i < numMid; i++)
             {
-                auto mid = std::make_shared<Platform>(this, midImg);
-                mid->SetLocation(x - adjustedWidth / 2 + segmentWidth + i * segmentWidth + segmentWidth / 2, y);
+                auto mid = std::make_shared<MovingPlatform>(this, proto.mid);
+                double midOffsetX = -width / 2 + segmentWidth + i * segmentWidth + segmentWidth / 2;
+                mid->SetLocation(cx + midOffsetX, cy);
+                mid->SetMotion(cx + midOffsetX, cy, radius, omega);
                 Add(mid);
             }
 
-
-
             // Right
-            auto right = std::make_shared<Platform>(this, rightImg);
-            right->SetLocation(x + adjustedWidth / 2 - segmentWidth / 2, y);
+            auto right = std::make_shared<MovingPlatform>(this, proto.right);
+            double rightOffsetX = width / 2 - segmentWidth / 2;
+            right->SetLocation(cx + rightOffsetX, cy);
+            right->SetMotion(cx + rightOffsetX, cy, radius, omega);
             Add(right);
         }
-        else if (type == L"movingplatform")
+        else
         {
-            std::wstring leftImg  = L"images/" + decl.attributes.at(L"left-image");
-            std::wstring midImg   = L"images/" + decl.attributes.at(L"mid-image");
-            std::wstring rightImg = L"images/" + decl.attributes.at(L"right-image");
-
-            double cx = wxAtof(child->GetAttribute(L"cx", std::to_wstring(x)));
-            double cy = wxAtof(child->GetAttribute(L"cy", std::to_wstring(y)));
-            double radius = wxAtof(child->GetAttribute(L"radius", L"0"));
-            double omega = wxAtof(child->GetAttribute(L"omega", L"0"));
-            int segmentWidth = 32;
-
-            if (width > 0)
-            {
-                int numMid = int((width - 2 * segmentWidth) / segmentWidth);
-
-                // Left
-                auto left = std::make_shared<MovingPlatform>(this, leftImg);
-                double leftOffsetX = -width / 2 + segmentWidth / 2;
-                left->SetLocation(cx + leftOffsetX, cy);
-                left->SetMotion(cx + leftOffsetX, cy, radius, omega);
-                Add(left);
-
-                // Middle segments
-                for (int i = 0; i < numMid; i++)
-                {
-                    auto mid = std::make_shared<MovingPlatform>(this, midImg);
-                    double midOffsetX = -width / 2 + segmentWidth + i * segmentWidth + segmentWidth / 2;
-                    mid->SetLocation(cx + midOffsetX, cy);
-                    mid->SetMotion(cx + midOffsetX, cy, radius, omega);
-                    Add(mid);
-                }
-
-                // Right
-                auto right = std::make_shared<MovingPlatform>(this, rightImg);
-                double rightOffsetX = width / 2 - segmentWidth / 2;
-                right->SetLocation(cx + rightOffsetX, cy);
-                right->SetMotion(cx + rightOffsetX, cy, radius, omega);
-                Add(right);
-            }
-            else
-            {
-                //single
-                auto movingPlatform = std::make_shared<MovingPlatform>(this, midImg);
-                movingPlatform->SetLocation(cx, cy);
-                movingPlatform->SetMotion(cx, cy, radius, omega);
-                Add(movingPlatform);
-            }
+            //single
+            auto movingPlatform = std::make_shared<MovingPlatform>(this, proto.mid);
+            movingPlatform->SetLocation(cx, cy);
+            movingPlatform->SetMotion(cx, cy, radius, omega);
+            Add(movingPlatform);
         }
-        else if (type == L"wall")
-        {
-            auto itImage = decl.attributes.find(L"image");
-            if (itImage == decl.attributes.end())
-            {
-                wxLogError(L"Wall declaration missing image attribute for id %s", id);
-                continue;
-            }
-
-            std::wstring imageFile = L"images/" + itImage->second;
-            int segmentHeight = 32;
+        break;
+    }
 
-            //multi segment
-            if (height > 0)
-            {
-                int numSegments = int(height / segmentHeight);
+    case LevelData::Type::Wall:
+    {
+        int segmentHeight = 32;
 
-                for (int i = 0; i < numSegments; i++)
-                {
-                    auto wall = std::make_shared<Wall>(this, imageFile);
-                    wall->SetLocation(x, y - height / 2 + i * segmentHeight + segmentHeight / 2);
-                    Add(wall);
-                }
-            }
-            else
-            {
-                //single
-                auto wall = std::make_shared<Wall>(this, imageFile);
-                wall->SetLocation(x, y);
-                Add(wall);
-            }
-        }
-        else if (type == L"coin")
+        //multi segment
+        if (height > 0)
         {
-            /// the "value" attribute defines which coin type to create
-            int value = wxAtoi(decl.attributes.at(L"value"));
+            int numSegments = int(height / segmentHeight);
 
-            if (value == 10)
+            for (int i = 0; i < numSegments; i++)
             {
-                auto coin = std::make_shared<ItemCoin10>(this);
-                coin->SetLocation(x, y);
-                Add(coin);
-            }
-            if (value == 100)
-            {
-                auto coin = std::make_shared<ItemCoin100>(this);
-                coin->SetLocation(x, y);
-                Add(coin);
+                AddTerrain<Wall>(proto.image, x, y - height / 2 + i * segmentHeight + segmentHeight / 2);
             }
         }
-        else if (type == L"power-up")
+        else
         {
-            auto powerUp = std::make_shared<PowerUp>(this);
-            powerUp->SetLocation(x, y);
-            //powerUp->SetLocation(512, 384); // roughly middle if your screen is 1024x768
-            Add(powerUp);
+            //single
+            AddTerrain<Wall>(proto.image, x, y);
         }
-        else if (type == L"enemy")
-        {
-            /**
-            // Manually create enemies to test
-            auto enemy1 = std::make_shared<Enemy>(this, L"images/U-M.png");
-            enemy1->SetLocation(300, 384); // left side of screen
-            Add(enemy1);
-
-            auto enemy2 = std::make_shared<Enemy>(this, L"images/ND.png");
-            enemy2->SetLocation(724, 384); // right side of screen
-            Add(enemy2);
+        break;
+    }
 
-            ***/
-            auto itImage = decl.attributes.find(L"image");
-            if (itImage == decl.attributes.end())
-            {
-                continue;
-            }
-            std::wstring imageFile = L"images/" + itImage->second;
-            auto enemy = std::make_shared<Enemy>(this, imageFile);
-            enemy->SetLocation(x,y);
-            Add(enemy);
+    case LevelData::Type::Coin:
+        /// the "value" attribute defines which coin type to create
+        if (proto.value == 10)
+        {
+            auto coin = std::make_shared<ItemCoin10>(this, proto.image);
+            coin->SetLocation(x, y);
+            Add(coin);
         }
-        else if (type == L"goalpost")
+        if (proto.value == 100)
         {
-            auto goalpost = std::make_shared<GoalPost>(this);
-            //powerUp->SetLocation(512, 384); // roughly middle if your screen is 1024x768
-            goalpost->SetLocation(x, y);
-            Add(goalpost);
+            auto coin = std::make_shared<ItemCoin100>(this, proto.image);
+            coin->SetLocation(x, y);
+            Add(coin);
         }
+        break;
+
+    case LevelData::Type::PowerUp:
+    {
+        auto powerUp = std::make_shared<PowerUp>(this);
+        powerUp->SetLocation(x, y);
+        Add(powerUp);
+        break;
+    }
+
+    case LevelData::Type::Enemy:
+    {
+        auto enemy = std::make_shared<Enemy>(this, proto.image);
+        enemy->SetLocation(x,y);
+        enemy->SetBaseY(y);
+        Add(enemy);
+        break;
+    }
+
+    case LevelData::Type::GoalPost:
+    {
+        auto goalpost = std::make_shared<GoalPost>(this);
+        goalpost->SetLocation(x, y);
+        Add(goalpost);
+        break;
+    }
+
+    default:
+        break;
     }
+
+    Placement placement;
+    placement.id = mDeclarations[record.declaration].id;
+    placement.record = record;
+    placement.items.assign(mItems.begin() + first, mItems.end());
+    mPlacements.push_back(std::move(placement));
 }
 
 /**
@@ -622,23 +1845,31 @@ void Game::XmlItems(wxXmlNode* itemsNode)
  */
 void Game::ReloadCurrentLevel()
 {
+    // Already waiting to respawn
+    if (mScheduler.IsPending(mRespawnEvent))
+    {
+        return;
+    }
+
     // Show "YOU LOSE" message
     mMessage = L"YOU LOSE!";
     mMessageTimer.Start();
 
     // Pause stopwatch
-    mStopWatch->Pause();
+    if (mStopWatch)
+    {
+        mStopWatch->Pause();
+    }
 
-    // Schedule reset after delay
-    wxTimerEvent dummy;
-    wxTimer *timer = new wxTimer();
-    timer->Bind(wxEVT_TIMER, [this, timer](wxTimerEvent&) {
+    // Schedule reset after delay. The world is frozen until it fires.
+    mRespawnEvent = mScheduler.Schedule(2.0, [this]() {
         ResetCurrentLevelState();
-        mStopWatch->Start();
+        if (mStopWatch)
+        {
+            mStopWatch->Start();
+        }
         mMessage.clear(); // Remove message
-        delete timer;
     });
-    timer->StartOnce(2000); // wait 2 seconds
 }
 
 /**
@@ -646,7 +1877,15 @@ void Game::ReloadCurrentLevel()
  */
 void Game::LoadNextLevel()
 {
-    if(mLevel < 3)
+    mLevelComplete = true;
+    if (!mAdvanceOnGoal)
+    {
+        // Stay on the finished level, for tools that
+        // only need to know the goal was reached
+        return;
+    }
+
+    if(mLevel + 1 < int(mLevels.size()))
     {
         mLevel = mLevel + 1;
     }
@@ -665,26 +1904,56 @@ void Game::LoadNextLevel()
 /**
   * Get a cached image, loading it if necessary
   * @param filename image filename
-  * @return Shared pointer to cached bitmap
+  * @return Shared pointer to cached bitmap, nullptr when headless
   */
 std::shared_ptr<wxBitmap> Game::GetCachedImage(const std::wstring& filename)
 {
-    // Check if already cached
-    auto it = mImageCache.find(filename);
-    if (it != mImageCache.end())
+    return mAssets->GetImage(filename);
+}
+
+/**
+ * Get the archetype shared by all items with the same image
+ * and collision class, creating it if necessary
+ * @param filename Image filename
+ * @param collision What the item is to the football
+ * @return Archetype owned by the asset cache
+ */
+const ItemArchetype* Game::GetArchetype(const std::wstring& filename, CollisionClass collision)
+{
+    return mAssets->GetArchetype(filename, collision);
+}
+
+/**
+ * Set the football's controls for the next update
+ * @param left Move left
+ * @param right Move right
+ * @param jump Jump if standing on something
+ */
+void Game::ApplyInput(bool left, bool right, bool jump)
+{
+    if (!mFootball)
     {
-         // Return cached image
-        return it->second;
+        return;
     }
-    
-    // If not cached, load it
-    auto image = std::make_unique<wxImage>(filename, wxBITMAP_TYPE_ANY);
-    auto bitmap = std::make_shared<wxBitmap>(*image);
-    
-    // Cache it
-    mImageCache[filename] = bitmap;
-    
-    return bitmap;
+
+    double xV = 0;
+    double yV = mFootball->GetYVelocity();
+    double const xSpeed = Football::RunSpeed;
+    double yJumpVel = -Football::JumpSpeed;
+    if (left)
+        xV = -xSpeed;
+    if (right)
+        xV = xSpeed;
+    if (mFootball->GetGrounded())
+    {
+        yV=0;
+        if (jump)
+        {
+            yV = yJumpVel;
+        }
+    }
+    mFootball->SetXVelocity(xV);
+    mFootball->SetYVelocity(yV);
 }
 
 /**
@@ -694,7 +1963,15 @@ void Game::ResetCurrentLevelState()
 {
     // Clear or reset anything related to level state
 
-    mStopWatch->Pause();
+    if (mStopWatch)
+    {
+        mStopWatch->Pause();
+    }
+
+    // Brings back collected coins and used power-ups
+    // without parsing the level again
+    Restore(mLevelStart);
+
     mFootball->SetLocation(mStartX, mStartY);
     mFootball->UpdatePrev();
     mFootball->SetXVelocity(0);
@@ -704,6 +1981,9 @@ void Game::ResetCurrentLevelState()
     mXOffset = 0;
     mYOffset = 0;
 
+    // Rewinding the level clock puts every mover back at its start
+    mLevelTime = 0;
+
     if (mScoreboard)
     {
         mScoreboard->Reset();
@@ -15,26 +15,48 @@
 #include "Football.h"
 #include "Scoreboard.h"
 #include "FloatingText.h"
+#include "EventScheduler.h"
+#include "LevelData.h"
+#include "GameSnapshot.h"
+#include "RewindBuffer.h"
+#include "AssetCache.h"
+#include "ScaledBitmapCache.h"
+#include "SoftwareRenderer.h"
+#include "MemoryReport.h"
+#include "ItemIndex.h"
+#include "ContactManifold.h"
+#include "TileMap.h"
+#include "TerrainMesh.h"
 
 class Item;
 class wxGraphicsContext;
 class wxXmlNode;
 class FloatingText;
+class RenderState;
 
 /**
- * @struct DeclarationInfo
- * @brief Holds information about a declared item from the XML file.
+ * @struct ItemPrototype
+ * @brief A level declaration compiled for building items.
  *
- * This structure stores the type of the item (e.g., "background", "platform", "coin")
- * and a map of all its attributes as key-value pairs (e.g., image file, value, dimensions).
- *
- * It is used when parsing the <declarations> section of the XML to store reusable item
- * templates, which are later used to create actual items in the game.
+ * Each declaration in a level is compiled into a prototype once,
+ * when the level is loaded, with its archetypes already resolved.
+ * Items are then built from the prototype without any string
+ * work or attribute lookups.
  */
-struct DeclarationInfo
+struct ItemPrototype
 {
-    std::wstring type;
-    std::map<std::wstring, std::wstring> attributes;
+    /// What kind of item this declares
+    LevelData::Type type = LevelData::Type::Unknown;
+    /// Single image for backgrounds, walls, enemies and coins
+    const ItemArchetype* image = nullptr;
+    /// Left segment image for platforms
+    const ItemArchetype* left = nullptr;
+    /// Middle segment image for platforms
+    const ItemArchetype* mid = nullptr;
+    /// Right segment image for platforms
+    const ItemArchetype* right = nullptr;
+    /// Coin value
+    int value = 0;
 };
 
 /**
@@ -45,10 +67,30 @@ class Game
 private:
     /// All the items in our game
     std::vector<std::shared_ptr<Item>> mItems;
+    /// Finds the items near the football or the view, invalidated when mItems changes
+    ItemIndex mItemIndex;
+    /// Scratch list of item positions found in the index
+    std::vector<int> mNearby;
+    /// Positions of the items near the view in the last tick
+    std::vector<int> mActive;
+    /// Items updated in the last tick
+    std::vector<std::shared_ptr<Item>> mAwake;
+    /// Scratch list of the items updated this tick, swapped with mAwake
+    std::vector<std::shared_ptr<Item>> mAwakeNext;
+    /// Scratch list of the items kept awake away from the view this tick
+    std::vector<std::shared_ptr<Item>> mKept;
+    /// Scratch list of the items near the view that may remove themselves
+    std::vector<std::shared_ptr<Item>> mNearView;
+    /// Ticks run, so items can be stamped with the last one they were awake in
+    unsigned mTick = 0;
+    /// Number of items that can move
+    int mMoverCount = 0;
+    /// Must the next rewind capture look at every item?
+    bool mCaptureAll = true;
     /// Floating texts for coin collection
     std::vector<std::unique_ptr<FloatingText>> mFloatingTexts;
-    /// Scoreboard
-    Scoreboard* mScoreboard;
+    /// Scoreboard, nullptr if the game is not shown
+    Scoreboard* mScoreboard = nullptr;
 
     /// Scale of the display
     double mScale = 1.0;
@@ -62,6 +104,64 @@ private:
     /// Game area height in virtual pixels
     const static int Height = 1024;
 
+    /// Level clock in seconds since the level was started
+    double mLevelTime = 0;
+
+    /// Width of the visible area in virtual pixels
+    double mVirtualWidth = Height;
+
+    /// How many screens past each side of the view entities stay awake
+    double mActivityMargin = 1;
+
+    /// Number of dynamic entities updated in the last frame
+    int mActiveCount = 0;
+
+    /// Number of entities that can move left asleep in the last frame
+    int mSleepingCount = 0;
+
+    /// Collision tests rejected by layer mask in the last frame
+    int mMaskRejects = 0;
+
+    /// Collision tests that reached the narrow phase in the last frame
+    int mNarrowTests = 0;
+
+    /// Items the last update looked at, not counting the index
+    int mUpdateVisitCount = 0;
+
+    /// Index entries looked at before the last update started
+    long mIndexVisits = 0;
+
+    /// Items the index returned to the last draw
+    int mDrawVisitCount = 0;
+
+    /// Changes each time the items are replaced by loading a level
+    /// or restoring a snapshot, so a loop over them can tell
+    unsigned mLevelGeneration = 0;
+
+    /// Terrain the football touched in the last frame
+    ContactManifold mContacts;
+
+    /// Static terrain on the tile grid, when tiled terrain is on
+    TileMap mTileMap;
+
+    /// Are levels loaded with their static terrain as tiles?
+    bool mTiledTerrain = false;
+
+    /// Static terrain items merged into rectangles for collisions
+    TerrainMesh mTerrainMesh;
+
+    /// Item bitmaps at the display scale
+    ScaledBitmapCache mScaledBitmaps;
+
+    /// Composites items into a pixel buffer instead of the graphics context
+    SoftwareRenderer mSoftwareRenderer;
+
+    /// Draw items with the software renderer?
+    bool mSoftwareRendering = false;
+
+    /// Items drawn in the last frame
+    int mDrawnCount = 0;
+
     /// The player football
     std::shared_ptr<Football> mFootball;
 
@@ -73,11 +173,14 @@ private:
     /// Starting Y for this level
     double mStartY=0;
 
-    /// Maps declaration IDs to their corresponding DeclarationInfo (parsed from XML)
-    std::map<std::wstring, DeclarationInfo> mDeclarations;
+    /// Prototypes for the current level, indexed by interned declaration ID
+    std::vector<ItemPrototype> mPrototypes;
+
+    /// Images, archetypes and levels, possibly shared with other games
+    std::shared_ptr<AssetCache> mAssets;
 
-    /// Cache of images
-    std::map<std::wstring, std::shared_ptr<wxBitmap>> mImageCache;
+    /// Level files by level number
+    std::vector<std::wstring> mLevels;
 
     /// Pending reload flag
     bool mReloadPending = false;
@@ -91,26 +194,150 @@ private:
     wxStopWatch mMessageTimer;  /// Stopwatch to time message duration
 
     std::wstring mLevelMessage;  /// Message to display for levels
+
+    /// Timed events that run on the game clock
+    EventScheduler mScheduler;
+    /// Event that clears the level message
+    EventScheduler::Handle mLevelMessageEvent;
+    /// Event that respawns the football after losing
+    EventScheduler::Handle mRespawnEvent;
+
+    /// Every item the level started with, indexed by roster index
+    std::vector<std::shared_ptr<Item>> mRoster;
+
+    /// State of the current level when it started
+    GameSnapshot mLevelStart;
+
+    /// Recent ticks that can be undone
+    RewindBuffer mRewind;
+
+    /// Items created for one entry of the level's <items> section
+    struct Placement
+    {
+        /// Declaration ID of the entry
+        std::string id;
+        /// The entry as read from the level
+        LevelData::ItemRecord record;
+        /// Items created for the entry
+        std::vector<std::shared_ptr<Item>> items;
+    };
+
+    /// How the current level's entries became items
+    std::vector<Placement> mPlacements;
+
+    /// Declarations of the current level by interned index
+    std::vector<LevelData::Declaration> mDeclarations;
+
+    /// File the current level was loaded from
+    std::wstring mLevelFile;
+
+    /// Scratch space for the global values of a tick
+    GameSnapshot mGlobals;
+
+    /// Roster indices of the items that may have changed this tick
+    std::vector<int> mChanged;
+
+    /// Are ticks captured for rewinding?
+    bool mRewindEnabled = true;
+
+    /// Does reaching the goal post load the next level?
+    bool mAdvanceOnGoal = true;
+
+    /// Has the football reached the goal post on this level?
+    bool mLevelComplete = false;
+
+    void BuildRoster();
+    void IndexItems();
+    void WriteGlobals(GameSnapshot& snapshot) const;
+    void ReadGlobals(GameSnapshot& snapshot);
+    void CaptureTick(double elapsed);
+    int Position(const Item* item);
+    void ResetTileMap(const LevelData& level);
+    void PreloadImages(const LevelData& level);
+
+    template <class T>
+    void AddTerrain(const ItemArchetype* archetype, double x, double y);
 public:
     Game();
+    explicit Game(std::shared_ptr<AssetCache> assets, bool loadFirstLevel = true);
 
     void OnDraw(std::shared_ptr<wxGraphicsContext> gc, int width, int height);
+    void SetViewSize(int width, int height);
+    void Capture(RenderState& state);
+    void PreloadLevels();
     void Update(double elapsed);
     void Add(std::shared_ptr<Item> item);
     void AddFloatingText(const wxString& text, double x, double y, int points);
     void Remove(std::shared_ptr<Item>& item);
     void Load(const wxString &filename);
+    void LoadSaved(GameSnapshot& saved, const wxString& filename);
+    void LoadLevelData(const LevelData& level, const std::wstring& filename);
     void Save(const wxString &filename);
     void Clear();
 
     /// Load the specified level by number.
     void LoadLevel(int level);
 
-    /// Parse the <declarations> section of the XML and store items information
-    void XmlDeclarations(wxXmlNode* node);
+    /// Compile the declarations of a level into item prototypes
+    void CompilePrototypes(const LevelData& level);
+
+    /// Create the items for one entry of a level's <items> section
+    void AddLevelItem(const LevelData::ItemRecord& record);
+
+    void Snapshot(GameSnapshot& snapshot) const;
+    bool Restore(GameSnapshot& snapshot);
+
+    Item* GetRosterItem(int index) const;
+    MemoryReport GetMemoryReport() const;
+
+    void HotReload(const LevelData& level);
+
+    /**
+     * Get the file the current level was loaded from
+     * @return Level file name
+     */
+    const std::wstring& GetLevelFile() const { return mLevelFile; }
+
+    bool StepBack();
+    double Rewind(double seconds);
+
+    /**
+     * Turn capturing ticks for rewinding on or off. Tools that
+     * jump between snapshots run faster without it.
+     * @param enabled True to capture ticks
+     */
+    void SetRewindEnabled(bool enabled) { mRewindEnabled = enabled; }
+
+    /**
+     * Set whether reaching the goal post loads the next level
+     * @param advance False to stay on the level and only mark it complete
+     */
+    void SetAdvanceOnGoal(bool advance) { mAdvanceOnGoal = advance; }
+
+    /**
+     * Has the football reached the goal post on this level?
+     * @return True if the level is complete
+     */
+    bool IsLevelComplete() const { return mLevelComplete; }
 
-    /// Parse the <items> section of the XML and creates items of file
-    void XmlItems(wxXmlNode* itemsNode);
+    /**
+     * Has the football just lost? The world stays
+     * frozen until the level restarts.
+     * @return True while waiting to respawn
+     */
+    bool IsLost() const { return mScheduler.IsPending(mRespawnEvent); }
+
+    /**
+     * Get the history of recent ticks
+     * @return Rewind buffer
+     */
+    const RewindBuffer& GetRewindBuffer() const { return mRewind; }
+
+    /**
+     * Get the number of items the level started with
+     * @return Roster size
+     */
+    size_t GetRosterSize() const { return mRoster.size(); }
 
     /**
      * Get the height of the level
@@ -118,6 +345,127 @@ public:
      */
     int GetHeight() const { return Height; }
 
+    /**
+     * Get the level clock. Moving items compute their
+     * position directly from this time.
+     * @return Seconds since the level was started
+     */
+    double GetLevelTime() const { return mLevelTime; }
+
+    /**
+     * Set how far outside the view entities stay awake
+     * @param screens Margin on each side of the view in screen widths
+     */
+    void SetActivityMargin(double screens) { mActivityMargin = screens; }
+
+    /**
+     * Get the number of entities updated in the last frame
+     * @return Number of active dynamic entities
+     */
+    int GetActiveCount() const { return mActiveCount; }
+
+    /**
+     * Get the number of entities asleep in the last frame
+     * @return Number of entities that can move and were not updated
+     */
+    int GetSleepingCount() const { return mSleepingCount; }
+
+    /**
+     * Get the collision tests rejected by layer mask in the last frame
+     * @return Number of items skipped before any virtual call
+     */
+    int GetMaskRejects() const { return mMaskRejects; }
+
+    /**
+     * Get the collision tests that reached the narrow phase in the last frame
+     * @return Number of bounding box tests
+     */
+    int GetNarrowTests() const { return mNarrowTests; }
+
+    /**
+     * Get the terrain the football touched in the last frame
+     * @return Contacts after merging
+     */
+    const ContactManifold& GetContacts() const { return mContacts; }
+
+    /**
+     * Get the items drawn in the last frame
+     * @return Number of items inside the view
+     */
+    int GetDrawnCount() const { return mDrawnCount; }
+
+    /**
+     * Get the work the last update did: the items it looked at to
+     * update, collide, remove or capture for rewind, and the item
+     * index entries it looked at to move and remove them
+     * @return Number of items and entries
+     */
+    int GetUpdateVisitCount() const
+    {
+        return mUpdateVisitCount + int(mItemIndex.GetVisitCount() - mIndexVisits);
+    }
+
+    /**
+     * Get the items the last draw looked at
+     * @return Number of items the item index returned
+     */
+    int GetDrawVisitCount() const { return mDrawVisitCount; }
+
+    /**
+     * Get the number of times the item index has been built
+     * @return Number of builds
+     */
+    long GetIndexBuildCount() const { return mItemIndex.GetBuildCount(); }
+
+    /**
+     * Get the item bitmaps at the display scale
+     * @return Scaled bitmap cache
+     */
+    const ScaledBitmapCache& GetScaledBitmaps() const { return mScaledBitmaps; }
+
+    /**
+     * Choose how items are drawn
+     * @param software True to composite into a pixel buffer, false to use the graphics context
+     */
+    void SetSoftwareRendering(bool software) { mSoftwareRendering = software; }
+
+    /**
+     * Are items drawn with the software renderer?
+     * @return True if items are composited into a pixel buffer
+     */
+    bool GetSoftwareRendering() const { return mSoftwareRendering; }
+
+    /**
+     * Choose how static terrain is kept. Takes effect when the
+     * next level is loaded.
+     * @param tiled True to put platforms and walls on a tile map
+     */
+    void SetTiledTerrain(bool tiled) { mTiledTerrain = tiled; }
+
+    /**
+     * Are levels loaded with their static terrain as tiles?
+     * @return True if platforms and walls go on the tile map
+     */
+    bool GetTiledTerrain() const { return mTiledTerrain; }
+
+    /**
+     * Get the tile map of the current level
+     * @return Tile map, not in use unless tiled terrain was on when the level loaded
+     */
+    const TileMap& GetTileMap() const { return mTileMap; }
+
+    /**
+     * Get the rectangles the football collides with for static terrain items
+     * @return Terrain mesh, built at the next update after the terrain changes
+     */
+    const TerrainMesh& GetTerrainMesh() const { return mTerrainMesh; }
+
+    /**
+     * Get the software renderer
+     * @return Software renderer
+     */
+    SoftwareRenderer& GetSoftwareRenderer() { return mSoftwareRenderer; }
+
     /**
      * Get the game football
      * @return Game football
@@ -131,6 +479,34 @@ public:
      */
     std::shared_ptr<wxBitmap> GetCachedImage(const std::wstring& filename);
 
+    const ItemArchetype* GetArchetype(const std::wstring& filename, CollisionClass collision);
+
+    /**
+     * Get the number of distinct item archetypes
+     * @return Number of archetypes
+     */
+    size_t GetArchetypeCount() const { return mAssets->GetArchetypeCount(); }
+
+    /**
+     * Get the images, archetypes and levels this game uses
+     * @return Asset cache
+     */
+    std::shared_ptr<AssetCache> GetAssets() const { return mAssets; }
+
+    /**
+     * Set the level files, by level number
+     * @param levels Level file names
+     */
+    void SetLevels(const std::vector<std::wstring>& levels) { mLevels = levels; }
+
+    /**
+     * Get the number of levels
+     * @return Number of level files
+     */
+    int GetLevelCount() const { return int(mLevels.size()); }
+
+    void ApplyInput(bool left, bool right, bool jump);
+
     /**
      * Set the game's scoreboard
      * @param scoreboard to set
@@ -180,6 +556,12 @@ public:
         mStopWatch = stopWatch;
     }
     std::wstring GetMessage() const { return mMessage; }
+
+    /**
+     * Get the scheduler for timed game events
+     * @return Scheduler advanced by Update
+     */
+    EventScheduler* GetScheduler() { return &mScheduler; }
     void ResetCurrentLevelState();
     void SetLevelMessage(const std::wstring& msg) { mLevelMessage = msg; }
     std::wstring GetLevelMessage() const { return mLevelMessage; }
@@ -0,0 +1,182 @@
+/**
+ * @file GameSnapshot.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "GameSnapshot.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+/// Identifies a saved game file
+const char SnapshotMagic[4] = {'S', 'P', 'T', 'D'};
+
+/// Version of the saved game format
+const uint32_t SnapshotVersion = 3;
+
+/**
+ * Save the snapshot to a file
+ * @param filename File to write
+ * @return True if the file was written
+ */
+bool GameSnapshot::Save(const std::wstring& filename) const
+{
+    std::ofstream out(std::filesystem::path(filename), std::ios::binary);
+    if (!out)
+    {
+        return false;
+    }
+
+    uint64_t size = mData.size();
+    out.write(SnapshotMagic, sizeof(SnapshotMagic));
+    out.write(reinterpret_cast<const char*>(&SnapshotVersion), sizeof(SnapshotVersion));
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(mData.data(), mData.size());
+    return bool(out);
+}
+
+/**
+ * Load the snapshot from a file
+ * @param filename File to read
+ * @return True if the file holds a snapshot we can read
+ */
+bool GameSnapshot::Load(const std::wstring& filename)
+{
+    std::ifstream in(std::filesystem::path(filename), std::ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+
+    char magic[sizeof(SnapshotMagic)];
+    uint32_t version = 0;
+    uint64_t size = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!in || std::memcmp(magic, SnapshotMagic, sizeof(magic)) != 0 || version != SnapshotVersion)
+    {
+        return false;
+    }
+
+    // A damaged size must not allocate more than the file holds
+    const auto start = in.tellg();
+    in.seekg(0, std::ios::end);
+    const auto end = in.tellg();
+    in.seekg(start);
+    if (!in || start < 0 || end < start || size > uint64_t(end - start))
+    {
+        return false;
+    }
+
+    std::vector<char> data(size);
+    in.read(data.data(), size);
+    if (!in)
+    {
+        return false;
+    }
+
+    mData = std::move(data);
+    Rewind();
+    return true;
+}
+
+/**
+ * Make this snapshot the difference between two others.
+ *
+ * Only the byte ranges where the state differs from the base
+ * are stored, so many states that share a base, such as the
+ * branches of a search, cost little more than what changed.
+ *
+ * @param base Snapshot the difference is taken from
+ * @param state Snapshot to describe
+ */
+void GameSnapshot::MakeDelta(const GameSnapshot& base, const GameSnapshot& state)
+{
+    Clear();
+
+    const auto& from = base.mData;
+    const auto& to = state.mData;
+    Write(uint32_t(to.size()));
+
+    // Short runs of equal bytes are folded into the
+    // surrounding change to keep the headers down
+    const size_t Gap = 8;
+    const size_t common = std::min(from.size(), to.size());
+
+    size_t i = 0;
+    while (i < to.size())
+    {
+        if (i < common && from[i] == to[i])
+        {
+            i++;
+            continue;
+        }
+
+        // Extend the change until Gap equal bytes in a row
+        size_t last = i;
+        for (size_t j = i + 1; j < to.size() && j - last <= Gap; j++)
+        {
+            if (j >= common || from[j] != to[j])
+            {
+                last = j;
+            }
+        }
+
+        Write(uint32_t(i));
+        Write(uint32_t(last + 1 - i));
+        WriteBytes(to.data() + i, last + 1 - i);
+        i = last + 1;
+    }
+}
+
+/**
+ * Rebuild a snapshot from its base and a difference
+ * made by MakeDelta
+ * @param base Snapshot the difference was taken from
+ * @param delta The difference
+ * @return True if the difference fit the base
+ */
+bool GameSnapshot::ApplyDelta(const GameSnapshot& base, const GameSnapshot& delta)
+{
+    Clear();
+
+    const auto& changes = delta.mData;
+    uint32_t size = 0;
+    if (changes.size() < sizeof(size))
+    {
+        return false;
+    }
+    std::memcpy(&size, changes.data(), sizeof(size));
+
+    mData.assign(base.mData.begin(), base.mData.begin() + std::min<size_t>(size, base.mData.size()));
+    mData.resize(size);
+
+    size_t pos = sizeof(size);
+    while (pos < changes.size())
+    {
+        uint32_t header[2];
+        if (pos + sizeof(header) > changes.size())
+        {
+            Clear();
+            return false;
+        }
+        std::memcpy(header, changes.data() + pos, sizeof(header));
+        pos += sizeof(header);
+
+        const size_t start = header[0];
+        const size_t length = header[1];
+        if (pos + length > changes.size() || start + length > mData.size())
+        {
+            Clear();
+            return false;
+        }
+        std::memcpy(mData.data() + start, changes.data() + pos, length);
+        pos += length;
+    }
+
+    return true;
+}
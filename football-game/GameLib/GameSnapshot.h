@@ -0,0 +1,129 @@
+/**
+ * @file GameSnapshot.h
+ * @author Brennan Eagle
+ *
+ * Compact binary copy of the simulation state
+ */
+
+#ifndef GAMESNAPSHOT_H
+#define GAMESNAPSHOT_H
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Compact binary copy of the simulation state.
+ *
+ * The game and its items write their state into the snapshot
+ * one value at a time and read it back in the same order. Only
+ * plain values are stored, so taking and restoring a snapshot
+ * is little more than a memcpy of the dynamic state.
+ */
+class GameSnapshot
+{
+private:
+    /// The snapshot bytes
+    std::vector<char> mData;
+    /// Position of the next read
+    size_t mReadPos = 0;
+    /// False once a read has run past the end
+    bool mOk = true;
+
+public:
+    /**
+     * Append a value to the snapshot
+     * @param value Value to write
+     */
+    template<class T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Snapshots only hold plain values");
+        auto bytes = reinterpret_cast<const char*>(&value);
+        mData.insert(mData.end(), bytes, bytes + sizeof(T));
+    }
+
+    /**
+     * Read the next value from the snapshot. Reading past the
+     * end leaves the value alone and marks the snapshot bad.
+     * @param value Value to read into
+     */
+    template<class T>
+    void Read(T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Snapshots only hold plain values");
+        if (!mOk || mReadPos + sizeof(T) > mData.size())
+        {
+            mOk = false;
+            return;
+        }
+
+        std::memcpy(&value, mData.data() + mReadPos, sizeof(T));
+        mReadPos += sizeof(T);
+    }
+
+    /**
+     * Append raw bytes to the snapshot
+     * @param data Bytes to write
+     * @param size Number of bytes
+     */
+    void WriteBytes(const char* data, size_t size)
+    {
+        mData.insert(mData.end(), data, data + size);
+    }
+
+    /**
+     * Read raw bytes from the snapshot without copying them
+     * @param size Number of bytes
+     * @return Pointer to the bytes, or nullptr past the end
+     */
+    const char* ReadBytes(size_t size)
+    {
+        if (!mOk || mReadPos + size > mData.size())
+        {
+            mOk = false;
+            return nullptr;
+        }
+
+        const char* bytes = mData.data() + mReadPos;
+        mReadPos += size;
+        return bytes;
+    }
+
+    /**
+     * Clear the snapshot, keeping its memory for the next one
+     */
+    void Clear() { mData.clear(); Rewind(); }
+
+    /**
+     * Start reading from the beginning again
+     */
+    void Rewind() { mReadPos = 0; mOk = true; }
+
+    /**
+     * Have all reads so far been inside the snapshot?
+     * @return True if the snapshot was big enough
+     */
+    bool IsOk() const { return mOk; }
+
+    /**
+     * Get the snapshot bytes
+     * @return Bytes of the snapshot
+     */
+    const std::vector<char>& GetData() const { return mData; }
+
+    /**
+     * Get the size of the snapshot
+     * @return Number of bytes
+     */
+    size_t GetSize() const { return mData.size(); }
+
+    bool Save(const std::wstring& filename) const;
+    bool Load(const std::wstring& filename);
+
+    void MakeDelta(const GameSnapshot& base, const GameSnapshot& state);
+    bool ApplyDelta(const GameSnapshot& base, const GameSnapshot& delta);
+};
+
+#endif //GAMESNAPSHOT_H
@@ -8,17 +8,56 @@
 #include "ids.h"
 #include <wx/dcbuffer.h>
 #include <wx/graphics.h>
+#include <chrono>
+#include "Telemetry.h"
+#include "AssetCache.h"
 
 using namespace std;
 
+/// File the telemetry counters are written to
+const wchar_t* TelemetryFile = L"telemetry.json";
+
+/// Directory decoded images are kept in between runs
+const wchar_t* ImageCacheDirectory = L"imagecache";
+
+/// Pack of the levels and images, made by the assetpack tool
+const wchar_t* AssetPackFile = L"assets.pack";
+
+/**
+ * Make the assets the game is loaded from. Images decoded
+ * once are kept on disk, so later runs start without
+ * decoding them again. If there is a pack, assets are read
+ * from it; otherwise, as in development, from loose files.
+ * @return New asset cache
+ */
+static std::shared_ptr<AssetCache> MakeAssets()
+{
+    auto assets = std::make_shared<AssetCache>();
+    assets->SetDiskCache(ImageCacheDirectory);
+    if (wxFileExists(AssetPackFile) && !assets->OpenPack(AssetPackFile))
+    {
+        wxLogWarning(L"Unable to read %s, using loose files", AssetPackFile);
+    }
+    return assets;
+}
+
+/**
+ * Constructor
+ */
+GameView::GameView() : mGame(MakeAssets())
+{
+}
+
 /**
  * Destructor
  */
 GameView::~GameView()
 {
     //fixes X and File>Exit not working
+    mSimulation.Stop();
     mTimer.Stop(); //running timer keeps loop active
     mStopWatch.Pause();
+    mFrameStopWatch.Pause();
 }
 
 /**
@@ -37,12 +76,20 @@ void GameView::Initialize(wxFrame* parent)
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::LoadLevelTwo, this, IDM_LEVELTWO);
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::LoadLevelThree, this, IDM_LEVELTHREE);
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnRestartLevel, this, IDM_RESTARTLEVEL);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnSoftwareRenderer, this, IDM_SOFTWARERENDERER);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnMemoryReport, this, IDM_MEMORYREPORT);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnWriteTelemetry, this, IDM_WRITETELEMETRY);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLowLatency, this, IDM_LOWLATENCY);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnLatencyReport, this, IDM_LATENCYREPORT);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnTiledTerrain, this, IDM_TILEDTERRAIN);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &GameView::OnSimulationThread, this, IDM_SIMULATIONTHREAD);
 
     Bind(wxEVT_LEFT_DOWN, &GameView::OnLeftDown, this);
     Bind(wxEVT_LEFT_UP, &GameView::OnLeftUp, this);
     Bind(wxEVT_MOTION, &GameView::OnMouseMove, this);
     Bind(wxEVT_KEY_DOWN, &GameView::OnKeyDown, this);
     Bind(wxEVT_KEY_UP, &GameView::OnKeyUp, this);
+    Bind(wxEVT_FSWATCHER, &GameView::OnLevelFileChanged, this);
 
     mScoreboard.Initialize(&mStopWatch);
     mGame.SetScoreboard(&mScoreboard);
@@ -52,6 +99,12 @@ void GameView::Initialize(wxFrame* parent)
     mTimer.Start(16);  // ~60 FPS (16ms per frame)
     Bind(wxEVT_TIMER, &GameView::OnTimer, this);
     mStopWatch.Start();
+    mFrameStopWatch.Start();
+
+    // The game runs on its own thread unless switched off in the
+    // menu. Levels it loads there must find their bitmaps made.
+    mGame.PreloadLevels();
+    mSimulation.Start();
 }
 
 
@@ -66,6 +119,7 @@ void GameView::Initialize(wxFrame* parent)
  */
 void GameView::OnPaint(wxPaintEvent& event)
 {
+    auto frameStart = std::chrono::steady_clock::now();
 
     wxAutoBufferedPaintDC dc(this);
 
@@ -73,23 +127,59 @@ void GameView::OnPaint(wxPaintEvent& event)
     const double MaxElapsed = 0.05;
     // Compute the time that has elapsed
     // since the last call to OnPaint.
-    auto newTime = mStopWatch.Time();
+    auto newTime = mFrameStopWatch.Time();
     auto elapsed = (double)(newTime - mTime) * 0.001;
     mTime = newTime;
 
+    // On its own thread the game updates itself. The latest
+    // state it has captured is drawn.
+    auto size = GetClientSize();
+    const bool threaded = mSimulation.IsRunning();
+    if (threaded)
+    {
+        mSimulation.SetViewSize(size.GetWidth(), size.GetHeight());
+        mSimulation.Update();
+        elapsed = 0;
+    }
+    // Holding backspace plays the recent past backwards
+    else if (mRewindDown)
+    {
+        mGame.Rewind(elapsed);
+        elapsed = 0;
+    }
+
+    // The inputs sent are timed to the tick that applied the last of them
+    auto& state = mSimulation.GetState();
+    if (threaded && state.GetTick() > mLatencyTick && state.GetInputs() >= mInputsSent)
+    {
+        mInputLatency.OnTick(state.GetTickTime());
+        mLatencyTick = state.GetTick();
+    }
+
+    // In low latency mode the keys are read right before every
+    // sub-step rather than once per timer event
+    auto step = [this](double time) {
+        if (mLowLatency)
+        {
+            SampleInput();
+        }
+        mInputLatency.OnTick();
+        mGame.Update(time);
+        Telemetry::Count(Telemetry::Counter::SubSteps);
+    };
+
     //
     // Prevent Tunneling
     //
     while (elapsed > MaxElapsed)
     {
-        mGame.Update(MaxElapsed);
-
+        step(MaxElapsed);
         elapsed -= MaxElapsed;
     }
     // Consume remaining time
     if (elapsed > 0)
     {
-        mGame.Update(elapsed);
+        step(elapsed);
     }
 
 
@@ -99,27 +189,52 @@ void GameView::OnPaint(wxPaintEvent& event)
     dc.Clear();
 
     // Create a graphics context
-    auto size = GetClientSize();
     auto graphics = std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create(dc));
 
-    // Tell the game class to draw
-    mGame.OnDraw(graphics, size.GetWidth(), size.GetHeight());
-    mScoreboard.OnDraw(graphics,size.GetWidth(),size.GetHeight());
+    // Tell the game class to draw, or draw what it captured
+    std::wstring gameMessage;
+    std::wstring levelMessage;
+    if (threaded)
+    {
+        state.Draw(graphics, mScaledBitmaps, mSoftwareRenderer, size.GetWidth(), size.GetHeight());
+        Scoreboard::Draw(graphics, size.GetWidth(), state.GetTime(), state.GetScore());
+        gameMessage = state.GetMessage();
+        levelMessage = state.GetLevelMessage();
+    }
+    else
+    {
+        mGame.OnDraw(graphics, size.GetWidth(), size.GetHeight());
+        mScoreboard.OnDraw(graphics,size.GetWidth(),size.GetHeight());
+        gameMessage = mGame.GetMessage();
+        levelMessage = mGame.GetLevelMessage();
+    }
 
-    if (!mGame.GetMessage().empty())
+    // Accounting walks every item, so it is redone once a second
+    if (mShowMemory)
+    {
+        if (newTime - mMemoryReportTime >= 1000)
+        {
+            auto lock = mSimulation.Lock();
+            mMemoryReport = mGame.GetMemoryReport();
+            mMemoryReportTime = newTime;
+        }
+        mMemoryReport.Draw(graphics, 5, 45);
+    }
+
+    if (!gameMessage.empty())
     {
         auto gc = wxGraphicsContext::Create(dc);
         if (gc)
         {
             gc->SetFont(wxFontInfo(40).Bold(), *wxRED);
-            gc->DrawText(mGame.GetMessage(), 400, 300);
+            gc->DrawText(gameMessage, 400, 300);
         }
     }
     // Draw the level message in the center
     auto gc2 = wxGraphicsContext::Create(dc);
-    if (gc2 && !mGame.GetLevelMessage().empty())
+    if (gc2 && !levelMessage.empty())
     {
-        wxString message = mGame.GetLevelMessage();
+        wxString message = levelMessage;
 
         // Create a big bold font
         wxFont font(48, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
@@ -138,6 +253,10 @@ void GameView::OnPaint(wxPaintEvent& event)
         gc2->DrawText(message, x, y);
     }
 
+    mInputLatency.OnPresent();
+
+    std::chrono::duration<double> frameTime = std::chrono::steady_clock::now() - frameStart;
+    Telemetry::EndFrame(frameTime.count());
 }
 
 /**
@@ -146,38 +265,60 @@ void GameView::OnPaint(wxPaintEvent& event)
  */
 void GameView::OnTimer(wxTimerEvent& event)
 {
-    auto football = mGame.GetFootball();
-    if (!football)
+    // The watcher needs a running event loop, so it is
+    // started from the first timer event
+    if (!mLevelWatcher)
     {
-        Refresh();
-        return;
+        mLevelWatcher = std::make_unique<wxFileSystemWatcher>();
+        mLevelWatcher->SetOwner(this);
+        mLevelWatcher->Add(wxFileName::DirName(L"levels"),
+                wxFSW_EVENT_CREATE | wxFSW_EVENT_MODIFY | wxFSW_EVENT_RENAME);
     }
+    ApplyReloadedLevel();
 
-    double xV = 0;
-    double yV = football->GetYVelocity();
-    double const xSpeed=300;
-    double yJumpVel = -750;
-    if (mLeftDown)
-        xV = -xSpeed;
-    if (mRightDown)
-        xV = xSpeed;
-    if (!football->GetGrounded())
+    if (mSimulation.IsRunning())
     {
-
-    }
-    else
-    {
-        yV=0;
-        if (mSpaceDown)
+        if (mInputPending)
         {
-            yV = yJumpVel;
+            SendInput();
         }
     }
-    football->SetXVelocity(xV);
-    football->SetYVelocity(yV);
+    else if (!mRewindDown && !mLowLatency)
+    {
+        SampleInput();
+    }
     Refresh();
 }
 
+/**
+ * Give the game the keys that are down
+ */
+void GameView::SampleInput()
+{
+    mGame.ApplyInput(mLeftDown, mRightDown, mSpaceDown);
+    mInputLatency.OnSample();
+}
+
+/**
+ * Send the keys that are down to the simulation thread. If its
+ * queue is full they are sent again from the timer.
+ */
+void GameView::SendInput()
+{
+    SimulationThread::Input input;
+    input.left = mLeftDown;
+    input.right = mRightDown;
+    input.jump = mSpaceDown;
+    input.rewind = mRewindDown;
+
+    mInputPending = !mSimulation.Send(input);
+    if (!mInputPending)
+    {
+        mInputsSent++;
+        mInputLatency.OnSample();
+    }
+}
+
 
 
 
@@ -200,6 +341,7 @@ void GameView::OnFileSaveAs(wxCommandEvent& event)
     }
 
     auto filename = saveFileDialog.GetPath();
+    auto lock = mSimulation.Lock();
     mGame.Save(filename);
 }
 
@@ -218,7 +360,10 @@ void GameView::OnFileOpen(wxCommandEvent& event)
 
     auto filename = loadFileDialog.GetPath();
 
-    mGame.Load(filename);
+    {
+        auto lock = mSimulation.Lock();
+        mGame.Load(filename);
+    }
     Refresh();
 }
 
@@ -262,6 +407,8 @@ void GameView::OnMouseMove(wxMouseEvent &event)
  */
 void GameView::OnKeyDown(wxKeyEvent& event)
 {
+    const bool left = mLeftDown, right = mRightDown, space = mSpaceDown, rewind = mRewindDown;
+
     switch (event.GetKeyCode())
     {
     case WXK_LEFT:
@@ -273,6 +420,19 @@ void GameView::OnKeyDown(wxKeyEvent& event)
     case WXK_SPACE:
         mSpaceDown = true;
         break;
+    case WXK_BACK:
+        mRewindDown = true;
+        break;
+    }
+
+    // Held keys repeat; only a change is an input
+    if (left != mLeftDown || right != mRightDown || space != mSpaceDown)
+    {
+        OnInputChanged();
+    }
+    else if (rewind != mRewindDown && mSimulation.IsRunning())
+    {
+        SendInput();
     }
 }
 
@@ -282,6 +442,8 @@ void GameView::OnKeyDown(wxKeyEvent& event)
  */
 void GameView::OnKeyUp(wxKeyEvent& event)
 {
+    const bool left = mLeftDown, right = mRightDown, space = mSpaceDown, rewind = mRewindDown;
+
     switch (event.GetKeyCode())
     {
     case WXK_LEFT:
@@ -293,6 +455,37 @@ void GameView::OnKeyUp(wxKeyEvent& event)
     case WXK_SPACE:
         mSpaceDown = false;
         break;
+    case WXK_BACK:
+        mRewindDown = false;
+        break;
+    }
+
+    if (left != mLeftDown || right != mRightDown || space != mSpaceDown)
+    {
+        OnInputChanged();
+    }
+    else if (rewind != mRewindDown && mSimulation.IsRunning())
+    {
+        SendInput();
+    }
+}
+
+/**
+ * A movement key changed. It is timed through to the frame
+ * that shows it, and in low latency mode a frame is asked for
+ * now instead of at the next timer event. The simulation
+ * thread is sent the keys at once.
+ */
+void GameView::OnInputChanged()
+{
+    mInputLatency.OnInput();
+    if (mSimulation.IsRunning())
+    {
+        SendInput();
+    }
+    if (mLowLatency)
+    {
+        Refresh();
     }
 }
 
@@ -302,12 +495,15 @@ void GameView::OnKeyUp(wxKeyEvent& event)
 */
 void GameView::LoadLevel(int level)
 {
+    auto lock = mSimulation.Lock();
     mStopWatch.Pause();
     mScoreboard.Reset();
     
     /// Reset coin multiplier when new level loaded or restarted
     mGame.ResetCoinMultiplier();
+    wxStopWatch loadTime;
     mGame.LoadLevel(level);
+    wxLogStatus(wxString::Format("Level %d loaded in %ld ms", level, loadTime.Time()));
     mStopWatch.Start();
     Refresh();
 
@@ -362,6 +558,63 @@ void GameView::Shutdown()
     {
         mTimer.Stop();
     }
+    mSimulation.Stop();
+    mLevelWatcher.reset();
+
+    if (!Telemetry::Write(TelemetryFile))
+    {
+        wxLogError(L"Unable to write %s", TelemetryFile);
+    }
+}
+
+/**
+ * Handle a change in the levels directory. If the current
+ * level changed, it is read again on a worker thread.
+ * @param event File system watcher event
+ */
+void GameView::OnLevelFileChanged(wxFileSystemWatcherEvent& event)
+{
+    auto lock = mSimulation.Lock();
+    const auto& levelFile = mGame.GetLevelFile();
+    if (!levelFile.empty() && event.GetPath().SameAs(wxFileName(levelFile)))
+    {
+        mLevelReloader.Request(levelFile);
+    }
+}
+
+/**
+ * Apply an edited level that has been read, keeping
+ * the game going where it is
+ */
+void GameView::ApplyReloadedLevel()
+{
+    std::wstring filename;
+    auto level = mLevelReloader.Poll(filename);
+    if (!level)
+    {
+        return;
+    }
+
+    auto lock = mSimulation.Lock();
+    if (filename != mGame.GetLevelFile())
+    {
+        return;
+    }
+
+    if (!level->GetError().empty())
+    {
+        // Probably caught the editor halfway through saving
+        wxLogStatus(L"Level not reloaded: %s", level->GetError());
+        return;
+    }
+
+    // Later loads of this level get the edited version
+    std::shared_ptr<const LevelData> shared = std::move(level);
+    mGame.GetAssets()->SetLevel(filename, shared);
+
+    wxStopWatch reloadTime;
+    mGame.HotReload(*shared);
+    wxLogStatus(L"Level reloaded in %ld ms", reloadTime.Time());
 }
 
 /**
@@ -371,7 +624,129 @@ void GameView::Shutdown()
 void GameView::OnRestartLevel(wxCommandEvent& event)
 {
     //mStopWatch.Pause();
+    auto lock = mSimulation.Lock();
     mGame.ReloadCurrentLevel();
     //mStopWatch.Start();
     //Refresh();
 }
+
+/**
+ * Handles switching how static terrain is kept. The level is
+ * loaded again so the change shows at once.
+ * @param event Menu event, checked to put platforms and walls on a tile map
+ */
+void GameView::OnTiledTerrain(wxCommandEvent& event)
+{
+    int level;
+    {
+        auto lock = mSimulation.Lock();
+        mGame.SetTiledTerrain(event.IsChecked());
+        level = mGame.GetLevel();
+    }
+    LoadLevel(level);
+
+    auto lock = mSimulation.Lock();
+    auto& tiles = mGame.GetTileMap();
+    if (tiles.IsActive())
+    {
+        wxLogStatus(L"Tiled terrain: %d tiles in %d x %d cells", tiles.GetFilled(), tiles.GetColumns(),
+                    tiles.GetRows());
+    }
+}
+
+/**
+ * Handles switching between the software renderer and the graphics context
+ * @param event Menu event, checked for the software renderer
+ */
+void GameView::OnSoftwareRenderer(wxCommandEvent& event)
+{
+    {
+        auto lock = mSimulation.Lock();
+        mGame.SetSoftwareRendering(event.IsChecked());
+    }
+    if (event.IsChecked())
+    {
+        auto kernel = SoftwareRenderer::KernelName(mSoftwareRenderer.GetKernel());
+        wxLogStatus(L"Software renderer (%s)", kernel);
+    }
+    else
+    {
+        wxLogStatus(L"Graphics context renderer");
+    }
+    Refresh();
+}
+
+/**
+ * Handles showing and hiding the memory report overlay
+ * @param event Menu event, checked to show the overlay
+ */
+void GameView::OnMemoryReport(wxCommandEvent& event)
+{
+    mShowMemory = event.IsChecked();
+    if (mShowMemory)
+    {
+        auto lock = mSimulation.Lock();
+        mMemoryReport = mGame.GetMemoryReport();
+        mMemoryReportTime = mFrameStopWatch.Time();
+    }
+    Refresh();
+}
+
+/**
+ * Handles writing the telemetry counters now, instead of waiting for exit
+ * @param event Menu event
+ */
+void GameView::OnWriteTelemetry(wxCommandEvent& event)
+{
+    if (Telemetry::Write(TelemetryFile))
+    {
+        wxLogStatus(L"Telemetry written to %s", TelemetryFile);
+    }
+    else
+    {
+        wxLogError(L"Unable to write %s", TelemetryFile);
+    }
+}
+
+/**
+ * Handles switching where the keys are read
+ * @param event Menu event, checked to read the keys at the start of each frame
+ */
+void GameView::OnLowLatency(wxCommandEvent& event)
+{
+    mLowLatency = event.IsChecked();
+
+    // Measurements from the two modes are not mixed
+    mInputLatency.Reset();
+}
+
+/**
+ * Handles showing the input latency distribution
+ * @param event Menu event
+ */
+void GameView::OnLatencyReport(wxCommandEvent& event)
+{
+    wxLogMessage(L"%s", mInputLatency.ToString());
+}
+
+/**
+ * Handles switching where the game runs. Off, it is updated
+ * in the paint handler as before.
+ * @param event Menu event, checked to run the game on its own thread
+ */
+void GameView::OnSimulationThread(wxCommandEvent& event)
+{
+    if (event.IsChecked())
+    {
+        mSimulation.Start();
+        SendInput();
+    }
+    else
+    {
+        mSimulation.Stop();
+    }
+
+    // Measurements from the two modes are not mixed
+    mInputLatency.Reset();
+    Refresh();
+}
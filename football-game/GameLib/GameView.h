@@ -7,8 +7,13 @@
 
 #ifndef PROJECT1_GAMEVIEW_H
 #define PROJECT1_GAMEVIEW_H
+#include <memory>
+#include <wx/fswatcher.h>
 #include "Game.h"
 #include "Scoreboard.h"
+#include "LevelReloader.h"
+#include "InputLatency.h"
+#include "SimulationThread.h"
 
 /**
  * Game Window
@@ -23,6 +28,9 @@ private:
     wxTimer mTimer;
     /// Stopwatch used to measure elapsed time
     wxStopWatch mStopWatch;
+    /// Stopwatch for frame timing. Never paused, so timed
+    /// game events keep running while the level clock is stopped.
+    wxStopWatch mFrameStopWatch;
 
     /// The last stopwatch time
     long mTime = 0;
@@ -32,7 +40,46 @@ private:
     bool mRightDown = false;
     /// Space is pressed
     bool mSpaceDown = false;
+    /// Backspace is pressed, play runs backwards
+    bool mRewindDown = false;
+
+    /// Read the keys at the start of each frame instead of in the timer?
+    bool mLowLatency = false;
+    /// Times key presses through to the frames that show them
+    InputLatency mInputLatency;
+
+    /// Show the memory report overlay?
+    bool mShowMemory = false;
+    /// Memory report shown in the overlay
+    MemoryReport mMemoryReport;
+    /// Frame stopwatch time the memory report was made
+    long mMemoryReportTime = 0;
+
+    /// Runs the game on its own thread. Destroyed before the game.
+    SimulationThread mSimulation{&mGame};
+    /// Bitmaps at the display scale for drawing render states
+    ScaledBitmapCache mScaledBitmaps;
+    /// Software renderer for drawing render states
+    SoftwareRenderer mSoftwareRenderer;
+    /// Inputs sent to the simulation thread
+    uint64_t mInputsSent = 0;
+    /// The keys changed but the simulation's queue was full
+    bool mInputPending = false;
+    /// Latest tick input latency was measured to
+    uint64_t mLatencyTick = 0;
+
+    /// Watches the levels directory for edits
+    std::unique_ptr<wxFileSystemWatcher> mLevelWatcher;
+    /// Reads edited levels off the main thread
+    LevelReloader mLevelReloader;
+
+    void OnLevelFileChanged(wxFileSystemWatcherEvent& event);
+    void ApplyReloadedLevel();
+    void SampleInput();
+    void SendInput();
+    void OnInputChanged();
 public:
+    GameView();
     ~GameView();
     void Initialize(wxFrame* parent);
     void OnTimer(wxTimerEvent& event);
@@ -51,6 +98,13 @@ public:
     void LoadLevelThree(wxCommandEvent& event);
     void Shutdown();
     void OnRestartLevel(wxCommandEvent& event);
+    void OnSoftwareRenderer(wxCommandEvent& event);
+    void OnMemoryReport(wxCommandEvent& event);
+    void OnWriteTelemetry(wxCommandEvent& event);
+    void OnLowLatency(wxCommandEvent& event);
+    void OnLatencyReport(wxCommandEvent& event);
+    void OnTiledTerrain(wxCommandEvent& event);
+    void OnSimulationThread(wxCommandEvent& event);
 };
 
 
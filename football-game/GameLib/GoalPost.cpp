@@ -17,12 +17,13 @@ const wstring GoalPostImage = L"images/goalpost.png"; ///
  * Constructor
  * @param game and GoalPost image
  */
-GoalPost::GoalPost(Game *game) : Item(game, GoalPostImage)
+GoalPost::GoalPost(Game *game) : ItemOf(game, GoalPostImage, CollisionClass::Trigger)
 {
-    wxBitmap test(L"images/sparty.png", wxBITMAP_TYPE_ANY);
-    if (!test.IsOk())
+    // Checked through the asset cache, since goal posts can be
+    // made on the simulation thread, where no bitmap may be made
+    if (GetArchetype()->width == 0)
     {
-        wxLogError(L"Could not load PowerUp image!");
+        wxLogError(L"Could not load GoalPost image!");
     }
 }
 
@@ -10,7 +10,7 @@
 #include "Item.h"
 
 
-class GoalPost : public Item
+class GoalPost : public ItemOf<GoalPost>
 {
 private:
 
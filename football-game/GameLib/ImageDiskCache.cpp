@@ -0,0 +1,246 @@
+/**
+ * @file ImageDiskCache.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "ImageDiskCache.h"
+#include "MappedFile.h"
+#include "Telemetry.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+/// Identifies a cache file
+const char CacheMagic[4] = {'S', 'P', 'T', 'I'};
+
+/// Version of the cache file format
+const uint32_t CacheVersion = 1;
+
+/// The pixels start on a multiple of this many bytes
+const uint64_t PixelAlignment = 64;
+
+/// Start of a cache file. The source path follows, then the pixels.
+struct CacheHeader
+{
+    char magic[4];          ///< CacheMagic
+    uint32_t version;       ///< CacheVersion
+    uint32_t width;         ///< Image width in pixels
+    uint32_t height;        ///< Image height in pixels
+    uint64_t sourceSize;    ///< Size of the image file in bytes
+    int64_t sourceTime;     ///< Modification time of the image file
+    uint32_t pathBytes;     ///< Length of the source path in bytes
+    uint8_t hasAlpha;       ///< Is there an alpha plane after the colors?
+    uint8_t hasMask;        ///< Does the image have a mask color?
+    uint8_t mask[3];        ///< Mask red, green and blue
+    uint8_t unused[3];      ///< Padding, zero
+    uint64_t pixels;        ///< Offset of the pixels from the start of the file
+};
+
+/// What the cache knows of an image file
+struct SourceInfo
+{
+    std::string path;       ///< Absolute path, UTF-8
+    uint64_t size = 0;      ///< Size in bytes
+    int64_t time = 0;       ///< Modification time
+};
+
+/**
+ * Find the absolute path, size and modification time of an image file
+ * @param source Image file name
+ * @param info Filled in with what was found
+ * @return False if the file cannot be found
+ */
+static bool Describe(const std::wstring& source, SourceInfo& info)
+{
+    std::error_code error;
+    auto path = std::filesystem::absolute(std::filesystem::path(source), error).lexically_normal();
+    if (error)
+    {
+        return false;
+    }
+
+    auto size = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        return false;
+    }
+
+    auto time = std::filesystem::last_write_time(path, error);
+    if (error)
+    {
+        return false;
+    }
+
+    info.path = path.u8string();
+    info.size = size;
+    info.time = int64_t(time.time_since_epoch().count());
+    return true;
+}
+
+/**
+ * Constructor
+ * @param directory Directory to keep the cache files in. It is
+ * made when the first file is stored.
+ */
+ImageDiskCache::ImageDiskCache(const std::wstring& directory) : mDirectory(directory)
+{
+}
+
+/**
+ * Get the name of the cache file for an image. It is named for a
+ * hash of the image's absolute path.
+ * @param source Image file name
+ * @return Cache file name
+ */
+std::wstring ImageDiskCache::GetCacheFile(const std::wstring& source) const
+{
+    std::error_code error;
+    auto path = std::filesystem::absolute(std::filesystem::path(source), error).lexically_normal();
+    auto name = path.u8string();
+
+    // 64 bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : name)
+    {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+
+    wchar_t hex[17];
+    swprintf(hex, 17, L"%016llx", (unsigned long long)hash);
+    return (std::filesystem::path(mDirectory) / (std::wstring(hex) + L".img")).wstring();
+}
+
+/**
+ * Load an image from its cache file.
+ *
+ * The image uses the mapped pixels without copying them, so the
+ * file must stay open until the image, and every image sharing
+ * its data, is no longer used. A bitmap made from the image has
+ * its own copy.
+ *
+ * @param source Image file name
+ * @param file Mapping of the cache file, opened here
+ * @param image Set to the image on success
+ * @return False if there is no valid cache file for the image
+ * as it is now. The image is left alone.
+ */
+bool ImageDiskCache::Load(const std::wstring& source, MappedFile& file, wxImage& image) const
+{
+    SourceInfo info;
+    if (!Describe(source, info) || !file.Open(GetCacheFile(source)))
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    if (file.GetSize() < sizeof(header))
+    {
+        file.Close();
+        return false;
+    }
+    std::memcpy(&header, file.GetData(), sizeof(header));
+
+    uint64_t pixels = uint64_t(header.width) * header.height;
+    uint64_t planes = header.hasAlpha ? 4 : 3;
+    bool valid = std::memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) == 0 &&
+        header.version == CacheVersion && header.width > 0 && header.height > 0 &&
+        header.sourceSize == info.size && header.sourceTime == info.time &&
+        header.pathBytes == info.path.size() &&
+        sizeof(header) + header.pathBytes <= header.pixels &&
+        header.pixels <= file.GetSize() && pixels * planes <= file.GetSize() - header.pixels &&
+        std::memcmp(file.GetData() + sizeof(header), info.path.data(), info.path.size()) == 0;
+    if (!valid)
+    {
+        file.Close();
+        return false;
+    }
+
+    unsigned char* data = file.GetData() + header.pixels;
+    image = wxImage(int(header.width), int(header.height), data, true);
+    if (header.hasAlpha)
+    {
+        image.SetAlpha(data + pixels * 3, true);
+    }
+    if (header.hasMask)
+    {
+        image.SetMaskColour(header.mask[0], header.mask[1], header.mask[2]);
+    }
+
+    Telemetry::Count(Telemetry::Counter::ImageCacheHits);
+    return true;
+}
+
+/**
+ * Store a decoded image in its cache file
+ * @param source Image file name the image was decoded from
+ * @param image The decoded image
+ * @return True if the file was written
+ */
+bool ImageDiskCache::Store(const std::wstring& source, const wxImage& image) const
+{
+    SourceInfo info;
+    if (!image.IsOk() || !Describe(source, info))
+    {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(mDirectory), error);
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+    header.version = CacheVersion;
+    header.width = uint32_t(image.GetWidth());
+    header.height = uint32_t(image.GetHeight());
+    header.sourceSize = info.size;
+    header.sourceTime = info.time;
+    header.pathBytes = uint32_t(info.path.size());
+    header.hasAlpha = image.HasAlpha() ? 1 : 0;
+    header.hasMask = image.HasMask() ? 1 : 0;
+    if (image.HasMask())
+    {
+        header.mask[0] = image.GetMaskRed();
+        header.mask[1] = image.GetMaskGreen();
+        header.mask[2] = image.GetMaskBlue();
+    }
+    uint64_t start = sizeof(header) + info.path.size();
+    header.pixels = (start + PixelAlignment - 1) / PixelAlignment * PixelAlignment;
+
+    // Each thread writes its own temporary file, so two storing
+    // the same image cannot write into one file
+    std::filesystem::path target(GetCacheFile(source));
+    std::filesystem::path temporary = target;
+    temporary += L"." + std::to_wstring(std::hash<std::thread::id>()(std::this_thread::get_id())) + L".tmp";
+
+    size_t pixels = size_t(header.width) * header.height;
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        const char padding[PixelAlignment] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(info.path.data(), info.path.size());
+        out.write(padding, std::streamsize(header.pixels - start));
+        out.write(reinterpret_cast<const char*>(image.GetData()), std::streamsize(pixels * 3));
+        if (image.HasAlpha())
+        {
+            out.write(reinterpret_cast<const char*>(image.GetAlpha()), std::streamsize(pixels));
+        }
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary, target, error);
+    if (error)
+    {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file ImageDiskCache.h
+ * @author Brennan Eagle
+ *
+ * Decoded images kept on disk between runs
+ */
+
+#ifndef IMAGEDISKCACHE_H
+#define IMAGEDISKCACHE_H
+
+#include <string>
+
+class MappedFile;
+
+/**
+ * Decoded images kept on disk between runs.
+ *
+ * Decoding a PNG is most of the cost of loading an image. Once an
+ * image has been decoded, its pixels are written to a file in the
+ * cache directory, named for the path of the image. The next run
+ * maps that file and hands the pixels straight to wxImage, with no
+ * decoding and no copy.
+ *
+ * The pixels are stored the way wxImage keeps them, the red, green
+ * and blue bytes of every pixel and then the alpha bytes, rather
+ * than interleaved, so the mapped file can be the image's data.
+ *
+ * Each file records the path, size and modification time of the
+ * image it was made from. If the image has changed since, or the
+ * file is damaged or from another version, the file is ignored and
+ * the image decoded as usual. Files are written under a temporary
+ * name and renamed, so a half written one is never read.
+ */
+class ImageDiskCache
+{
+private:
+    /// Directory the cache files are kept in
+    std::wstring mDirectory;
+
+public:
+    explicit ImageDiskCache(const std::wstring& directory);
+
+    /**
+     * Get the directory the cache files are kept in
+     * @return Directory name
+     */
+    const std::wstring& GetDirectory() const { return mDirectory; }
+
+    std::wstring GetCacheFile(const std::wstring& source) const;
+    bool Load(const std::wstring& source, MappedFile& file, wxImage& image) const;
+    bool Store(const std::wstring& source, const wxImage& image) const;
+};
+
+#endif //IMAGEDISKCACHE_H
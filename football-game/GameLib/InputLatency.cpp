@@ -0,0 +1,181 @@
+/**
+ * @file InputLatency.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "InputLatency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+/// Stage names, in Stage order
+static const char* StageNames[] = {"sample", "tick", "present", "total"};
+
+/**
+ * Constructor
+ * @param capacity Number of presented inputs kept for the distribution
+ */
+InputLatency::InputLatency(size_t capacity) : mCapacity(std::max(capacity, size_t(1)))
+{
+}
+
+/**
+ * A key changed
+ * @param when When the key event arrived
+ */
+void InputLatency::OnInput(Clock::time_point when)
+{
+    Input input;
+    input.pressed = when;
+    mPending.push_back(input);
+}
+
+/**
+ * The game was given the current key state
+ * @param when When the state was applied
+ */
+void InputLatency::OnSample(Clock::time_point when)
+{
+    for (auto& input : mPending)
+    {
+        input.sampled = when;
+        mSampled.push_back(input);
+    }
+    mPending.clear();
+}
+
+/**
+ * A simulation tick ran
+ * @param when When the tick started
+ */
+void InputLatency::OnTick(Clock::time_point when)
+{
+    for (auto& input : mSampled)
+    {
+        input.ticked = when;
+        mTicked.push_back(input);
+    }
+    mSampled.clear();
+}
+
+/**
+ * A frame was drawn
+ * @param when When drawing finished
+ */
+void InputLatency::OnPresent(Clock::time_point when)
+{
+    auto ms = [](Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+
+    for (auto& input : mTicked)
+    {
+        double times[] = {
+            ms(input.sampled - input.pressed),
+            ms(input.ticked - input.sampled),
+            ms(when - input.ticked),
+            ms(when - input.pressed)
+        };
+        for (int stage = 0; stage < 4; stage++)
+        {
+            mSamples[stage].push_back(times[stage]);
+            if (mSamples[stage].size() > mCapacity)
+            {
+                mSamples[stage].pop_front();
+            }
+        }
+    }
+    mTicked.clear();
+}
+
+/**
+ * Get the distribution of one stage over the kept inputs
+ * @param stage Stage to report
+ * @return Distribution in milliseconds
+ */
+InputLatency::Stats InputLatency::GetStats(Stage stage) const
+{
+    Stats stats;
+    std::vector<double> sorted(mSamples[int(stage)].begin(), mSamples[int(stage)].end());
+    if (sorted.empty())
+    {
+        return stats;
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    // Nearest rank percentile
+    auto percentile = [&sorted](double p) {
+        size_t rank = size_t(std::ceil(p * sorted.size()));
+        return sorted[std::min(std::max(rank, size_t(1)), sorted.size()) - 1];
+    };
+
+    double sum = 0;
+    for (double value : sorted)
+    {
+        sum += value;
+    }
+
+    stats.count = sorted.size();
+    stats.mean = sum / sorted.size();
+    stats.p50 = percentile(0.50);
+    stats.p95 = percentile(0.95);
+    stats.p99 = percentile(0.99);
+    stats.max = sorted.back();
+    return stats;
+}
+
+/**
+ * Get the distribution as text, for display
+ * @return One line per stage
+ */
+std::wstring InputLatency::ToString() const
+{
+    std::wostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(1);
+
+    auto total = GetStats(Stage::Total);
+    out << L"Input latency over " << total.count << L" inputs (ms)";
+    for (int stage = 0; stage < 4; stage++)
+    {
+        auto stats = GetStats(Stage(stage));
+        out << L"\n" << StageNames[stage] << L": mean " << stats.mean << L", p50 " << stats.p50
+            << L", p95 " << stats.p95 << L", p99 " << stats.p99 << L", max " << stats.max;
+    }
+    return out.str();
+}
+
+/**
+ * Get the distribution as JSON
+ * @return JSON object with the stats of each stage in milliseconds
+ */
+std::string InputLatency::ToJson() const
+{
+    std::ostringstream out;
+    out << '{';
+    for (int stage = 0; stage < 4; stage++)
+    {
+        auto stats = GetStats(Stage(stage));
+        out << (stage ? "," : "") << '"' << StageNames[stage] << "\":{\"count\":" << stats.count
+            << ",\"mean\":" << stats.mean << ",\"p50\":" << stats.p50 << ",\"p95\":" << stats.p95
+            << ",\"p99\":" << stats.p99 << ",\"max\":" << stats.max << '}';
+    }
+    out << '}';
+    return out.str();
+}
+
+/**
+ * Forget every input, measured or in flight
+ */
+void InputLatency::Reset()
+{
+    mPending.clear();
+    mSampled.clear();
+    mTicked.clear();
+    for (auto& samples : mSamples)
+    {
+        samples.clear();
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * @file InputLatency.h
+ * @author Brennan Eagle
+ *
+ * Measures the time from a key press to the frame that shows it
+ */
+
+#ifndef INPUTLATENCY_H
+#define INPUTLATENCY_H
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * Measures the time from a key press to the frame that shows it.
+ *
+ * Each input is timestamped when the key changes, and follows
+ * the game loop through three stages:
+ *
+ *   - sampled: the key state was given to the game
+ *   - ticked: the first simulation tick after that ran
+ *   - presented: the frame drawn after that tick was finished
+ *
+ * When an input is presented the time spent in each stage is
+ * kept. The most recent inputs are kept for the distribution.
+ */
+class InputLatency
+{
+public:
+    /// Clock used for the timestamps
+    typedef std::chrono::steady_clock Clock;
+
+    /// Part of the latency to report
+    enum class Stage
+    {
+        Sample,   ///< Key press until the game was given the key state
+        Tick,     ///< Sampled until the next simulation tick
+        Present,  ///< Ticked until the frame was drawn
+        Total     ///< Key press until the frame was drawn
+    };
+
+    /// Distribution of one stage in milliseconds
+    struct Stats
+    {
+        /// Number of inputs measured
+        size_t count = 0;
+        /// Mean
+        double mean = 0;
+        /// Median
+        double p50 = 0;
+        /// 95th percentile
+        double p95 = 0;
+        /// 99th percentile
+        double p99 = 0;
+        /// Largest
+        double max = 0;
+    };
+
+private:
+    /// An input on its way through the game loop
+    struct Input
+    {
+        /// When the key changed
+        Clock::time_point pressed;
+        /// When the game was given the key state
+        Clock::time_point sampled;
+        /// When the next tick ran
+        Clock::time_point ticked;
+    };
+
+    /// Inputs not yet sampled
+    std::vector<Input> mPending;
+    /// Inputs sampled, waiting for a tick
+    std::vector<Input> mSampled;
+    /// Inputs ticked, waiting for a frame
+    std::vector<Input> mTicked;
+
+    /// Stage times of presented inputs in milliseconds, oldest first
+    std::deque<double> mSamples[4];
+
+    /// Number of presented inputs kept
+    size_t mCapacity;
+
+public:
+    explicit InputLatency(size_t capacity = 1000);
+
+    void OnInput(Clock::time_point when = Clock::now());
+    void OnSample(Clock::time_point when = Clock::now());
+    void OnTick(Clock::time_point when = Clock::now());
+    void OnPresent(Clock::time_point when = Clock::now());
+
+    Stats GetStats(Stage stage) const;
+    std::wstring ToString() const;
+    std::string ToJson() const;
+    void Reset();
+};
+
+#endif //INPUTLATENCY_H
@@ -6,28 +6,36 @@
 #include "pch.h"
 #include "Item.h"
 #include "Game.h"
+#include "GameSnapshot.h"
+#include "ScaledBitmapCache.h"
+#include "SoftwareRenderer.h"
+
+#include <cmath>
 
 using namespace std;
 /**
  * Constructor
- * @param
+ * @param game Game this item is in
+ * @param filename Image file for this item
+ * @param collision What the item is to the football
  */
-Item::Item(Game* game, const std::wstring &filename)
+Item::Item(Game* game, const std::wstring &filename, CollisionClass collision)
 {
     mGame = game;
-    mItemBitmap = game->GetCachedImage(filename);
-    mWid = mItemBitmap->GetWidth();
-    mHit = mItemBitmap->GetHeight();
+    mArchetype = game->GetArchetype(filename, collision);
+    mCollisionLayer = mArchetype->layer;
 }
 
-void Item::SetBitmap(std::shared_ptr<wxBitmap> bitmap)
+/**
+ * Constructor for an item whose archetype is already resolved
+ * @param game Game this item is in
+ * @param archetype Archetype owned by the game, nullptr for an item with no image
+ */
+Item::Item(Game* game, const ItemArchetype* archetype)
 {
-    mItemBitmap = bitmap;
-    if (mItemBitmap)
-    {
-        mWid = mItemBitmap->GetWidth();
-        mHit = mItemBitmap->GetHeight();
-    }
+    mGame = game;
+    mArchetype = archetype != nullptr ? archetype : ItemArchetype::Empty();
+    mCollisionLayer = mArchetype->layer;
 }
 
 /**
@@ -46,10 +54,8 @@ Item::~Item()
  */
 bool Item::HitTest(int x, int y)
 {
-    if (!mItemBitmap) return false;
-    
-    double wid = mItemBitmap->GetWidth();
-    double hit = mItemBitmap->GetHeight();
+    double wid = GetWidth();
+    double hit = GetHeight();
 
     double testX = x - GetX() + wid / 2;
     double testY = y - GetY() + hit / 2;
@@ -68,15 +74,60 @@ bool Item::HitTest(int x, int y)
  */
 void Item::Draw(shared_ptr<wxGraphicsContext> gc, double offset)
 {
-    if (!mItemBitmap) return;
-    
-    double wid = mItemBitmap->GetWidth();
-    double hit = mItemBitmap->GetHeight();
+    if (!mArchetype->bitmap) return;
+
+    double wid = GetWidth();
+    double hit = GetHeight();
 
     const double x = GetX() - wid / 2.0;
     const double y = GetY() - hit / 2.0;
 
-    gc->DrawBitmap(*mItemBitmap, x-offset, y, wid, hit);
+    gc->DrawBitmap(*mArchetype->bitmap, x-offset, y, wid, hit);
+}
+
+/**
+ * Draw this item on an unscaled graphics context, using a
+ * bitmap already resampled to the display scale.
+ *
+ * The edges are rounded to whole device pixels, so the bitmap
+ * is drawn one to one and neighbouring tiles meet exactly.
+ *
+ * @param gc graphics context in device pixels
+ * @param bitmaps Bitmaps at the display scale
+ * @param offset Scroll offset in virtual pixels
+ */
+void Item::DrawScaled(shared_ptr<wxGraphicsContext> gc, ScaledBitmapCache& bitmaps, double offset)
+{
+    auto bitmap = bitmaps.Get(mArchetype);
+    if (bitmap == nullptr) return;
+
+    const double scale = bitmaps.GetScale();
+    const double x = GetX() - GetWidth() / 2.0 - offset;
+    const double y = GetY() - GetHeight() / 2.0;
+
+    const double left = std::round(x * scale);
+    const double top = std::round(y * scale);
+    const double right = std::round((x + GetWidth()) * scale);
+    const double bottom = std::round((y + GetHeight()) * scale);
+
+    gc->DrawBitmap(*bitmap, left, top, right - left, bottom - top);
+}
+
+/**
+ * Draw this item into the software renderer's frame
+ * @param renderer Renderer with a frame begun
+ * @param offset Scroll offset in virtual pixels
+ */
+void Item::DrawSoftware(SoftwareRenderer& renderer, double offset)
+{
+    auto sprite = renderer.GetSprite(mArchetype);
+    if (sprite == nullptr) return;
+
+    const double scale = renderer.GetScale();
+    const double x = GetX() - GetWidth() / 2.0 - offset;
+    const double y = GetY() - GetHeight() / 2.0;
+
+    renderer.Blit(*sprite, int(std::lround(x * scale)), int(std::lround(y * scale)));
 }
 
 
@@ -116,11 +167,55 @@ void Item::XmlLoad(wxXmlNode *node)
     node->GetAttribute(L"y", L"0").ToDouble(&mY);
 }
 
+/**
+ * Move the item and where it was last frame.
+ * Items that keep other positions, like the center
+ * of their motion, override this to move those too.
+ * @param dx Distance to move in X in virtual pixels
+ * @param dy Distance to move in Y in virtual pixels
+ */
+void Item::MoveBy(double dx, double dy)
+{
+    SetLocation(mX + dx, mY + dy);
+    mPrevX += dx;
+    mPrevY += dy;
+}
+
+/**
+ * Write the dynamic state of this item to a snapshot.
+ * Override this to add state for specific items.
+ * @param snapshot Snapshot to write to
+ */
+void Item::SaveState(GameSnapshot& snapshot) const
+{
+    snapshot.Write(mX);
+    snapshot.Write(mY);
+    snapshot.Write(mPrevX);
+    snapshot.Write(mPrevY);
+    snapshot.Write(mAsleep);
+    snapshot.Write(mSleepTime);
+}
+
+/**
+ * Read the dynamic state of this item from a snapshot.
+ * Must read exactly what SaveState wrote.
+ * @param snapshot Snapshot to read from
+ */
+void Item::LoadState(GameSnapshot& snapshot)
+{
+    snapshot.Read(mX);
+    snapshot.Read(mY);
+    snapshot.Read(mPrevX);
+    snapshot.Read(mPrevY);
+    snapshot.Read(mAsleep);
+    snapshot.Read(mSleepTime);
+}
+
 /**
  * Gets the bitmap of an item
  * @return the bitmap of an item
  */
 std::shared_ptr<wxBitmap> Item::GetBitmap()
 {
-    return mItemBitmap;
+    return mArchetype->bitmap;
 }
@@ -9,10 +9,14 @@
 #define PROJECT1_ITEM_H
 
 #include <wx/xml/xml.h>
+#include "ItemArchetype.h"
 
 class wxXmlNode;
 class CollisionVisitor; ///<forward ref
 class Game; ///<forward ref
+class GameSnapshot; ///<forward ref
+class ScaledBitmapCache; ///<forward ref
+class SoftwareRenderer; ///<forward ref
 
 class Item
 {
@@ -23,21 +27,38 @@ private:
     // Previous item location
     double mPrevX = 0;
     double mPrevY = 0;
-    // Item width and height
-    double mWid = 0;
-    double mHit = 0;
 
-    /// The bitmap we can display for this item
-    std::shared_ptr<wxBitmap> mItemBitmap;
+    /// Image, size and collision class shared with similar items
+    const ItemArchetype* mArchetype = nullptr;
+
+    /// Is this item asleep outside the active region?
+    bool mAsleep = false;
+    /// Level time this item was last updated before it went to sleep
+    double mSleepTime = 0;
+
+    /// Index of this item in the level roster, -1 if not in one
+    int mRosterIndex = -1;
+
+    /// Collision layer this item is on
+    unsigned mCollisionLayer = CollisionLayer::None;
+
+    /// Collision layers this item tests against
+    unsigned mCollisionMask = CollisionLayer::None;
+
+    /// Last tick of the game this item was kept awake in
+    unsigned mAwakeTick = 0;
 
 protected:
     /// Pointer to the game this item belongs to
     Game* mGame = nullptr;
     /**
-     * Set the bitmap for this item
-     * @param bitmap shared pointer to bitmap
+     * Set the archetype for this item
+     * @param archetype Archetype owned by the game, nullptr for no image
      */
-    void SetBitmap(std::shared_ptr<wxBitmap> bitmap);
+    void SetArchetype(const ItemArchetype* archetype)
+    {
+        mArchetype = archetype != nullptr ? archetype : ItemArchetype::Empty();
+    }
 
 public:
     /// Default constructor (disabled)
@@ -47,7 +68,9 @@ public:
     Item(const Item &) = delete;
 
     ~Item();
-    Item(Game* game, const std::wstring& filename);
+    Item(Game* game, const std::wstring& filename,
+         CollisionClass collision = CollisionClass::Decoration);
+    Item(Game* game, const ItemArchetype* archetype);
     /**
     * The X location of the item
     * @returns X location in pixels
@@ -75,11 +98,15 @@ public:
     /**
      * @returns the Width of the item
      */
-    double GetWidth() const { return mWid; }
+    double GetWidth() const { return mArchetype->width; }
     /**
      * @returns the Width of the item
      */
-    double GetHeight() const { return mHit; }
+    double GetHeight() const { return mArchetype->height; }
+    /**
+     * @returns the archetype shared with similar items
+     */
+    const ItemArchetype* GetArchetype() const { return mArchetype; }
     /**
      * Set the item location
      * @param x X location in pixels
@@ -89,8 +116,69 @@ public:
 
     virtual bool HitTest(int x, int y);
     virtual void Draw(std::shared_ptr<wxGraphicsContext> gc, double offset);
+    void DrawScaled(std::shared_ptr<wxGraphicsContext> gc, ScaledBitmapCache& bitmaps, double offset);
+    void DrawSoftware(SoftwareRenderer& renderer, double offset);
     virtual wxXmlNode* XmlSave(wxXmlNode* node);
     virtual void XmlLoad(wxXmlNode* node);
+    virtual void MoveBy(double dx, double dy);
+    virtual void SaveState(GameSnapshot& snapshot) const;
+    virtual void LoadState(GameSnapshot& snapshot);
+
+    /**
+     * Set the index of this item in the level roster
+     * @param index Roster index
+     */
+    void SetRosterIndex(int index) { mRosterIndex = index; }
+
+    /**
+     * Get the index of this item in the level roster
+     * @return Roster index, -1 if not in the roster
+     */
+    int GetRosterIndex() const { return mRosterIndex; }
+
+    /**
+     * Note that the game kept this item awake in a tick
+     * @param tick The game's tick count
+     */
+    void SetAwakeTick(unsigned tick) { mAwakeTick = tick; }
+
+    /**
+     * Get the last tick the game kept this item awake in
+     * @return The game's tick count then, 0 if never
+     */
+    unsigned GetAwakeTick() const { return mAwakeTick; }
+
+    /**
+     * Get the collision layer this item is on
+     * @return Layer bit, or 0 if nothing collides with it
+     */
+    unsigned GetCollisionLayer() const { return mCollisionLayer; }
+
+    /**
+     * Set the collision layer this item is on
+     * @param layer Layer bit, or 0 if nothing collides with it
+     */
+    void SetCollisionLayer(unsigned layer) { mCollisionLayer = layer; }
+
+    /**
+     * Get the collision layers this item tests against
+     * @return Mask of layer bits
+     */
+    unsigned GetCollisionMask() const { return mCollisionMask; }
+
+    /**
+     * Set the collision layers this item tests against
+     * @param mask Mask of layer bits
+     */
+    void SetCollisionMask(unsigned mask) { mCollisionMask = mask; }
+
+    /**
+     * Can this item touch another one? A plain bit test,
+     * so it can run before any virtual call.
+     * @param other Item to test against
+     * @return True if the other item is on a layer in our mask
+     */
+    bool CanCollideWith(const Item* other) const { return (mCollisionMask & other->mCollisionLayer) != 0; }
     std::shared_ptr<wxBitmap> GetBitmap();
 
     // Deals with how an object collides with another object
@@ -105,6 +193,58 @@ public:
      */
     virtual void Update(double elapsed) {}
 
+    /**
+     * Does this item change on its own over time? Only dynamic
+     * items are updated and put to sleep when far off screen.
+     * @return True if Update does anything for this item
+     */
+    virtual bool IsDynamic() const { return false; }
+
+    /**
+     * Can this item ever move or be removed on its own? Items that
+     * cannot are indexed by their location once, and are not
+     * looked at when they are far from the football and the view.
+     * @return True if the item may become dynamic
+     */
+    virtual bool CanMove() const { return IsDynamic(); }
+
+    /**
+     * Must this item keep being updated when it is outside the
+     * active region? Such an item is never put to sleep.
+     * @return True if the item must stay awake
+     */
+    virtual bool StaysAwake() const { return false; }
+
+    /**
+     * Is this item asleep outside the active region?
+     * @return True if asleep
+     */
+    bool IsAsleep() const { return mAsleep; }
+
+    /**
+     * Put this item to sleep
+     * @param time Level time the item was last updated
+     */
+    void Sleep(double time) { mAsleep = true; mSleepTime = time; }
+
+    /**
+     * Wake this item up
+     * @param time Current level time
+     * @return Seconds the item missed while it was asleep
+     */
+    double Wake(double time) { mAsleep = false; return time - mSleepTime; }
+
+    /**
+     * Does this item overlap a horizontal range of the level?
+     * @param left Left edge of the range in virtual pixels
+     * @param right Right edge of the range in virtual pixels
+     * @return True if any part of the item is in the range
+     */
+    bool InRange(double left, double right) const
+    {
+        return mX + GetWidth() / 2 >= left && mX - GetWidth() / 2 <= right;
+    }
+
     /**
      * Accept a collision visitor
      * @param visitor The collision visitor
@@ -116,6 +256,34 @@ public:
      * @param game Pointer to the game for context
      */
     virtual bool ShouldRemove(const Game* game) const { return false; }
+
+    /**
+     * Get the memory this item takes, not counting what it
+     * shares with other items, such as its archetype
+     * @return Size of the object in bytes
+     */
+    virtual size_t GetMemorySize() const { return sizeof(*this); }
+};
+
+/**
+ * Base for concrete item classes that reports the size of the
+ * class it is given, so each item class does not have to.
+ *
+ * @tparam Derived The item class deriving from this
+ * @tparam Base The class it extends
+ */
+template <class Derived, class Base = Item>
+class ItemOf : public Base
+{
+public:
+    using Base::Base;
+
+    /**
+     * Get the memory this item takes, not counting what it
+     * shares with other items, such as its archetype
+     * @return Size of the object in bytes
+     */
+    size_t GetMemorySize() const override { return sizeof(Derived); }
 };
 
 
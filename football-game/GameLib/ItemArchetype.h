@@ -0,0 +1,95 @@
+/**
+ * @file ItemArchetype.h
+ * @author Brennan Eagle
+ *
+ * Shared, immutable data for a kind of item
+ */
+
+#ifndef ITEMARCHETYPE_H
+#define ITEMARCHETYPE_H
+
+#include <memory>
+
+/**
+ * What an item is to the football when they touch
+ */
+enum class CollisionClass
+{
+    Decoration, ///< Nothing happens (backgrounds)
+    Terrain,    ///< Blocks the football (platforms, walls)
+    Pickup,     ///< Collected by the football (coins, power-ups)
+    Hazard,     ///< Loses the level (enemies)
+    Trigger     ///< Causes a level event (goal posts)
+};
+
+/**
+ * Collision layer bits. An item is on one layer, and tests
+ * against the items on the layers in its collision mask.
+ */
+namespace CollisionLayer
+{
+    const unsigned None = 0;               ///< Never collides
+    const unsigned Decoration = 1u << 0;   ///< Backgrounds
+    const unsigned Terrain = 1u << 1;      ///< Platforms and walls
+    const unsigned Pickup = 1u << 2;       ///< Coins and power-ups
+    const unsigned Hazard = 1u << 3;       ///< Enemies
+    const unsigned Trigger = 1u << 4;      ///< Goal posts
+
+    /**
+     * Get the layer for a collision class
+     * @param collision Collision class
+     * @return Layer bit
+     */
+    inline unsigned Of(CollisionClass collision)
+    {
+        return 1u << unsigned(collision);
+    }
+}
+
+/**
+ * Data shared by every item that looks and collides the same.
+ *
+ * A level has thousands of coins and terrain tiles but only a
+ * handful of distinct images. Each distinct image and collision
+ * class gets one archetype, owned by the game, and items keep a
+ * pointer to it instead of their own copy of the bitmap handle
+ * and size.
+ *
+ * This is only part of the way to items that cost a few bytes.
+ * Each coin or tile is still a polymorphic Item held by a
+ * shared_ptr, with its own location, previous location, sleep
+ * state, roster index and collision layer and mask. The layer and
+ * mask stay on the item because the game changes them per item,
+ * such as taking items that cannot collide off every layer.
+ */
+struct ItemArchetype
+{
+    /// The bitmap we display for items of this kind
+    std::shared_ptr<wxBitmap> bitmap;
+    /// Width in virtual pixels
+    double width = 0;
+    /// Height in virtual pixels
+    double height = 0;
+    /// What the item is to the football
+    CollisionClass collision = CollisionClass::Decoration;
+    /// Collision layer bit for the collision class
+    unsigned layer = CollisionLayer::Decoration;
+
+    /**
+     * Get the archetype of items declared without an image. It
+     * has no bitmap and no size and collides with nothing, so
+     * such an item loads and is simply not seen.
+     * @return The shared empty archetype
+     */
+    static const ItemArchetype* Empty()
+    {
+        static const ItemArchetype empty = [] {
+            ItemArchetype archetype;
+            archetype.layer = CollisionLayer::None;
+            return archetype;
+        }();
+        return &empty;
+    }
+};
+
+#endif //ITEMARCHETYPE_H
@@ -19,11 +19,31 @@ const wstring coin10Image = L"images/coin10.png"; ///<10
  * Constructor
  * @param aquarium Aquarium this fish is a member of
  */
-ItemCoin10::ItemCoin10(Game *game) : Item(game, coin10Image)
+ItemCoin10::ItemCoin10(Game *game) : ItemOf(game, coin10Image, CollisionClass::Pickup)
 {
 
 }
 
+/**
+ * Constructor for a coin whose archetype is already resolved
+ * @param game Game this coin is in
+ * @param archetype Coin archetype from ResolveArchetype
+ */
+ItemCoin10::ItemCoin10(Game *game, const ItemArchetype* archetype) : ItemOf(game, archetype)
+{
+
+}
+
+/**
+ * Get the archetype shared by all 10 point coins
+ * @param game Game that owns the archetype
+ * @return Coin archetype
+ */
+const ItemArchetype* ItemCoin10::ResolveArchetype(Game* game)
+{
+    return game->GetArchetype(coin10Image, CollisionClass::Pickup);
+}
+
 /**
  * Save this fish to an XML node
  * @param node The parent node we are going to be a child of
@@ -59,4 +79,13 @@ void ItemCoin10::Update(double elapsed)
         double newX = GetX() + moveSpeed * elapsed;
         SetLocation(newX, GetY());
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Coins only move in Level 2
+ * @return True if this coin moves
+ */
+bool ItemCoin10::IsDynamic() const
+{
+    return mGame && mGame->GetLevel() == 2;
+}
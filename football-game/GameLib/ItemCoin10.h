@@ -12,7 +12,7 @@
 /**
  * Coin class (value 10)
  */
-class ItemCoin10 : public Item {
+class ItemCoin10 : public ItemOf<ItemCoin10> {
 private:
 
 public:
@@ -26,9 +26,13 @@ public:
     void operator=(const ItemCoin10 &) = delete;
 
     ItemCoin10(Game* game);
+    ItemCoin10(Game* game, const ItemArchetype* archetype);
+
+    static const ItemArchetype* ResolveArchetype(Game* game);
     wxXmlNode* XmlSave(wxXmlNode* node) override;
     void Accept(CollisionVisitor* visitor) override;
     void Update(double elapsed) override;
+    bool IsDynamic() const override;
 };
 
 
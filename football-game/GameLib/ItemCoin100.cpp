@@ -18,11 +18,31 @@ const wstring coin100Image = L"images/coin100.png"; ///<100
  * Constructor
  * @param aquarium Aquarium this fish is a member of
  */
-ItemCoin100::ItemCoin100(Game *game) : Item(game, coin100Image)
+ItemCoin100::ItemCoin100(Game *game) : ItemOf(game, coin100Image, CollisionClass::Pickup)
 {
 
 }
 
+/**
+ * Constructor for a coin whose archetype is already resolved
+ * @param game Game this coin is in
+ * @param archetype Coin archetype from ResolveArchetype
+ */
+ItemCoin100::ItemCoin100(Game *game, const ItemArchetype* archetype) : ItemOf(game, archetype)
+{
+
+}
+
+/**
+ * Get the archetype shared by all 100 point coins
+ * @param game Game that owns the archetype
+ * @return Coin archetype
+ */
+const ItemArchetype* ItemCoin100::ResolveArchetype(Game* game)
+{
+    return game->GetArchetype(coin100Image, CollisionClass::Pickup);
+}
+
 /**
  * Save this fish to an XML node
  * @param node The parent node we are going to be a child of
@@ -59,3 +79,12 @@ void ItemCoin100::Update(double elapsed)
         SetLocation(newX, GetY());
     }
 }
+
+/**
+ * Coins only move in Level 2
+ * @return True if this coin moves
+ */
+bool ItemCoin100::IsDynamic() const
+{
+    return mGame && mGame->GetLevel() == 2;
+}
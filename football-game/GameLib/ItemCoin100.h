@@ -13,7 +13,7 @@
 /**
  * Coin class (value 100)
  */
-class ItemCoin100 : public Item {
+class ItemCoin100 : public ItemOf<ItemCoin100> {
 private:
 
 public:
@@ -27,9 +27,13 @@ public:
     void operator=(const ItemCoin100 &) = delete;
 
     ItemCoin100(Game* game);
+    ItemCoin100(Game* game, const ItemArchetype* archetype);
+
+    static const ItemArchetype* ResolveArchetype(Game* game);
     wxXmlNode* XmlSave(wxXmlNode* node) override;
     void Accept(CollisionVisitor* visitor) override;
     void Update(double elapsed) override;
+    bool IsDynamic() const override;
 };
 
 
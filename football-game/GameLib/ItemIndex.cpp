@@ -0,0 +1,274 @@
+/**
+ * @file ItemIndex.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "ItemIndex.h"
+#include "Item.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Get the column a location is in. Locations before the first
+ * column or after the last are put in it.
+ * @param x X location in virtual pixels
+ * @return Column index
+ */
+int ItemIndex::Column(double x) const
+{
+    double column = std::floor((x - mLeft) / ColumnWidth);
+    return int(std::min(std::max(column, 0.0), double(mColumns.size() - 1)));
+}
+
+/**
+ * Get the columns an item covers
+ * @param item Item
+ * @return First and last column
+ */
+std::pair<int, int> ItemIndex::Span(const Item& item) const
+{
+    return std::make_pair(Column(item.GetX() - item.GetWidth() / 2), Column(item.GetX() + item.GetWidth() / 2));
+}
+
+/**
+ * Get the position in the item list now of an item by its
+ * position when the index was built
+ * @param built Position when the index was built
+ * @return Position now
+ */
+int ItemIndex::Current(int built) const
+{
+    return built - int(std::lower_bound(mRemoved.begin(), mRemoved.end(), built) - mRemoved.begin());
+}
+
+/**
+ * Get the position in the item list when the index was built
+ * of an item by its position now
+ * @param index Position now
+ * @return Position when the index was built
+ */
+int ItemIndex::Built(int index) const
+{
+    // The first position with index items before it that are
+    // still in the list is the item's own
+    int low = index;
+    int high = index + int(mRemoved.size());
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        int kept = mid + 1 - int(std::upper_bound(mRemoved.begin(), mRemoved.end(), mid) - mRemoved.begin());
+        if (kept > index)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1;
+        }
+    }
+    return low;
+}
+
+/**
+ * Build the index from the game's item list
+ * @param items The game's items, in order
+ * @param followed Item the view follows, returned by every query
+ */
+void ItemIndex::Build(const std::vector<std::shared_ptr<Item>>& items, const Item* followed)
+{
+    mAlways.clear();
+    mColumns.clear();
+    mRemoved.clear();
+    mSpans.assign(items.size(), std::make_pair(0, -1));
+
+    // The span of the level the items cover
+    double left = 0;
+    double right = 0;
+    bool first = true;
+    for (auto& item : items)
+    {
+        if (item.get() == followed)
+        {
+            continue;
+        }
+        double itemLeft = item->GetX() - item->GetWidth() / 2;
+        double itemRight = item->GetX() + item->GetWidth() / 2;
+        left = first ? itemLeft : std::min(left, itemLeft);
+        right = first ? itemRight : std::max(right, itemRight);
+        first = false;
+    }
+
+    mLeft = left;
+    double columns = std::floor((right - left) / ColumnWidth) + 1;
+    mColumns.resize(size_t(std::min(std::max(columns, 1.0), double(MaxColumns))));
+
+    for (int i = 0; i < int(items.size()); i++)
+    {
+        if (items[i].get() == followed)
+        {
+            mAlways.push_back(i);
+            continue;
+        }
+
+        mSpans[i] = Span(*items[i]);
+        for (int column = mSpans[i].first; column <= mSpans[i].second; column++)
+        {
+            mColumns[column].push_back(i);
+        }
+    }
+
+    mValid = true;
+    mBuilds++;
+}
+
+/**
+ * Move an item that has moved to the columns it now covers
+ * @param index Position of the item in the item list
+ * @param item The item
+ */
+void ItemIndex::Moved(int index, const Item& item)
+{
+    const int built = Built(index);
+    auto& span = mSpans[built];
+    if (span.second < span.first)
+    {
+        // Always returned
+        return;
+    }
+
+    auto now = Span(item);
+    if (now == span)
+    {
+        return;
+    }
+
+    for (int column = span.first; column <= span.second; column++)
+    {
+        auto& entries = mColumns[column];
+        auto loc = std::find(entries.begin(), entries.end(), built);
+        mVisits += long(loc - entries.begin()) + 1;
+        entries.erase(loc);
+    }
+    for (int column = now.first; column <= now.second; column++)
+    {
+        mColumns[column].push_back(built);
+    }
+    span = now;
+}
+
+/**
+ * Take out an item that is being removed from the item list.
+ * Only the columns it covers are changed. Items after it move
+ * up one place in the list, which is allowed for as positions
+ * are returned.
+ * @param index Position of the item in the item list
+ */
+void ItemIndex::Removed(int index)
+{
+    if (!mValid)
+    {
+        return;
+    }
+
+    const int built = Built(index);
+    auto drop = [this, built](std::vector<int>& entries) {
+        mVisits += long(entries.size());
+        entries.erase(std::remove(entries.begin(), entries.end(), built), entries.end());
+    };
+
+    auto& span = mSpans[built];
+    if (span.second < span.first)
+    {
+        drop(mAlways);
+    }
+    for (int column = span.first; column <= span.second; column++)
+    {
+        drop(mColumns[column]);
+    }
+
+    mRemoved.insert(std::upper_bound(mRemoved.begin(), mRemoved.end(), built), built);
+}
+
+/**
+ * Find the items that may overlap a horizontal range of the level.
+ * Callers still test each item against the range.
+ * @param left Left edge of the range in virtual pixels
+ * @param right Right edge of the range in virtual pixels
+ * @param found Cleared, then set to the positions in the item list, in order
+ */
+void ItemIndex::Query(double left, double right, std::vector<int>& found) const
+{
+    found.assign(mAlways.begin(), mAlways.end());
+    if (!mColumns.empty())
+    {
+        int last = Column(right);
+        for (int column = Column(left); column <= last; column++)
+        {
+            found.insert(found.end(), mColumns[column].begin(), mColumns[column].end());
+        }
+    }
+
+    // Items that cover more than one column are found once for each
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+    if (!mRemoved.empty())
+    {
+        for (auto& index : found)
+        {
+            index = Current(index);
+        }
+    }
+}
+
+/**
+ * Find where an item is in the item list, looking only at the
+ * columns it covers
+ * @param items The game's items, in order
+ * @param item Item to find
+ * @return Position of the item in the list, or -1 if it is not there
+ */
+int ItemIndex::Find(const std::vector<std::shared_ptr<Item>>& items, const Item& item) const
+{
+    auto search = [this, &items, &item](const std::vector<int>& entries) {
+        for (int built : entries)
+        {
+            mVisits++;
+            int index = Current(built);
+            if (index < int(items.size()) && items[index].get() == &item)
+            {
+                return index;
+            }
+        }
+        return -1;
+    };
+
+    int found = search(mAlways);
+    if (found >= 0 || mColumns.empty())
+    {
+        return found;
+    }
+
+    auto span = Span(item);
+    for (int column = span.first; column <= span.second && found < 0; column++)
+    {
+        found = search(mColumns[column]);
+    }
+    return found;
+}
+
+/**
+ * Get the memory the index takes
+ * @return Bytes used
+ */
+size_t ItemIndex::GetMemoryUsed() const
+{
+    size_t bytes = mAlways.capacity() * sizeof(int) + mColumns.capacity() * sizeof(std::vector<int>) +
+        mSpans.capacity() * sizeof(std::pair<int, int>) + mRemoved.capacity() * sizeof(int);
+    for (auto& column : mColumns)
+    {
+        bytes += column.capacity() * sizeof(int);
+    }
+    return bytes;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file ItemIndex.h
+ * @author Brennan Eagle
+ *
+ * Finds the items near part of the level without looking at every item
+ */
+
+#ifndef ITEMINDEX_H
+#define ITEMINDEX_H
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+class Item;
+
+/**
+ * Finds the items near part of the level without looking at every item.
+ *
+ * Items are put into columns of the level by the part of it they
+ * cover. An item that moves is moved to its new columns by the
+ * game after it is updated; items far from the view are asleep
+ * and stay where they are. The item the view follows is always
+ * returned. A query returns the positions in the game's item
+ * list of every item that may overlap a horizontal range, in item
+ * list order, so items are still drawn and collided in the order
+ * they were added.
+ *
+ * The index refers to items by their position in the item list
+ * when it was built. When an item is removed, as a coin is when
+ * collected, its entries are dropped from the columns it covers
+ * and its position is noted. Positions are moved down past the
+ * items removed before them as they are returned, so a removal
+ * does not walk the rest of the index. Other changes to the list
+ * invalidate the index and it is built again the next time it is
+ * used.
+ */
+class ItemIndex
+{
+private:
+    /// Width of a column in virtual pixels
+    static constexpr double ColumnWidth = 256;
+
+    /// Most columns, so items placed far away cannot use up memory
+    static const int MaxColumns = 4096;
+
+    /// Items returned by every query, by position in the item list
+    std::vector<int> mAlways;
+
+    /// Items by position in the item list, for each column
+    std::vector<std::vector<int>> mColumns;
+
+    /// First and last column of each item, by position in the item list
+    std::vector<std::pair<int, int>> mSpans;
+
+    /// Positions at the last build of the items removed since, in order
+    std::vector<int> mRemoved;
+
+    /// Left edge of the first column in virtual pixels
+    double mLeft = 0;
+
+    /// Does the index match the item list?
+    bool mValid = false;
+
+    /// Number of times the index has been built
+    long mBuilds = 0;
+
+    /// Entries looked at to find, move and remove items
+    mutable long mVisits = 0;
+
+    int Column(double x) const;
+    std::pair<int, int> Span(const Item& item) const;
+    int Current(int built) const;
+    int Built(int index) const;
+
+public:
+    void Build(const std::vector<std::shared_ptr<Item>>& items, const Item* followed);
+    void Moved(int index, const Item& item);
+    void Removed(int index);
+    void Query(double left, double right, std::vector<int>& found) const;
+    int Find(const std::vector<std::shared_ptr<Item>>& items, const Item& item) const;
+
+    /// The item list has changed, so the index must be built again
+    void Invalidate() { mValid = false; }
+
+    /**
+     * Does the index match the item list?
+     * @return True if it has been built since the list last changed
+     */
+    bool IsValid() const { return mValid; }
+
+    /**
+     * Get the number of times the index has been built
+     * @return Number of builds
+     */
+    long GetBuildCount() const { return mBuilds; }
+
+    /**
+     * Get the number of entries looked at to find, move and
+     * remove items since the index was created
+     * @return Number of entries
+     */
+    long GetVisitCount() const { return mVisits; }
+
+    /**
+     * Get the number of columns
+     * @return Number of columns
+     */
+    size_t GetColumnCount() const { return mColumns.size(); }
+
+    size_t GetMemoryUsed() const;
+};
+
+#endif //ITEMINDEX_H
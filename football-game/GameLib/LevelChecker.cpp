@@ -0,0 +1,441 @@
+/**
+ * @file LevelChecker.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "LevelChecker.h"
+#include "Game.h"
+#include "Background.h"
+#include "Football.h"
+#include "ItemCoin10.h"
+#include "ItemCoin100.h"
+#include "LevelData.h"
+#include "MemoryReport.h"
+#include "MovingPlatform.h"
+#include "Platform.h"
+#include "Wall.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <thread>
+#include <unordered_map>
+
+/// Size of a grid cell in virtual pixels
+const double CellSize = 128;
+
+/// Overlap in virtual pixels that is not reported, for rounding
+const double Tolerance = 1;
+
+/// An axis aligned box in virtual pixels
+struct CheckBox
+{
+    /// Left edge
+    double left = 0;
+    /// Top edge
+    double top = 0;
+    /// Right edge
+    double right = 0;
+    /// Bottom edge
+    double bottom = 0;
+    /// Item the box came from
+    const Item* item = nullptr;
+};
+
+/**
+ * Get the box an item covers
+ * @param item Item
+ * @return Box around the item
+ */
+static CheckBox BoxOf(const Item* item)
+{
+    CheckBox box;
+    box.left = item->GetX() - item->GetWidth() / 2;
+    box.right = item->GetX() + item->GetWidth() / 2;
+    box.top = item->GetY() - item->GetHeight() / 2;
+    box.bottom = item->GetY() + item->GetHeight() / 2;
+    box.item = item;
+    return box;
+}
+
+/**
+ * Boxes bucketed by the grid cells they cover, so a query only
+ * looks at boxes near the area asked about.
+ */
+class CheckGrid
+{
+private:
+    /// Every box
+    std::vector<CheckBox> mBoxes;
+    /// Indices into mBoxes for each cell, keyed by the cell's column and row
+    std::unordered_map<int64_t, std::vector<int>> mCells;
+
+    /**
+     * Get the key of a cell
+     * @param column Cell column
+     * @param row Cell row
+     * @return Key into mCells
+     */
+    static int64_t Key(int64_t column, int64_t row) { return int64_t(uint64_t(column) << 32 ^ uint64_t(row & 0xffffffff)); }
+
+    /**
+     * Get the cell a coordinate is in
+     * @param v Coordinate in virtual pixels
+     * @return Cell column or row
+     */
+    static int64_t Cell(double v) { return int64_t(std::floor(v / CellSize)); }
+
+public:
+    /**
+     * Add a box to every cell it covers
+     * @param box Box to add
+     */
+    void Add(const CheckBox& box)
+    {
+        int index = int(mBoxes.size());
+        mBoxes.push_back(box);
+        for (auto column = Cell(box.left); column <= Cell(box.right); column++)
+        {
+            for (auto row = Cell(box.top); row <= Cell(box.bottom); row++)
+            {
+                mCells[Key(column, row)].push_back(index);
+            }
+        }
+    }
+
+    /**
+     * Get a box
+     * @param index Index the box was added at
+     * @return The box
+     */
+    const CheckBox& Get(int index) const { return mBoxes[index]; }
+
+    /**
+     * Get the number of boxes
+     * @return Number of boxes added
+     */
+    int GetCount() const { return int(mBoxes.size()); }
+
+    /**
+     * Find the boxes that may touch an area
+     * @param area Area to look in
+     * @return Indices of every box in a cell the area covers, each once
+     */
+    std::vector<int> Query(const CheckBox& area) const
+    {
+        std::vector<int> found;
+        for (auto column = Cell(area.left); column <= Cell(area.right); column++)
+        {
+            for (auto row = Cell(area.top); row <= Cell(area.bottom); row++)
+            {
+                auto cell = mCells.find(Key(column, row));
+                if (cell != mCells.end())
+                {
+                    found.insert(found.end(), cell->second.begin(), cell->second.end());
+                }
+            }
+        }
+        std::sort(found.begin(), found.end());
+        found.erase(std::unique(found.begin(), found.end()), found.end());
+        return found;
+    }
+};
+
+/**
+ * Get the name of an item's type, for reports
+ * @param item Item
+ * @return Class name
+ */
+static std::wstring TypeOf(const Item* item)
+{
+    return MemoryReport::TypeName(typeid(*item));
+}
+
+/**
+ * Constructor
+ * @param assets Assets shared by every level checked, normally headless
+ * @param threads Number of threads, 0 for one per core
+ */
+LevelChecker::LevelChecker(std::shared_ptr<AssetCache> assets, int threads) :
+    mAssets(std::move(assets))
+{
+    if (threads <= 0)
+    {
+        threads = int(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    mThreads = threads;
+}
+
+/**
+ * Highest the bottom of the football rises in a jump from a surface
+ * @return Height in virtual pixels
+ */
+double LevelChecker::JumpHeight()
+{
+    return Football::JumpSpeed * Football::JumpSpeed / (2 * Football::Gravity);
+}
+
+/**
+ * Furthest the football travels sideways in a jump that lands
+ * at the height it started from
+ * @return Distance in virtual pixels
+ */
+double LevelChecker::JumpReach()
+{
+    return Football::RunSpeed * 2 * Football::JumpSpeed / Football::Gravity;
+}
+
+/**
+ * Load and check one level
+ * @param filename Level file
+ * @return What was found
+ */
+LevelChecker::Report LevelChecker::Check(const std::wstring& filename)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    Report report;
+    report.filename = filename;
+
+    auto addIssue = [&report](Problem problem, double x, double y, const std::wstring& detail) {
+        Issue issue;
+        issue.problem = problem;
+        issue.x = x;
+        issue.y = y;
+        issue.detail = detail;
+        report.issues.push_back(issue);
+    };
+
+    LevelData level;
+    if (!level.Load(filename))
+    {
+        addIssue(Problem::LoadError, 0, 0, level.GetError());
+        return report;
+    }
+
+    // Only the level being checked is loaded, not the first level
+    Game game(mAssets, false);
+    game.SetRewindEnabled(false);
+    game.LoadLevelData(level, filename);
+
+    double footballHeight = game.GetFootball() ? game.GetFootball()->GetHeight() : 0;
+
+    CheckGrid terrain;
+    std::vector<CheckBox> moving;
+    std::vector<const Item*> coins;
+
+    for (size_t i = 0; i < game.GetRosterSize(); i++)
+    {
+        auto item = game.GetRosterItem(int(i));
+        if (item == nullptr || dynamic_cast<Football*>(item) != nullptr)
+        {
+            continue;
+        }
+        report.counts[TypeOf(item)]++;
+
+        // Backgrounds are scenery and may run past the level
+        if (dynamic_cast<Background*>(item) != nullptr)
+        {
+            continue;
+        }
+
+        if (item->GetX() < 0 || item->GetX() > level.GetWidth() ||
+            item->GetY() < 0 || item->GetY() > level.GetHeight())
+        {
+            // Reported once, and kept out of the other checks
+            addIssue(Problem::OutOfBounds, item->GetX(), item->GetY(), TypeOf(item) + L" is outside the level");
+            continue;
+        }
+
+        if (auto platform = dynamic_cast<MovingPlatform*>(item))
+        {
+            // A surface anywhere on the circle the platform moves on
+            auto box = BoxOf(item);
+            double dx = platform->GetCenterX() - item->GetX();
+            double dy = platform->GetCenterY() - item->GetY();
+            double radius = platform->GetRadius();
+            box.left += dx - radius;
+            box.right += dx + radius;
+            box.top += dy - radius;
+            box.bottom += dy + radius;
+            moving.push_back(box);
+        }
+        else if (dynamic_cast<Platform*>(item) != nullptr || dynamic_cast<Wall*>(item) != nullptr)
+        {
+            terrain.Add(BoxOf(item));
+        }
+        else if (dynamic_cast<ItemCoin10*>(item) != nullptr || dynamic_cast<ItemCoin100*>(item) != nullptr)
+        {
+            coins.push_back(item);
+        }
+    }
+
+    // Overlapping terrain, each pair once
+    for (int i = 0; i < terrain.GetCount(); i++)
+    {
+        auto& a = terrain.Get(i);
+        for (int j : terrain.Query(a))
+        {
+            if (j <= i)
+            {
+                continue;
+            }
+            auto& b = terrain.Get(j);
+            double overlapX = std::min(a.right, b.right) - std::max(a.left, b.left);
+            double overlapY = std::min(a.bottom, b.bottom) - std::max(a.top, b.top);
+            if (overlapX > Tolerance && overlapY > Tolerance)
+            {
+                addIssue(Problem::OverlappingTerrain, (std::max(a.left, b.left) + std::min(a.right, b.right)) / 2,
+                         (std::max(a.top, b.top) + std::min(a.bottom, b.bottom)) / 2,
+                         TypeOf(a.item) + L" overlaps " + TypeOf(b.item));
+            }
+        }
+    }
+
+    // The bottom of the football can rise this far above a surface,
+    // so a coin is collected if its bottom is within this plus the
+    // football's height of the surface top
+    double rise = JumpHeight() + footballHeight;
+    double reach = JumpReach();
+
+    for (auto coin : coins)
+    {
+        auto box = BoxOf(coin);
+        CheckBox center;
+        center.left = center.right = coin->GetX();
+        center.top = center.bottom = coin->GetY();
+
+        bool inWall = false;
+        for (int t : terrain.Query(center))
+        {
+            auto& wall = terrain.Get(t);
+            if (coin->GetX() > wall.left && coin->GetX() < wall.right &&
+                coin->GetY() > wall.top && coin->GetY() < wall.bottom)
+            {
+                addIssue(Problem::CoinInWall, coin->GetX(), coin->GetY(),
+                         TypeOf(coin) + L" is inside " + TypeOf(wall.item));
+                inWall = true;
+                break;
+            }
+        }
+        if (inWall)
+        {
+            continue;
+        }
+
+        // A coin is reachable from a surface near enough sideways
+        // whose top is within a jump of it. A surface above the coin
+        // counts only if the coin is no further below it than that,
+        // as the football rolling off its edge drops past the coin.
+        auto reachable = [&](const CheckBox& surface) {
+            return surface.left - reach <= box.right && surface.right + reach >= box.left &&
+                surface.top - box.bottom <= rise && box.top - surface.top <= rise;
+        };
+
+        CheckBox area;
+        area.left = box.left - reach;
+        area.right = box.right + reach;
+        area.top = box.top - rise;
+        area.bottom = box.bottom + rise;
+
+        bool found = false;
+        for (int t : terrain.Query(area))
+        {
+            if (reachable(terrain.Get(t)))
+            {
+                found = true;
+                break;
+            }
+        }
+        found = found || std::any_of(moving.begin(), moving.end(), reachable);
+
+        if (!found)
+        {
+            addIssue(Problem::UnreachableCoin, coin->GetX(), coin->GetY(),
+                     TypeOf(coin) + L" is out of jumping reach of every surface");
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    report.seconds = elapsed.count();
+    return report;
+}
+
+/**
+ * Check many levels at once
+ * @param filenames Level files
+ * @return A report for each level, in the order given
+ */
+std::vector<LevelChecker::Report> LevelChecker::CheckAll(const std::vector<std::wstring>& filenames)
+{
+    std::vector<Report> reports(filenames.size());
+    std::atomic<size_t> next(0);
+
+    auto worker = [&]() {
+        for (size_t level = next++; level < filenames.size(); level = next++)
+        {
+            reports[level] = Check(filenames[level]);
+        }
+    };
+
+    int threads = std::min(mThreads, std::max(int(filenames.size()), 1));
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    return reports;
+}
+
+/**
+ * Find the level files in a directory
+ * @param directory Directory to look in
+ * @return Every .xml file in the directory, sorted by name
+ */
+std::vector<std::wstring> LevelChecker::FindLevels(const std::wstring& directory)
+{
+    std::vector<std::wstring> levels;
+    std::error_code error;
+    for (auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == L".xml")
+        {
+            levels.push_back(entry.path().wstring());
+        }
+    }
+    std::sort(levels.begin(), levels.end());
+    return levels;
+}
+
+/**
+ * Get the name of a problem
+ * @param problem Problem
+ * @return Name used in reports
+ */
+const wchar_t* LevelChecker::ProblemName(Problem problem)
+{
+    switch (problem)
+    {
+    case Problem::LoadError:
+        return L"load error";
+    case Problem::OverlappingTerrain:
+        return L"overlapping terrain";
+    case Problem::CoinInWall:
+        return L"coin in wall";
+    case Problem::UnreachableCoin:
+        return L"unreachable coin";
+    case Problem::OutOfBounds:
+        return L"out of bounds";
+    default:
+        return L"?";
+    }
+}
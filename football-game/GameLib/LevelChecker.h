@@ -0,0 +1,103 @@
+/**
+ * @file LevelChecker.h
+ * @author Brennan Eagle
+ *
+ * Finds mistakes in level files without playing them
+ */
+
+#ifndef LEVELCHECKER_H
+#define LEVELCHECKER_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AssetCache.h"
+
+/**
+ * Finds mistakes in level files without playing them.
+ *
+ * Each level is loaded into a headless game and its items are
+ * checked for:
+ *
+ *   - platforms and walls that overlap each other
+ *   - coins whose center is inside a platform or wall
+ *   - coins too far above or below every surface near them
+ *     to be reached with a jump
+ *   - items outside the level
+ *
+ * Platforms and walls go into a grid of cells, so each check
+ * only looks at the terrain near an item. Levels are checked on
+ * a pool of threads, each taking the next level not yet checked.
+ */
+class LevelChecker
+{
+public:
+    /// Kinds of problem a level can have
+    enum class Problem
+    {
+        LoadError,          ///< The level could not be read
+        OverlappingTerrain, ///< Two platforms or walls overlap
+        CoinInWall,         ///< A coin's center is inside a platform or wall
+        UnreachableCoin,    ///< A coin is out of jumping reach of every surface near it
+        OutOfBounds         ///< An item is outside the level
+    };
+
+    /// One problem found in a level
+    struct Issue
+    {
+        /// What is wrong
+        Problem problem = Problem::LoadError;
+        /// X location in virtual pixels
+        double x = 0;
+        /// Y location in virtual pixels
+        double y = 0;
+        /// Description of the problem
+        std::wstring detail;
+    };
+
+    /// What was found in one level
+    struct Report
+    {
+        /// Level file
+        std::wstring filename;
+        /// Number of items by item type
+        std::map<std::wstring, int> counts;
+        /// Problems found
+        std::vector<Issue> issues;
+        /// Time taken to load and check the level in seconds
+        double seconds = 0;
+
+        /**
+         * Is the level free of problems?
+         * @return True if nothing was found
+         */
+        bool IsClean() const { return issues.empty(); }
+    };
+
+private:
+    /// Assets shared by every game
+    std::shared_ptr<AssetCache> mAssets;
+
+    /// Number of threads to run on
+    int mThreads;
+
+public:
+    LevelChecker(std::shared_ptr<AssetCache> assets, int threads = 0);
+
+    /**
+     * Get the number of threads levels are checked on
+     * @return Number of threads
+     */
+    int GetThreads() const { return mThreads; }
+
+    Report Check(const std::wstring& filename);
+    std::vector<Report> CheckAll(const std::vector<std::wstring>& filenames);
+
+    static std::vector<std::wstring> FindLevels(const std::wstring& directory);
+    static const wchar_t* ProblemName(Problem problem);
+    static double JumpHeight();
+    static double JumpReach();
+};
+
+#endif //LEVELCHECKER_H
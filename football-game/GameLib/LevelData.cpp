@@ -0,0 +1,299 @@
+/**
+ * @file LevelData.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "LevelData.h"
+#include "LevelReader.h"
+
+#include <cstdlib>
+
+/**
+ * Builds the level description from the elements
+ * reported by the reader.
+ */
+class LevelData::Builder : public LevelReader::Handler
+{
+private:
+    /// Sections of a level file
+    enum class Section { None, Declarations, Items };
+
+    /// Level being built
+    LevelData* mLevel;
+    /// Section we are in
+    Section mSection = Section::None;
+    /// Has the <level> root been seen?
+    bool mHasRoot = false;
+    /// Was the first element something other than <level>?
+    bool mBadRoot = false;
+
+    /**
+     * Convert a UTF-8 file name to a wide string
+     * @param value UTF-8 value
+     * @return Wide string
+     */
+    static std::wstring Wide(const std::string& value)
+    {
+        return wxString::FromUTF8(value.c_str()).ToStdWstring();
+    }
+
+    /**
+     * Map an element name to a declaration type
+     * @param name Element name
+     * @return Declaration type
+     */
+    static Type TypeOf(const std::string& name)
+    {
+        if (name == "background") return Type::Background;
+        if (name == "platform") return Type::Platform;
+        if (name == "movingplatform") return Type::MovingPlatform;
+        if (name == "wall") return Type::Wall;
+        if (name == "coin") return Type::Coin;
+        if (name == "power-up") return Type::PowerUp;
+        if (name == "enemy") return Type::Enemy;
+        if (name == "goalpost") return Type::GoalPost;
+        return Type::Unknown;
+    }
+
+    void AddDeclaration(const std::string& name, const LevelReader::Attributes& attributes);
+    void AddItem(const LevelReader::Attributes& attributes);
+
+public:
+    /**
+     * Constructor
+     * @param level Level being built
+     */
+    Builder(LevelData* level) : mLevel(level) {}
+
+    void StartElement(const std::string& name, const LevelReader::Attributes& attributes) override;
+    void EndElement(const std::string& name) override;
+
+    /**
+     * Was the root of the file a <level> element?
+     * @return True if the root was valid
+     */
+    bool IsValid() const { return mHasRoot && !mBadRoot; }
+};
+
+/**
+ * Handle the start of an element
+ * @param name Element name
+ * @param attributes Attributes of the element
+ */
+void LevelData::Builder::StartElement(const std::string& name, const LevelReader::Attributes& attributes)
+{
+    if (!mHasRoot)
+    {
+        if (name != "level")
+        {
+            mBadRoot = true;
+            return;
+        }
+
+        mHasRoot = true;
+        for (auto& attribute : attributes)
+        {
+            double value = std::strtod(attribute.value.c_str(), nullptr);
+            if (attribute.name == "start-x") mLevel->mStartX = value;
+            else if (attribute.name == "start-y") mLevel->mStartY = value;
+            else if (attribute.name == "width") mLevel->mWidth = value;
+            else if (attribute.name == "height") mLevel->mHeight = value;
+        }
+        return;
+    }
+
+    if (mBadRoot)
+    {
+        return;
+    }
+
+    switch (mSection)
+    {
+    case Section::None:
+        if (name == "declarations")
+        {
+            mSection = Section::Declarations;
+        }
+        else if (name == "items")
+        {
+            mSection = Section::Items;
+        }
+        break;
+
+    case Section::Declarations:
+        AddDeclaration(name, attributes);
+        break;
+
+    case Section::Items:
+        AddItem(attributes);
+        break;
+    }
+}
+
+/**
+ * Handle the end of an element
+ * @param name Element name
+ */
+void LevelData::Builder::EndElement(const std::string& name)
+{
+    if (name == "declarations" || name == "items")
+    {
+        mSection = Section::None;
+    }
+}
+
+/**
+ * Compile a declaration element
+ * @param name Element name, which is the declaration type
+ * @param attributes Attributes of the element
+ */
+void LevelData::Builder::AddDeclaration(const std::string& name, const LevelReader::Attributes& attributes)
+{
+    LevelData::Declaration declaration;
+    declaration.type = TypeOf(name);
+
+    for (auto& attribute : attributes)
+    {
+        if (attribute.name == "id") declaration.id = attribute.value;
+        else if (attribute.name == "image") declaration.image = Wide(attribute.value);
+        else if (attribute.name == "left-image") declaration.leftImage = Wide(attribute.value);
+        else if (attribute.name == "mid-image") declaration.midImage = Wide(attribute.value);
+        else if (attribute.name == "right-image") declaration.rightImage = Wide(attribute.value);
+        else if (attribute.name == "value") declaration.value = std::atoi(attribute.value.c_str());
+    }
+
+    if (declaration.id.empty())
+    {
+        return;
+    }
+
+    int index = mLevel->Intern(declaration.id);
+    mLevel->mDeclarations[index] = std::move(declaration);
+}
+
+/**
+ * Compile an item element
+ * @param attributes Attributes of the element
+ */
+void LevelData::Builder::AddItem(const LevelReader::Attributes& attributes)
+{
+    ItemRecord item;
+    bool hasCx = false;
+    bool hasCy = false;
+
+    for (auto& attribute : attributes)
+    {
+        auto& attr = attribute.name;
+        if (attr == "id")
+        {
+            auto found = mLevel->mIds.find(attribute.value);
+            if (found == mLevel->mIds.end())
+            {
+                wxLogWarning(L"Level item with undeclared id %s dropped", Wide(attribute.value));
+                return;
+            }
+
+            item.declaration = found->second;
+            continue;
+        }
+
+        double value = std::strtod(attribute.value.c_str(), nullptr);
+        if (attr == "x") item.x = value;
+        else if (attr == "y") item.y = value;
+        else if (attr == "width") item.width = value;
+        else if (attr == "height") item.height = value;
+        else if (attr == "cx") { item.cx = value; hasCx = true; }
+        else if (attr == "cy") { item.cy = value; hasCy = true; }
+        else if (attr == "radius") item.radius = value;
+        else if (attr == "omega") item.omega = value;
+    }
+
+    // A moving platform circles its own location unless told otherwise
+    if (!hasCx)
+    {
+        item.cx = item.x;
+    }
+    if (!hasCy)
+    {
+        item.cy = item.y;
+    }
+
+    if (item.declaration >= 0)
+    {
+        mLevel->mItems.push_back(item);
+    }
+}
+
+/**
+ * Get the interned index for a declaration ID,
+ * adding it if we have not seen it before.
+ * @param id Declaration ID
+ * @return Interned index
+ */
+int LevelData::Intern(const std::string& id)
+{
+    auto found = mIds.find(id);
+    if (found != mIds.end())
+    {
+        return found->second;
+    }
+
+    int index = int(mDeclarations.size());
+    mIds.emplace(id, index);
+    mDeclarations.emplace_back();
+    return index;
+}
+
+/**
+ * Load a level from a file
+ * @param filename Level file name
+ * @return True if the level was loaded
+ */
+bool LevelData::Load(const std::wstring& filename)
+{
+    *this = LevelData();
+
+    Builder builder(this);
+    LevelReader reader;
+    if (!reader.ParseFile(filename, builder))
+    {
+        mError = L"Cannot load level file: " + filename + L": " + reader.GetError();
+        return false;
+    }
+
+    if (!builder.IsValid())
+    {
+        mError = L"Invalid level file format";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Load a level from a buffer in memory
+ * @param data Start of the level XML
+ * @param size Number of bytes
+ * @return True if the level was loaded
+ */
+bool LevelData::Load(const char* data, size_t size)
+{
+    *this = LevelData();
+
+    Builder builder(this);
+    LevelReader reader;
+    if (!reader.Parse(data, size, builder))
+    {
+        mError = L"Cannot load level: " + reader.GetError();
+        return false;
+    }
+
+    if (!builder.IsValid())
+    {
+        mError = L"Invalid level file format";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file LevelData.h
+ * @author Brennan Eagle
+ *
+ * Description of a level as read from its file
+ */
+
+#ifndef LEVELDATA_H
+#define LEVELDATA_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Description of a level as read from its file.
+ *
+ * Declarations are interned as they are read: every declaration
+ * ID gets a small index, and items refer to their declaration
+ * by that index. Nothing here touches images or the game, so a
+ * level can be read on any thread.
+ */
+class LevelData
+{
+public:
+    /// Kinds of declaration a level can contain
+    enum class Type { Unknown, Background, Platform, MovingPlatform, Wall, Coin, PowerUp, Enemy, GoalPost };
+
+    /// A declaration from the <declarations> section
+    struct Declaration
+    {
+        /// What kind of item this declares
+        Type type = Type::Unknown;
+        /// Declaration ID
+        std::string id;
+        /// Single image file name
+        std::wstring image;
+        /// Left segment image file name
+        std::wstring leftImage;
+        /// Middle segment image file name
+        std::wstring midImage;
+        /// Right segment image file name
+        std::wstring rightImage;
+        /// Coin value
+        int value = 0;
+    };
+
+    /// An item from the <items> section
+    struct ItemRecord
+    {
+        /// Interned index of the declaration
+        int declaration = -1;
+        /// X location in virtual pixels
+        double x = 0;
+        /// Y location in virtual pixels
+        double y = 0;
+        /// Width in virtual pixels, 0 if not given
+        double width = 0;
+        /// Height in virtual pixels, 0 if not given
+        double height = 0;
+        /// Center X of a moving platform's circle
+        double cx = 0;
+        /// Center Y of a moving platform's circle
+        double cy = 0;
+        /// Radius of a moving platform's circle
+        double radius = 0;
+        /// Angular speed of a moving platform in radians per second
+        double omega = 0;
+    };
+
+private:
+    /// Starting X location of the football
+    double mStartX = 0;
+    /// Starting Y location of the football
+    double mStartY = 0;
+    /// Level width in virtual pixels
+    double mWidth = 0;
+    /// Level height in virtual pixels
+    double mHeight = 0;
+
+    /// Declarations indexed by interned ID
+    std::vector<Declaration> mDeclarations;
+    /// Items in file order
+    std::vector<ItemRecord> mItems;
+    /// Maps declaration IDs to their interned index
+    std::unordered_map<std::string, int> mIds;
+
+    /// Description of the last error
+    std::wstring mError;
+
+    class Builder;
+
+public:
+    bool Load(const std::wstring& filename);
+    bool Load(const char* data, size_t size);
+
+    int Intern(const std::string& id);
+
+    /**
+     * Get the starting X location of the football
+     * @return X in virtual pixels
+     */
+    double GetStartX() const { return mStartX; }
+
+    /**
+     * Get the starting Y location of the football
+     * @return Y in virtual pixels
+     */
+    double GetStartY() const { return mStartY; }
+
+    /**
+     * Get the level width
+     * @return Width in virtual pixels
+     */
+    double GetWidth() const { return mWidth; }
+
+    /**
+     * Get the level height
+     * @return Height in virtual pixels
+     */
+    double GetHeight() const { return mHeight; }
+
+    /**
+     * Get the declarations, indexed by interned ID
+     * @return Declarations
+     */
+    const std::vector<Declaration>& GetDeclarations() const { return mDeclarations; }
+
+    /**
+     * Get the items in file order
+     * @return Items
+     */
+    const std::vector<ItemRecord>& GetItems() const { return mItems; }
+
+    /**
+     * Get a description of why the last load failed
+     * @return Error message
+     */
+    const std::wstring& GetError() const { return mError; }
+};
+
+#endif //LEVELDATA_H
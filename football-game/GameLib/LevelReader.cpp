@@ -0,0 +1,409 @@
+/**
+ * @file LevelReader.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "LevelReader.h"
+
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+/**
+ * Is this character XML whitespace?
+ * @param c Character to test
+ * @return True if whitespace
+ */
+static bool IsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/**
+ * Is this character allowed in an element or attribute name?
+ * @param c Character to test
+ * @return True if a name character
+ */
+static bool IsNameChar(char c)
+{
+    return !IsSpace(c) && c != '=' && c != '>' && c != '/' && c != '<' && c != '"' && c != '\'';
+}
+
+/**
+ * Append a character to a string as UTF-8
+ * @param out String to append to
+ * @param code Unicode code point
+ */
+static void AppendUtf8(std::string& out, unsigned long code)
+{
+    if (code < 0x80)
+    {
+        out += char(code);
+    }
+    else if (code < 0x800)
+    {
+        out += char(0xC0 | (code >> 6));
+        out += char(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000)
+    {
+        out += char(0xE0 | (code >> 12));
+        out += char(0x80 | ((code >> 6) & 0x3F));
+        out += char(0x80 | (code & 0x3F));
+    }
+    else
+    {
+        out += char(0xF0 | (code >> 18));
+        out += char(0x80 | ((code >> 12) & 0x3F));
+        out += char(0x80 | ((code >> 6) & 0x3F));
+        out += char(0x80 | (code & 0x3F));
+    }
+}
+
+/**
+ * Decode a numeric character reference such as &#65; or &#x41;
+ * @param out String to append the character to
+ * @param begin Start of the reference, at the &
+ * @param end End of the raw value
+ * @return Number of characters the reference took, 0 if there is none
+ */
+static size_t AppendReference(std::string& out, const char* begin, const char* end)
+{
+    if (end - begin < 4 || begin[1] != '#')
+    {
+        return 0;
+    }
+
+    const char* p = begin + 2;
+    int base = 10;
+    if (*p == 'x' || *p == 'X')
+    {
+        base = 16;
+        p++;
+    }
+
+    unsigned long code = 0;
+    const char* digits = p;
+    for (; p < end && *p != ';'; p++)
+    {
+        int digit = std::isdigit((unsigned char)*p) ? *p - '0' :
+            base == 16 && std::isxdigit((unsigned char)*p) ? std::tolower((unsigned char)*p) - 'a' + 10 : -1;
+        if (digit < 0 || code > 0x10FFFF)
+        {
+            return 0;
+        }
+        code = code * base + digit;
+    }
+
+    // Surrogates and values past the last code point are not characters
+    if (p >= end || p == digits || code == 0 || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF))
+    {
+        return 0;
+    }
+
+    AppendUtf8(out, code);
+    return size_t(p + 1 - begin);
+}
+
+/**
+ * Append a value to a string, decoding the predefined XML entities
+ * and numeric character references
+ * @param out String to append to
+ * @param begin Start of the raw value
+ * @param end End of the raw value
+ */
+static void AppendDecoded(std::string& out, const char* begin, const char* end)
+{
+    static const struct { const char* entity; char c; } Entities[] = {
+        {"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''}
+    };
+
+    while (begin < end)
+    {
+        if (*begin == '&')
+        {
+            bool decoded = false;
+            for (auto& e : Entities)
+            {
+                size_t len = std::strlen(e.entity);
+                if (size_t(end - begin) >= len && std::strncmp(begin, e.entity, len) == 0)
+                {
+                    out += e.c;
+                    begin += len;
+                    decoded = true;
+                    break;
+                }
+            }
+
+            if (decoded)
+            {
+                continue;
+            }
+
+            size_t len = AppendReference(out, begin, end);
+            if (len > 0)
+            {
+                begin += len;
+                continue;
+            }
+        }
+
+        out += *begin++;
+    }
+}
+
+/**
+ * Record an error
+ * @param error Description of the error
+ * @return false, so callers can return the result directly
+ */
+bool LevelReader::Fail(const std::wstring& error)
+{
+    mError = error;
+    return false;
+}
+
+/**
+ * Parse a buffer of XML, calling the handler for each element
+ * @param data Start of the buffer
+ * @param size Number of bytes in the buffer
+ * @param handler Handler to receive the elements
+ * @return True if the buffer was well formed
+ */
+bool LevelReader::Parse(const char* data, size_t size, Handler& handler)
+{
+    const char* p = data;
+    const char* end = data + size;
+    mOpen.clear();
+    mError.clear();
+
+    // Skip a UTF-8 byte order mark
+    if (size >= 3 && std::strncmp(p, "\xEF\xBB\xBF", 3) == 0)
+    {
+        p += 3;
+    }
+
+    auto startsWith = [&p, end](const char* s) {
+        size_t len = std::strlen(s);
+        return size_t(end - p) >= len && std::strncmp(p, s, len) == 0;
+    };
+
+    auto skipPast = [&p, end](const char* s) {
+        size_t len = std::strlen(s);
+        for (; p + len <= end; p++)
+        {
+            if (std::strncmp(p, s, len) == 0)
+            {
+                p += len;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    while (p < end)
+    {
+        // Text between elements is not used by levels
+        if (*p != '<')
+        {
+            p++;
+            continue;
+        }
+
+        if (startsWith("<?"))
+        {
+            if (!skipPast("?>"))
+            {
+                return Fail(L"Unterminated processing instruction");
+            }
+            continue;
+        }
+
+        if (startsWith("<!--"))
+        {
+            if (!skipPast("-->"))
+            {
+                return Fail(L"Unterminated comment");
+            }
+            continue;
+        }
+
+        if (startsWith("<!"))
+        {
+            if (!skipPast(">"))
+            {
+                return Fail(L"Unterminated declaration");
+            }
+            continue;
+        }
+
+        if (startsWith("</"))
+        {
+            p += 2;
+            const char* name = p;
+            while (p < end && IsNameChar(*p))
+            {
+                p++;
+            }
+
+            if (p == name)
+            {
+                return Fail(L"Missing element name");
+            }
+
+            std::string closing(name, p);
+            if (mOpen.empty() || mOpen.back() != closing)
+            {
+                return Fail(L"Mismatched end tag");
+            }
+
+            if (!skipPast(">"))
+            {
+                return Fail(L"Unterminated end tag");
+            }
+
+            mOpen.pop_back();
+            handler.EndElement(closing);
+            continue;
+        }
+
+        // Start tag
+        p++;
+        const char* name = p;
+        while (p < end && IsNameChar(*p))
+        {
+            p++;
+        }
+
+        if (p == name)
+        {
+            return Fail(L"Missing element name");
+        }
+        std::string element(name, p);
+
+        // Attributes. The strings are reused from the last element.
+        size_t count = 0;
+        bool empty = false;
+        while (true)
+        {
+            while (p < end && IsSpace(*p))
+            {
+                p++;
+            }
+
+            if (p >= end)
+            {
+                return Fail(L"Unterminated start tag");
+            }
+
+            if (*p == '>')
+            {
+                p++;
+                break;
+            }
+
+            if (*p == '/')
+            {
+                if (p + 1 >= end || p[1] != '>')
+                {
+                    return Fail(L"Malformed empty element");
+                }
+                p += 2;
+                empty = true;
+                break;
+            }
+
+            const char* attrName = p;
+            while (p < end && IsNameChar(*p))
+            {
+                p++;
+            }
+            const char* attrNameEnd = p;
+            if (attrNameEnd == attrName)
+            {
+                return Fail(L"Missing attribute name");
+            }
+
+            while (p < end && IsSpace(*p))
+            {
+                p++;
+            }
+            if (p >= end || *p != '=')
+            {
+                return Fail(L"Attribute without a value");
+            }
+            p++;
+            while (p < end && IsSpace(*p))
+            {
+                p++;
+            }
+
+            if (p >= end || (*p != '"' && *p != '\''))
+            {
+                return Fail(L"Unquoted attribute value");
+            }
+            char quote = *p++;
+            const char* value = p;
+            while (p < end && *p != quote)
+            {
+                p++;
+            }
+            if (p >= end)
+            {
+                return Fail(L"Unterminated attribute value");
+            }
+
+            if (count == mAttributes.size())
+            {
+                mAttributes.emplace_back();
+            }
+            auto& attribute = mAttributes[count++];
+            attribute.name.assign(attrName, attrNameEnd);
+            attribute.value.clear();
+            AppendDecoded(attribute.value, value, p);
+            p++;
+        }
+
+        // Hand over only the attributes of this element. The rest
+        // keep their strings for the elements that follow.
+        const Attribute* attributes = mAttributes.data();
+        handler.StartElement(element, Attributes(attributes, attributes + count));
+
+        if (empty)
+        {
+            handler.EndElement(element);
+        }
+        else
+        {
+            mOpen.push_back(element);
+        }
+    }
+
+    if (!mOpen.empty())
+    {
+        return Fail(L"Unclosed element");
+    }
+
+    return true;
+}
+
+/**
+ * Parse a file of XML, calling the handler for each element
+ * @param filename File to parse
+ * @param handler Handler to receive the elements
+ * @return True if the file was read and well formed
+ */
+bool LevelReader::ParseFile(const std::wstring& filename, Handler& handler)
+{
+    std::ifstream in(std::filesystem::path(filename), std::ios::binary);
+    if (!in)
+    {
+        return Fail(L"Cannot open file");
+    }
+
+    std::string buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return Parse(buffer.data(), buffer.size(), handler);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file LevelReader.h
+ * @author Brennan Eagle
+ *
+ * Streaming reader for level XML files
+ */
+
+#ifndef LEVELREADER_H
+#define LEVELREADER_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Streaming reader for level files.
+ *
+ * Walks an XML buffer once and reports each element to a
+ * handler as it is found, in the style of expat. No document
+ * tree is built. Only the subset of XML our level files use is
+ * supported: elements, attributes, comments and the prolog.
+ * Attribute values may use the predefined entities and numeric
+ * character references.
+ */
+class LevelReader
+{
+public:
+    /// An attribute of an element
+    struct Attribute
+    {
+        /// Attribute name
+        std::string name;
+        /// Attribute value with entities decoded
+        std::string value;
+    };
+
+    /**
+     * The attributes of one element. They are only valid while
+     * the handler is being called, as the reader reuses them.
+     */
+    class Attributes
+    {
+    private:
+        /// First attribute
+        const Attribute* mBegin;
+        /// One past the last attribute
+        const Attribute* mEnd;
+
+    public:
+        /**
+         * Constructor
+         * @param begin First attribute
+         * @param end One past the last attribute
+         */
+        Attributes(const Attribute* begin, const Attribute* end) : mBegin(begin), mEnd(end) {}
+
+        /**
+         * Get the first attribute
+         * @return Iterator to the first attribute
+         */
+        const Attribute* begin() const { return mBegin; }
+
+        /**
+         * Get the end of the attributes
+         * @return Iterator past the last attribute
+         */
+        const Attribute* end() const { return mEnd; }
+
+        /**
+         * Get the number of attributes
+         * @return Number of attributes on the element
+         */
+        size_t size() const { return size_t(mEnd - mBegin); }
+    };
+
+    /**
+     * Receives elements from the reader as they are parsed
+     */
+    class Handler
+    {
+    public:
+        virtual ~Handler() = default;
+
+        /**
+         * An element has started
+         * @param name Element name
+         * @param attributes Attributes of the element
+         */
+        virtual void StartElement(const std::string& name, const Attributes& attributes) = 0;
+
+        /**
+         * An element has ended
+         * @param name Element name
+         */
+        virtual void EndElement(const std::string& name) = 0;
+    };
+
+private:
+    /// Attribute strings, reused between elements. Only the first
+    /// ones are in use for the current element.
+    std::vector<Attribute> mAttributes;
+    /// Names of the open elements
+    std::vector<std::string> mOpen;
+    /// Description of the last error
+    std::wstring mError;
+
+    bool Fail(const std::wstring& error);
+
+public:
+    bool Parse(const char* data, size_t size, Handler& handler);
+    bool ParseFile(const std::wstring& filename, Handler& handler);
+
+    /**
+     * Get a description of why the last parse failed
+     * @return Error message
+     */
+    const std::wstring& GetError() const { return mError; }
+};
+
+#endif //LEVELREADER_H
@@ -0,0 +1,97 @@
+/**
+ * @file LevelReloader.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "LevelReloader.h"
+
+/**
+ * Destructor. Waits for a file being read.
+ */
+LevelReloader::~LevelReloader()
+{
+    if (mWorker.joinable())
+    {
+        mWorker.join();
+    }
+}
+
+/**
+ * Ask for a level file to be read again
+ * @param filename Level file that changed
+ */
+void LevelReloader::Request(const std::wstring& filename)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mBusy)
+        {
+            // Read it again when the worker is done
+            mPending = filename;
+            return;
+        }
+        mBusy = true;
+    }
+
+    Start(filename);
+}
+
+/**
+ * Start the worker on a file. mBusy must already be set.
+ * @param filename Level file to read
+ */
+void LevelReloader::Start(const std::wstring& filename)
+{
+    if (mWorker.joinable())
+    {
+        mWorker.join();
+    }
+
+    mWorker = std::thread([this, filename]() {
+        auto level = std::make_unique<LevelData>();
+        level->Load(filename);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mResult = std::move(level);
+        mResultFile = filename;
+        mBusy = false;
+    });
+}
+
+/**
+ * Take a level that has been read, if there is one.
+ * Call from the main thread.
+ * @param filename Receives the file the level was read from
+ * @return The level, or nullptr if none is ready. Check
+ * its error, the file may have been saved half written.
+ */
+std::unique_ptr<LevelData> LevelReloader::Poll(std::wstring& filename)
+{
+    std::unique_ptr<LevelData> result;
+    std::wstring pending;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mBusy)
+        {
+            return nullptr;
+        }
+
+        result = std::move(mResult);
+        filename = mResultFile;
+
+        if (!mPending.empty())
+        {
+            // A newer version is waiting, the result is out of date
+            pending.swap(mPending);
+            result.reset();
+            mBusy = true;
+        }
+    }
+
+    if (!pending.empty())
+    {
+        Start(pending);
+    }
+    return result;
+}
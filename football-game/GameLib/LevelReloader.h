@@ -0,0 +1,58 @@
+/**
+ * @file LevelReloader.h
+ * @author Brennan Eagle
+ *
+ * Reads changed level files on a worker thread
+ */
+
+#ifndef LEVELRELOADER_H
+#define LEVELRELOADER_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "LevelData.h"
+
+/**
+ * Reads changed level files on a worker thread.
+ *
+ * The view asks for a file to be read when the file watcher
+ * reports a change, and polls for the result from its timer.
+ * Requests that arrive while a file is being read are merged,
+ * since editors often write a file several times in a row.
+ */
+class LevelReloader
+{
+private:
+    /// Thread reading the file
+    std::thread mWorker;
+
+    /// Protects everything below
+    std::mutex mMutex;
+    /// Is the worker reading a file?
+    bool mBusy = false;
+    /// File to read when the worker is done, empty if none
+    std::wstring mPending;
+    /// Level read by the worker, waiting to be taken
+    std::unique_ptr<LevelData> mResult;
+    /// File the result was read from
+    std::wstring mResultFile;
+
+    void Start(const std::wstring& filename);
+
+public:
+    LevelReloader() = default;
+    ~LevelReloader();
+
+    /// Copy constructor (disabled)
+    LevelReloader(const LevelReloader &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const LevelReloader &) = delete;
+
+    void Request(const std::wstring& filename);
+    std::unique_ptr<LevelData> Poll(std::wstring& filename);
+};
+
+#endif //LEVELRELOADER_H
@@ -0,0 +1,257 @@
+/**
+ * @file LevelSolver.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "LevelSolver.h"
+#include "Game.h"
+#include "Football.h"
+#include "GoalPost.h"
+#include "GameSnapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+
+/// Every action, in the order they are tried
+static const LevelSolver::Action Actions[] = {
+    LevelSolver::Action::Right, LevelSolver::Action::RightJump, LevelSolver::Action::Jump,
+    LevelSolver::Action::Idle, LevelSolver::Action::Left, LevelSolver::Action::LeftJump
+};
+
+/// Fastest the football runs in virtual pixels per second
+const double RunSpeed = Football::RunSpeed;
+
+/// One state in the search
+struct SearchNode
+{
+    /// State as a difference from the level start
+    GameSnapshot delta;
+    /// Node this one was reached from, -1 for the start
+    int parent = -1;
+    /// Action played to get here from the parent
+    LevelSolver::Action action = LevelSolver::Action::Idle;
+    /// Ticks from the start
+    long ticks = 0;
+    /// Quantized football state
+    uint64_t key = 0;
+    /// Did the action that led here reach the goal post?
+    bool goal = false;
+};
+
+/**
+ * Constructor
+ * @param game Game to search, with the level to solve loaded
+ */
+LevelSolver::LevelSolver(Game* game) : mGame(game)
+{
+}
+
+/**
+ * Get the name of an action
+ * @param action Action
+ * @return Name for printing
+ */
+const wchar_t* LevelSolver::ActionName(Action action)
+{
+    switch (action)
+    {
+    case Action::Idle:
+        return L"idle";
+    case Action::Left:
+        return L"left";
+    case Action::Right:
+        return L"right";
+    case Action::Jump:
+        return L"jump";
+    case Action::LeftJump:
+        return L"left+jump";
+    case Action::RightJump:
+        return L"right+jump";
+    }
+    return L"?";
+}
+
+/**
+ * Search for the fastest way to the goal post.
+ *
+ * Rewind capture and loading the next level at the goal are
+ * turned off in the game, and it is left at the level start.
+ *
+ * @param options How to search
+ * @return What the search found
+ */
+LevelSolver::Result LevelSolver::Solve(const Options& options)
+{
+    Result result;
+    auto start = std::chrono::steady_clock::now();
+
+    mGame->SetRewindEnabled(false);
+    mGame->SetAdvanceOnGoal(false);
+
+    GameSnapshot root;
+    mGame->Snapshot(root);
+
+    auto football = mGame->GetFootball();
+
+    // Goal posts for the heuristic
+    std::vector<double> goals;
+    for (size_t i = 0; i < mGame->GetRosterSize(); i++)
+    {
+        if (auto goal = dynamic_cast<GoalPost*>(mGame->GetRosterItem(int(i))))
+        {
+            goals.push_back(goal->GetX());
+        }
+    }
+
+    auto heuristic = [&](double x) {
+        if (!options.astar || goals.empty())
+        {
+            return 0.0;
+        }
+        double nearest = std::numeric_limits<double>::max();
+        for (double goal : goals)
+        {
+            nearest = std::min(nearest, std::abs(goal - x));
+        }
+        return nearest / RunSpeed;
+    };
+
+    // Quantized football state for dropping repeats. The fields
+    // are 16, 16, 16 and 15 bits wide, then the grounded flag.
+    auto stateKey = [&]() {
+        auto cell = [](double value, double size, int bits) {
+            return uint64_t(int64_t(std::floor(value / size))) & ((uint64_t(1) << bits) - 1);
+        };
+        return cell(football->GetX(), options.positionCell, 16) |
+            cell(football->GetY(), options.positionCell, 16) << 16 |
+            cell(football->GetXVelocity(), options.velocityCell, 16) << 32 |
+            cell(football->GetYVelocity(), options.velocityCell, 15) << 48 |
+            uint64_t(football->GetGrounded()) << 63;
+    };
+
+    std::vector<SearchNode> nodes;
+    // Fewest ticks each state has been reached in so far
+    std::unordered_map<uint64_t, long> best;
+    // States that have been expanded
+    std::unordered_set<uint64_t> closed;
+
+    // Open list ordered by estimated total time, then by age
+    typedef std::pair<double, long> OpenKey;
+    std::priority_queue<std::pair<OpenKey, int>, std::vector<std::pair<OpenKey, int>>,
+            std::greater<std::pair<OpenKey, int>>> open;
+
+    nodes.emplace_back();
+    nodes[0].delta.MakeDelta(root, root);
+    nodes[0].key = stateKey();
+    best[nodes[0].key] = 0;
+    open.push({{heuristic(football->GetX()), 0}, 0});
+    result.generated = 1;
+
+    const long maxTicks = long(options.maxTime / options.elapsed);
+    GameSnapshot state;
+    GameSnapshot child;
+    int solution = -1;
+
+    // The goal test and closing a state happen when a node is taken
+    // from the open list, so nothing cheaper can still be waiting
+    while (!open.empty() && result.expansions < options.maxExpansions)
+    {
+        int index = open.top().second;
+        open.pop();
+        if (nodes[index].goal)
+        {
+            solution = index;
+            break;
+        }
+
+        if (!closed.insert(nodes[index].key).second)
+        {
+            continue;
+        }
+        result.expansions++;
+
+        state.ApplyDelta(root, nodes[index].delta);
+        const long ticks = nodes[index].ticks;
+
+        for (Action action : Actions)
+        {
+            mGame->Restore(state);
+
+            bool left = action == Action::Left || action == Action::LeftJump;
+            bool right = action == Action::Right || action == Action::RightJump;
+            bool jump = action == Action::Jump || action == Action::LeftJump || action == Action::RightJump;
+
+            long tick = 0;
+            bool lost = false;
+            for ( ; tick < options.window; tick++)
+            {
+                mGame->ApplyInput(left, right, jump);
+                mGame->Update(options.elapsed);
+                if (mGame->IsLevelComplete() || mGame->IsLost())
+                {
+                    tick++;
+                    lost = mGame->IsLost();
+                    break;
+                }
+            }
+
+            SearchNode node;
+            node.parent = index;
+            node.action = action;
+            node.ticks = ticks + tick;
+            node.goal = mGame->IsLevelComplete();
+
+            if (!node.goal)
+            {
+                if (lost || node.ticks > maxTicks)
+                {
+                    continue;
+                }
+
+                // Only keep a state if this is the quickest way to it yet
+                node.key = stateKey();
+                auto found = best.find(node.key);
+                if (closed.count(node.key) || (found != best.end() && found->second <= node.ticks))
+                {
+                    continue;
+                }
+                best[node.key] = node.ticks;
+
+                child.Clear();
+                mGame->Snapshot(child);
+                node.delta.MakeDelta(root, child);
+                result.stateBytes += node.delta.GetSize();
+            }
+
+            double estimate = node.ticks * options.elapsed + (node.goal ? 0 : heuristic(football->GetX()));
+            nodes.push_back(std::move(node));
+            result.generated++;
+            open.push({{estimate, result.generated}, int(nodes.size()) - 1});
+        }
+    }
+
+    if (solution >= 0)
+    {
+        result.solved = true;
+        result.time = nodes[solution].ticks * options.elapsed;
+        for (int index = solution; nodes[index].parent >= 0; index = nodes[index].parent)
+        {
+            result.actions.push_back(nodes[index].action);
+        }
+        std::reverse(result.actions.begin(), result.actions.end());
+    }
+
+    // Leave the game where it started
+    mGame->Restore(root);
+
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+    result.seconds = wall.count();
+    return result;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file LevelSolver.h
+ * @author Brennan Eagle
+ *
+ * Finds the fastest way through a level by searching over inputs
+ */
+
+#ifndef LEVELSOLVER_H
+#define LEVELSOLVER_H
+
+#include <string>
+#include <vector>
+
+class Game;
+
+/**
+ * Finds the fastest way through a level by searching over inputs.
+ *
+ * Each search node is a game state. Expanding a node restores
+ * the game to it and plays each action for a window of ticks.
+ * States are kept as differences from the level start snapshot,
+ * so a node costs only what changed. States whose football
+ * position and velocity fall in the same cells as a state
+ * already seen are dropped.
+ *
+ * Nodes are taken from the open list in order of time from the
+ * start plus the heuristic, and the goal test is made then. With
+ * the A* heuristic (distance to the nearest goal post at full
+ * running speed) the search heads for the goal first. Without it
+ * nodes are taken in order of time alone. Either way the time
+ * found is the shortest among the states the search keeps, as long
+ * as the football never outruns its running speed; quantizing
+ * states can still drop a faster path.
+ */
+class LevelSolver
+{
+public:
+    /// Inputs held for one window of ticks
+    enum class Action { Idle, Left, Right, Jump, LeftJump, RightJump };
+
+    /// How to search
+    struct Options
+    {
+        /// Time of one tick in seconds
+        double elapsed = 1.0 / 60;
+        /// Ticks each action is held for
+        int window = 6;
+        /// Longest run to consider in seconds
+        double maxTime = 60;
+        /// Give up after this many expansions
+        long maxExpansions = 500000;
+        /// Position cell size in virtual pixels
+        double positionCell = 8;
+        /// Velocity cell size in virtual pixels per second
+        double velocityCell = 50;
+        /// Use the A* heuristic, otherwise breadth first
+        bool astar = true;
+    };
+
+    /// What the search found
+    struct Result
+    {
+        /// Was the goal post reached?
+        bool solved = false;
+        /// Time to reach the goal post in seconds
+        double time = 0;
+        /// Actions to play, one per window
+        std::vector<Action> actions;
+        /// Nodes expanded
+        long expansions = 0;
+        /// Nodes created
+        long generated = 0;
+        /// Bytes held by node states at the end
+        size_t stateBytes = 0;
+        /// Wall clock time in seconds
+        double seconds = 0;
+
+        /**
+         * Get the search rate
+         * @return Node expansions per second
+         */
+        double ExpansionsPerSecond() const { return seconds > 0 ? expansions / seconds : 0; }
+    };
+
+private:
+    /// Game to search, with the level loaded
+    Game* mGame;
+
+public:
+    LevelSolver(Game* game);
+
+    Result Solve(const Options& options);
+
+    static const wchar_t* ActionName(Action action);
+};
+
+#endif //LEVELSOLVER_H
@@ -49,9 +49,11 @@ void MainFrame::Initialize()
     auto fileMenu = new wxMenu();
     auto helpMenu = new wxMenu();
     auto levelMenu = new wxMenu();
+    auto viewMenu = new wxMenu();
     menuBar->Append(fileMenu, "File");
     menuBar->Append(helpMenu, "Help");
     menuBar->Append(levelMenu, "Levels");
+    menuBar->Append(viewMenu, "View");
 
     fileMenu->Append(wxID_EXIT, "&Exit\tAlt-X", "Quit this program");
     helpMenu->Append(wxID_ABOUT, "&About\tF1", "Show about dialog");
@@ -62,6 +64,24 @@ void MainFrame::Initialize()
     levelMenu->Append(IDM_LEVELONE, "&Level 1", "Level 1");
     levelMenu->Append(IDM_LEVELTWO, "&Level 2", "Level 2");
     levelMenu->Append(IDM_LEVELTHREE, "&Level 3", "Level 3");
+    levelMenu->AppendSeparator();
+    levelMenu->AppendCheckItem(IDM_TILEDTERRAIN, "&Tiled Terrain",
+                               "Keep platforms and walls on a tile map instead of as items");
+
+    viewMenu->AppendCheckItem(IDM_SOFTWARERENDERER, "&Software Renderer\tCtrl-G",
+                              "Composite sprites into a pixel buffer instead of the graphics context");
+    viewMenu->AppendCheckItem(IDM_MEMORYREPORT, "&Memory Report\tCtrl-M",
+                              "Show the memory the level uses");
+    viewMenu->Append(IDM_WRITETELEMETRY, "&Write Telemetry",
+                     "Write the gameplay counters to telemetry.json");
+    viewMenu->AppendSeparator();
+    viewMenu->AppendCheckItem(IDM_LOWLATENCY, "&Low Latency Input",
+                              "Read the keys at the start of each frame instead of in the timer");
+    viewMenu->Append(IDM_LATENCYREPORT, "&Input Latency Report",
+                     "Show the time from key presses to the frames that show them");
+    viewMenu->AppendSeparator();
+    viewMenu->AppendCheckItem(IDM_SIMULATIONTHREAD, "Simulation &Thread",
+                              "Run the game on its own thread instead of in the paint handler")->Check(true);
     SetMenuBar(menuBar);
 
     CreateStatusBar( 1, wxSTB_SIZEGRIP, wxID_ANY);
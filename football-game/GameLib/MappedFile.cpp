@@ -0,0 +1,118 @@
+/**
+ * @file MappedFile.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "MappedFile.h"
+
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Destructor
+ */
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+/**
+ * Map a file, closing any file already mapped
+ * @param filename File to map
+ * @return True if the file was mapped. Empty files cannot be.
+ */
+bool MappedFile::Open(const std::wstring& filename)
+{
+    Close();
+    std::filesystem::path path(filename);
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    }
+
+    // The mapping keeps the file open
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    mMapping = mapping;
+    mData = static_cast<unsigned char*>(data);
+    mSize = size_t(size.QuadPart);
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    void* data = MAP_FAILED;
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+    {
+        data = mmap(nullptr, size_t(status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    }
+
+    // The mapping keeps the file open
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mData = static_cast<unsigned char*>(data);
+    mSize = size_t(status.st_size);
+#endif
+
+    return true;
+}
+
+/**
+ * Unmap the file. Pointers into it are no longer valid.
+ */
+void MappedFile::Close()
+{
+    if (mData == nullptr)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mData);
+    CloseHandle(mMapping);
+    mMapping = nullptr;
+#else
+    munmap(mData, mSize);
+#endif
+
+    mData = nullptr;
+    mSize = 0;
+}
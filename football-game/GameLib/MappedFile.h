@@ -0,0 +1,71 @@
+/**
+ * @file MappedFile.h
+ * @author Brennan Eagle
+ *
+ * A file mapped into memory
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A file mapped into memory.
+ *
+ * The pages are read from the file as they are first touched, so
+ * opening a large file costs next to nothing, and a file read
+ * recently comes straight from the operating system's cache.
+ *
+ * The mapping is copy on write. Writes through GetData change
+ * only this process's copy of a page, never the file, which lets
+ * the data be handed to code that takes a non-const pointer.
+ */
+class MappedFile
+{
+private:
+    /// Start of the mapping, nullptr when not open
+    unsigned char* mData = nullptr;
+
+    /// Size of the file in bytes
+    size_t mSize = 0;
+
+#ifdef _WIN32
+    /// File mapping object handle
+    void* mMapping = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    /// Copy constructor (disabled)
+    MappedFile(const MappedFile &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const MappedFile &) = delete;
+
+    bool Open(const std::wstring& filename);
+    void Close();
+
+    /**
+     * Is a file mapped?
+     * @return True if Open succeeded and Close has not been called
+     */
+    bool IsOpen() const { return mData != nullptr; }
+
+    /**
+     * Get the mapped bytes
+     * @return Start of the file, nullptr when not open
+     */
+    unsigned char* GetData() const { return mData; }
+
+    /**
+     * Get the size of the mapped file
+     * @return Bytes, 0 when not open
+     */
+    size_t GetSize() const { return mSize; }
+};
+
+#endif //MAPPEDFILE_H
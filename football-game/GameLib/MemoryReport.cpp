@@ -0,0 +1,231 @@
+/**
+ * @file MemoryReport.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "MemoryReport.h"
+
+#include <algorithm>
+#include <sstream>
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+/**
+ * Add memory to a category
+ * @param category Category name
+ * @param bytes Bytes to add
+ */
+void MemoryReport::Add(const std::wstring& category, size_t bytes)
+{
+    mCategories[category] += bytes;
+}
+
+/**
+ * Add one item. Its bytes are also added to the items category.
+ * @param type Type name of the item
+ * @param bytes Bytes the item takes
+ */
+void MemoryReport::AddItem(const std::wstring& type, size_t bytes)
+{
+    auto& itemType = mItemTypes[type];
+    itemType.count++;
+    itemType.bytes += bytes;
+    Add(L"items", bytes);
+}
+
+/**
+ * Get the bytes in a category
+ * @param category Category name
+ * @return Bytes, 0 if nothing was added to the category
+ */
+size_t MemoryReport::GetBytes(const std::wstring& category) const
+{
+    auto found = mCategories.find(category);
+    return found != mCategories.end() ? found->second : 0;
+}
+
+/**
+ * Get the bytes in all categories
+ * @return Total bytes
+ */
+size_t MemoryReport::GetTotal() const
+{
+    size_t total = 0;
+    for (auto& category : mCategories)
+    {
+        total += category.second;
+    }
+    return total;
+}
+
+/**
+ * Get the number of items of every type
+ * @return Number of items
+ */
+size_t MemoryReport::GetItemCount() const
+{
+    size_t count = 0;
+    for (auto& itemType : mItemTypes)
+    {
+        count += itemType.second.count;
+    }
+    return count;
+}
+
+/**
+ * Get the report as lines of text, for display
+ * @return Lines of the report
+ */
+std::vector<std::wstring> MemoryReport::ToLines() const
+{
+    std::vector<std::wstring> lines;
+    auto kb = [](size_t bytes) { return wxString::Format(L"%.1f KB", bytes / 1024.0).ToStdWstring(); };
+
+    lines.push_back(L"Memory " + kb(GetTotal()));
+    for (auto& category : mCategories)
+    {
+        lines.push_back(L"  " + category.first + L": " + kb(category.second));
+    }
+
+    lines.push_back(L"Items " + std::to_wstring(GetItemCount()));
+    for (auto& itemType : mItemTypes)
+    {
+        lines.push_back(L"  " + itemType.first + L": " + std::to_wstring(itemType.second.count) +
+                        L", " + kb(itemType.second.bytes));
+    }
+    return lines;
+}
+
+/**
+ * Write a string as a JSON string. Names here are identifiers,
+ * so only quotes, backslashes and control characters need care.
+ * @param out Stream to write to
+ * @param text Text to write
+ */
+static void WriteJsonString(std::ostringstream& out, const std::wstring& text)
+{
+    out << '"';
+    for (wchar_t c : text)
+    {
+        if (c == L'"' || c == L'\\')
+        {
+            out << '\\' << char(c);
+        }
+        else if (c < 0x20 || c > 0x7e)
+        {
+            out << "\\u" << std::hex;
+            out.width(4);
+            out.fill('0');
+            out << unsigned(c) << std::dec;
+        }
+        else
+        {
+            out << char(c);
+        }
+    }
+    out << '"';
+}
+
+/**
+ * Get the report as JSON
+ * @return JSON object with the total, categories and item types
+ */
+std::string MemoryReport::ToJson() const
+{
+    std::ostringstream out;
+    out << "{\"total\":" << GetTotal() << ",\"categories\":{";
+
+    bool first = true;
+    for (auto& category : mCategories)
+    {
+        out << (first ? "" : ",");
+        WriteJsonString(out, category.first);
+        out << ':' << category.second;
+        first = false;
+    }
+
+    out << "},\"items\":{";
+    first = true;
+    for (auto& itemType : mItemTypes)
+    {
+        out << (first ? "" : ",");
+        WriteJsonString(out, itemType.first);
+        out << ":{\"count\":" << itemType.second.count << ",\"bytes\":" << itemType.second.bytes << '}';
+        first = false;
+    }
+    out << "}}";
+    return out.str();
+}
+
+/**
+ * Draw the report as an overlay
+ * @param gc Graphics context in device pixels
+ * @param x Left edge of the overlay
+ * @param y Top edge of the overlay
+ */
+void MemoryReport::Draw(std::shared_ptr<wxGraphicsContext> gc, double x, double y) const
+{
+    auto lines = ToLines();
+
+    gc->PushState();
+    gc->SetTransform(gc->CreateMatrix());
+
+    wxFont font(wxSize(0, 14), wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    gc->SetFont(font, *wxWHITE);
+
+    double width = 0;
+    double lineHeight = 0;
+    for (auto& line : lines)
+    {
+        double w, h;
+        gc->GetTextExtent(line, &w, &h);
+        width = std::max(width, w);
+        lineHeight = std::max(lineHeight, h);
+    }
+
+    gc->SetBrush(wxBrush(wxColour(0, 0, 0, 160)));
+    gc->SetPen(*wxTRANSPARENT_PEN);
+    gc->DrawRectangle(x, y, width + 10, lineHeight * lines.size() + 10);
+
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+        gc->DrawText(lines[i], x + 5, y + 5 + lineHeight * i);
+    }
+
+    gc->PopState();
+}
+
+/**
+ * Get a readable name for a type
+ * @param type Type information, usually typeid(*item)
+ * @return Class name without decoration
+ */
+std::wstring MemoryReport::TypeName(const std::type_info& type)
+{
+    std::string name = type.name();
+
+#if defined(__GNUC__) || defined(__clang__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr)
+    {
+        name = demangled;
+    }
+    std::free(demangled);
+#else
+    // MSVC names are "class Platform"
+    for (const char* prefix : {"class ", "struct "})
+    {
+        if (name.rfind(prefix, 0) == 0)
+        {
+            name = name.substr(std::char_traits<char>::length(prefix));
+        }
+    }
+#endif
+
+    return std::wstring(name.begin(), name.end());
+}
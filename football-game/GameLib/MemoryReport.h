@@ -0,0 +1,71 @@
+/**
+ * @file MemoryReport.h
+ * @author Brennan Eagle
+ *
+ * Memory a game uses, by category and by item type
+ */
+
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+/**
+ * Memory a game uses, by category and by item type.
+ *
+ * Sizes are estimates: objects are counted at their own size,
+ * vectors at their capacity and images at 32 bits per pixel.
+ * Allocator overhead and the memory inside wxWidgets objects
+ * are not counted.
+ */
+class MemoryReport
+{
+public:
+    /// Items of one type
+    struct ItemType
+    {
+        /// Number of items
+        size_t count = 0;
+        /// Bytes the items take
+        size_t bytes = 0;
+    };
+
+private:
+    /// Bytes by category
+    std::map<std::wstring, size_t> mCategories;
+
+    /// Items by type name
+    std::map<std::wstring, ItemType> mItemTypes;
+
+public:
+    void Add(const std::wstring& category, size_t bytes);
+    void AddItem(const std::wstring& type, size_t bytes);
+
+    size_t GetBytes(const std::wstring& category) const;
+    size_t GetTotal() const;
+    size_t GetItemCount() const;
+
+    /**
+     * Get the bytes by category
+     * @return Bytes by category name
+     */
+    const std::map<std::wstring, size_t>& GetCategories() const { return mCategories; }
+
+    /**
+     * Get the items by type
+     * @return Count and bytes by type name
+     */
+    const std::map<std::wstring, ItemType>& GetItemTypes() const { return mItemTypes; }
+
+    std::vector<std::wstring> ToLines() const;
+    std::string ToJson() const;
+    void Draw(std::shared_ptr<wxGraphicsContext> gc, double x, double y) const;
+
+    static std::wstring TypeName(const std::type_info& type);
+};
+
+#endif //MEMORYREPORT_H
@@ -7,6 +7,7 @@
 #include "pch.h"
 #include "CollisionVisitor.h"
 #include "MovingPlatform.h"
+#include "Game.h"
 
 
 /**
@@ -14,7 +15,16 @@
  * @param game Game this platform is in
  * @param filename Image file for this platform segment
  */
-MovingPlatform::MovingPlatform(Game* game, const std::wstring& filename) : Platform(game, filename)
+MovingPlatform::MovingPlatform(Game* game, const std::wstring& filename) : ItemOf(game, filename)
+{
+}
+
+/**
+ * Constructor
+ * @param game Game this platform is in
+ * @param archetype Archetype for this platform segment
+ */
+MovingPlatform::MovingPlatform(Game* game, const ItemArchetype* archetype) : ItemOf(game, archetype)
 {
 }
 
@@ -38,13 +48,42 @@ void MovingPlatform::SetMotion(double cx, double cy, double radius, double omega
     mOmega = omega;
 }
 
-void MovingPlatform::Update(double elapsed)
+/**
+ * Compute the platform position directly from the level clock.
+ * The motion is a circle, so the angle is just omega * time and
+ * nothing depends on how often we were updated before.
+ * @param time Level time in seconds
+ * @return Platform center at that time
+ */
+wxPoint2DDouble MovingPlatform::PositionAt(double time) const
 {
-    mAngle += mOmega*elapsed;
+    double angle = mOmega*time;
 
     //Circle position
-    double px = mCenterX + std::cos(mAngle)*mRadius;
-    double py = mCenterY + std::sin(mAngle)*mRadius;
+    double px = mCenterX + std::cos(angle)*mRadius;
+    double py = mCenterY + std::sin(angle)*mRadius;
 
-    SetLocation(px,py);
+    return wxPoint2DDouble(px, py);
+}
+
+/**
+ * Updates the position of the platform to match the level clock
+ * @param elapsed Elapsed time
+ */
+void MovingPlatform::Update(double elapsed)
+{
+    auto position = PositionAt(mGame->GetLevelTime());
+    SetLocation(position.m_x, position.m_y);
+}
+
+/**
+ * Move the platform and the center of its circle
+ * @param dx Distance to move in X
+ * @param dy Distance to move in Y
+ */
+void MovingPlatform::MoveBy(double dx, double dy)
+{
+    Platform::MoveBy(dx, dy);
+    mCenterX += dx;
+    mCenterY += dy;
 }
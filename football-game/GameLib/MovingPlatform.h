@@ -10,7 +10,7 @@
 #include "Platform.h"
 
 
-class MovingPlatform : public Platform
+class MovingPlatform : public ItemOf<MovingPlatform, Platform>
 {
 private:
     // The radius of the moving platform
@@ -21,8 +21,6 @@ private:
     double mCenterY = 0;
     // The speed in radians per second
     double mOmega = 1;
-    // The current angle
-    double mAngle = 0;
 public:
     /// Default constructor (disabled)
     MovingPlatform() = delete;
@@ -39,6 +37,13 @@ public:
      */
     MovingPlatform(Game* game, const std::wstring& filename);
 
+    /**
+     * Constructor
+     * @param game Game this platform is in
+     * @param archetype Archetype for this platform segment
+     */
+    MovingPlatform(Game* game, const ItemArchetype* archetype);
+
     /**
      * Accept a collision visitor
      * @param visitor The collision visitor
@@ -54,12 +59,38 @@ public:
      */
     void SetMotion(double cx, double cy, double radius, double omega);
 
+    /// Get the x of the center of the circle the platform moves on
+    double GetCenterX() const { return mCenterX; }
+    /// Get the y of the center of the circle the platform moves on
+    double GetCenterY() const { return mCenterY; }
+    /// Get the radius of the circle the platform moves on
+    double GetRadius() const { return mRadius; }
+
+    /**
+     * Move the platform and the center of its circle
+     * @param dx Distance to move in X
+     * @param dy Distance to move in Y
+     */
+    void MoveBy(double dx, double dy) override;
+
+    /**
+     * Compute where the platform is at a point on the level clock
+     * @param time Level time in seconds
+     * @return Platform center at that time
+     */
+    wxPoint2DDouble PositionAt(double time) const;
+
     /**
      * Updates the position of the moving platform
      * @param elapsed Elapsed time
      */
     void Update(double elapsed) override;
 
+    /**
+     * Moving platforms are always moving
+     * @return true
+     */
+    bool IsDynamic() const override { return true; }
 };
 
 
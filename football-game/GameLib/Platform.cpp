@@ -12,7 +12,16 @@
  * @param game Game this platform is in
  * @param filename Image file for this platform segment
  */
-Platform::Platform(Game* game, const std::wstring& filename) : Item(game, filename)
+Platform::Platform(Game* game, const std::wstring& filename) : ItemOf(game, filename, CollisionClass::Terrain)
+{
+}
+
+/**
+ * Constructor
+ * @param game Game this platform is in
+ * @param archetype Archetype for this platform segment
+ */
+Platform::Platform(Game* game, const ItemArchetype* archetype) : ItemOf(game, archetype)
 {
 }
 
@@ -12,7 +12,7 @@
 
 class CollisionVisitor;
 
-class Platform : public Item {
+class Platform : public ItemOf<Platform> {
 public:
     /// Default constructor (disabled)
     Platform() = delete;
@@ -30,12 +30,18 @@ public:
      */
     Platform(Game* game, const std::wstring& filename);
 
+    /**
+     * Constructor
+     * @param game Game this platform is in
+     * @param archetype Archetype for this platform segment
+     */
+    Platform(Game* game, const ItemArchetype* archetype);
+
     /**
      * Accept a collision visitor
      * @param visitor The collision visitor
      */
     void Accept(CollisionVisitor* visitor) override;
-
 };
 
 
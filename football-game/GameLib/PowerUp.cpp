@@ -9,6 +9,7 @@
 
 #include "CollisionVisitor.h"
 #include "Game.h"
+#include "GameSnapshot.h"
 
 using namespace std;
 
@@ -19,7 +20,7 @@ const wstring PowerUpImage = L"images/sparty.png";
  * Constructor
  * @param game and image
  */
-PowerUp::PowerUp(Game *game) : Item(game, PowerUpImage)
+PowerUp::PowerUp(Game *game) : ItemOf(game, PowerUpImage, CollisionClass::Pickup)
 {
 
 }
@@ -73,3 +74,25 @@ bool PowerUp::ShouldRemove(const Game* game) const
     // Remove once off the bottom of the screen
     return GetY() - GetHeight() / 2 > game->GetHeight();
 }
+
+/**
+ * Save activation and fall speed to a snapshot
+ * @param snapshot Snapshot to write to
+ */
+void PowerUp::SaveState(GameSnapshot& snapshot) const
+{
+    Item::SaveState(snapshot);
+    snapshot.Write(mActivated);
+    snapshot.Write(mVy);
+}
+
+/**
+ * Load activation and fall speed from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void PowerUp::LoadState(GameSnapshot& snapshot)
+{
+    Item::LoadState(snapshot);
+    snapshot.Read(mActivated);
+    snapshot.Read(mVy);
+}
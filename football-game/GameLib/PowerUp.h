@@ -10,7 +10,7 @@
 #include "Item.h"
 
 
-class PowerUp : public Item
+class PowerUp : public ItemOf<PowerUp>
 {
 private:
     ///is powerup activated?
@@ -37,8 +37,26 @@ public:
     wxXmlNode* XmlSave(wxXmlNode* node) override;
     void Accept(CollisionVisitor* visitor) override;
     void Update(double elapsed) override;
+    /**
+     * A power-up only moves once it has been activated
+     * @return True if activated
+     */
+    bool IsDynamic() const override { return mActivated; }
+    /**
+     * A power-up falls away once it is activated
+     * @return True
+     */
+    bool CanMove() const override { return true; }
+    /**
+     * An activated power-up falls until it is removed, so it
+     * is not left hanging where the view last saw it
+     * @return True if activated
+     */
+    bool StaysAwake() const override { return mActivated; }
     bool TryActivate() { if (mActivated) return false; mActivated = true; return true; }
     bool ShouldRemove(const Game* game) const override;
+    void SaveState(GameSnapshot& snapshot) const override;
+    void LoadState(GameSnapshot& snapshot) override;
 };
 
 
@@ -0,0 +1,111 @@
+/**
+ * @file RenderState.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "RenderState.h"
+#include "ScaledBitmapCache.h"
+#include "SoftwareRenderer.h"
+
+#include <cmath>
+
+/**
+ * Remove everything, keeping the memory for the next capture
+ */
+void RenderState::Clear()
+{
+    mSprites.clear();
+    mTexts.clear();
+}
+
+/**
+ * Add a sprite, drawn over those added before it
+ * @param archetype Archetype the bitmap comes from
+ * @param left Left edge in virtual pixels
+ * @param top Top edge in virtual pixels
+ * @param width Width in virtual pixels
+ * @param height Height in virtual pixels
+ */
+void RenderState::AddSprite(const ItemArchetype* archetype, double left, double top, double width, double height)
+{
+    mSprites.push_back({archetype, left, top, width, height});
+}
+
+/**
+ * Add a floating text
+ * @param text What it says
+ * @param x Left in virtual pixels
+ * @param y Top in virtual pixels
+ * @param red Red component
+ * @param green Green component
+ * @param blue Blue component
+ * @param alpha Opacity
+ */
+void RenderState::AddText(const wxString& text, double x, double y, uint8_t red, uint8_t green, uint8_t blue,
+                          uint8_t alpha)
+{
+    mTexts.push_back({text, x, y, red, green, blue, alpha});
+}
+
+/**
+ * Draw the sprites and floating texts, as the game draws its
+ * items. The scoreboard and messages are left to the view.
+ * @param gc Graphics context
+ * @param bitmaps Bitmaps at the display scale
+ * @param renderer Software renderer, used if the game was
+ * @param width Width of the window in pixels
+ * @param height Height of the window in pixels
+ */
+void RenderState::Draw(std::shared_ptr<wxGraphicsContext> gc, ScaledBitmapCache& bitmaps,
+                       SoftwareRenderer& renderer, int width, int height) const
+{
+    const double scale = double(height) / mHeight;
+
+    if (mSoftwareRendering)
+    {
+        renderer.SetScale(scale);
+        renderer.Begin(width, height);
+        for (auto& sprite : mSprites)
+        {
+            auto pixels = renderer.GetSprite(sprite.archetype);
+            if (pixels != nullptr)
+            {
+                renderer.Blit(*pixels, int(std::lround((sprite.left - mOffset) * scale)),
+                              int(std::lround(sprite.top * scale)));
+            }
+        }
+        renderer.Present(gc);
+    }
+    else
+    {
+        bitmaps.SetScale(scale);
+        for (auto& sprite : mSprites)
+        {
+            auto bitmap = bitmaps.Get(sprite.archetype);
+            if (bitmap == nullptr)
+            {
+                continue;
+            }
+
+            const double x = sprite.left - mOffset;
+            const double left = std::round(x * scale);
+            const double top = std::round(sprite.top * scale);
+            const double right = std::round((x + sprite.width) * scale);
+            const double bottom = std::round((sprite.top + sprite.height) * scale);
+            gc->DrawBitmap(*bitmap, left, top, right - left, bottom - top);
+        }
+    }
+
+    gc->PushState();
+    gc->Scale(scale, scale);
+
+    wxFont font(wxSize(0, 24), wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
+    for (auto& text : mTexts)
+    {
+        gc->SetFont(font, wxColour(text.red, text.green, text.blue, text.alpha));
+        gc->DrawText(text.text, text.x - mOffset, text.y);
+    }
+
+    gc->PopState();
+}
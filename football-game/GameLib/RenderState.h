@@ -0,0 +1,212 @@
+/**
+ * @file RenderState.h
+ * @author Brennan Eagle
+ *
+ * Everything needed to draw one frame of the game
+ */
+
+#ifndef RENDERSTATE_H
+#define RENDERSTATE_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct ItemArchetype;
+class ScaledBitmapCache;
+class SoftwareRenderer;
+
+/**
+ * Everything needed to draw one frame of the game.
+ *
+ * When the game runs on its own thread, the view cannot look at
+ * the game while it draws. After each tick the game captures what
+ * is in view into a render state instead: each sprite's archetype
+ * and box, the floating texts, and the values the scoreboard and
+ * messages show. The view draws the latest state it was handed,
+ * exactly as the game would have drawn itself.
+ *
+ * A state is cleared and refilled for each tick, so its vectors
+ * keep their memory. Colours are kept as bytes, so no wxWidgets
+ * GDI object is made on the game's thread.
+ */
+class RenderState
+{
+public:
+    /// An item or tile to draw
+    struct Sprite
+    {
+        const ItemArchetype* archetype; ///< Archetype the bitmap comes from
+        double left;                    ///< Left edge in virtual pixels
+        double top;                     ///< Top edge in virtual pixels
+        double width;                   ///< Width in virtual pixels
+        double height;                  ///< Height in virtual pixels
+    };
+
+    /// A floating text to draw
+    struct Text
+    {
+        wxString text;  ///< What it says
+        double x;       ///< Left in virtual pixels
+        double y;       ///< Top in virtual pixels
+        uint8_t red;    ///< Red component
+        uint8_t green;  ///< Green component
+        uint8_t blue;   ///< Blue component
+        uint8_t alpha;  ///< Opacity, faded as the text ages
+    };
+
+    /// Clock the tick times are taken from
+    using Clock = std::chrono::steady_clock;
+
+private:
+    /// Sprites in drawing order
+    std::vector<Sprite> mSprites;
+
+    /// Floating texts
+    std::vector<Text> mTexts;
+
+    /// Scroll offset in virtual pixels
+    double mOffset = 0;
+
+    /// Height of the level in virtual pixels
+    double mHeight = 1024;
+
+    /// Draw with the software renderer?
+    bool mSoftwareRendering = false;
+
+    /// Level time in milliseconds
+    long mTime = 0;
+
+    /// Score
+    int mScore = 0;
+
+    /// Message shown over the game
+    std::wstring mMessage;
+
+    /// Level message shown in the center
+    std::wstring mLevelMessage;
+
+    /// Number of the tick captured, counting from 1
+    uint64_t mTick = 0;
+
+    /// Number of inputs the game had been given by the tick
+    uint64_t mInputs = 0;
+
+    /// When the tick ran
+    Clock::time_point mTickTime;
+
+public:
+    void Clear();
+    void AddSprite(const ItemArchetype* archetype, double left, double top, double width, double height);
+    void AddText(const wxString& text, double x, double y, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha);
+    void Draw(std::shared_ptr<wxGraphicsContext> gc, ScaledBitmapCache& bitmaps, SoftwareRenderer& renderer,
+              int width, int height) const;
+
+    /**
+     * Get the sprites
+     * @return Sprites in drawing order
+     */
+    const std::vector<Sprite>& GetSprites() const { return mSprites; }
+
+    /**
+     * Get the floating texts
+     * @return Texts
+     */
+    const std::vector<Text>& GetTexts() const { return mTexts; }
+
+    /**
+     * Set the view
+     * @param offset Scroll offset in virtual pixels
+     * @param height Height of the level in virtual pixels
+     * @param software Draw with the software renderer?
+     */
+    void SetView(double offset, double height, bool software)
+    {
+        mOffset = offset;
+        mHeight = height;
+        mSoftwareRendering = software;
+    }
+
+    /**
+     * Get the scroll offset
+     * @return Offset in virtual pixels
+     */
+    double GetOffset() const { return mOffset; }
+
+    /**
+     * Set the scoreboard values
+     * @param time Level time in milliseconds
+     * @param score Score
+     */
+    void SetScoreboard(long time, int score) { mTime = time; mScore = score; }
+
+    /**
+     * Get the level time
+     * @return Milliseconds
+     */
+    long GetTime() const { return mTime; }
+
+    /**
+     * Get the score
+     * @return Score
+     */
+    int GetScore() const { return mScore; }
+
+    /**
+     * Set the messages
+     * @param message Message shown over the game
+     * @param levelMessage Level message shown in the center
+     */
+    void SetMessages(const std::wstring& message, const std::wstring& levelMessage)
+    {
+        mMessage = message;
+        mLevelMessage = levelMessage;
+    }
+
+    /**
+     * Get the message shown over the game
+     * @return Message, empty for none
+     */
+    const std::wstring& GetMessage() const { return mMessage; }
+
+    /**
+     * Get the level message
+     * @return Message, empty for none
+     */
+    const std::wstring& GetLevelMessage() const { return mLevelMessage; }
+
+    /**
+     * Set the tick the state was captured at
+     * @param tick Number of the tick, counting from 1
+     * @param inputs Number of inputs the game had been given
+     * @param time When the tick ran
+     */
+    void SetTick(uint64_t tick, uint64_t inputs, Clock::time_point time)
+    {
+        mTick = tick;
+        mInputs = inputs;
+        mTickTime = time;
+    }
+
+    /**
+     * Get the tick the state was captured at
+     * @return Tick number, 0 if none has been captured
+     */
+    uint64_t GetTick() const { return mTick; }
+
+    /**
+     * Get the number of inputs the game had been given
+     * @return Inputs applied by the tick
+     */
+    uint64_t GetInputs() const { return mInputs; }
+
+    /**
+     * Get when the tick ran
+     * @return Tick time
+     */
+    Clock::time_point GetTickTime() const { return mTickTime; }
+};
+
+#endif //RENDERSTATE_H
@@ -0,0 +1,275 @@
+/**
+ * @file RewindBuffer.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "RewindBuffer.h"
+#include "Item.h"
+
+#include <algorithm>
+#include <cstring>
+
+/**
+ * Constructor
+ * @param seconds Seconds of play to keep
+ * @param frames Most ticks to keep, which bounds the memory used
+ */
+RewindBuffer::RewindBuffer(double seconds, int frames) :
+    mHistory(seconds), mFrames(frames > 0 ? frames : 1)
+{
+}
+
+/**
+ * Forget the history and take the current state as the
+ * starting point. Call whenever the roster is rebuilt or the
+ * game jumps to a state that was not captured.
+ * @param roster Items of the level by roster index
+ * @param globals Current global values
+ */
+void RewindBuffer::Reset(const std::vector<std::shared_ptr<Item>>& roster, const GameSnapshot& globals)
+{
+    mFirst = 0;
+    mCount = 0;
+    mDuration = 0;
+    mPendingRemovals.clear();
+
+    mGlobals = globals.GetData();
+
+    mStates.clear();
+    mOffsets.clear();
+    for (auto& item : roster)
+    {
+        mScratch.Clear();
+        item->SaveState(mScratch);
+        mOffsets.push_back(mStates.size());
+        mStates.insert(mStates.end(), mScratch.GetData().begin(), mScratch.GetData().end());
+    }
+    mOffsets.push_back(mStates.size());
+}
+
+/**
+ * Record that an item was removed from the game
+ * @param rosterIndex Roster index of the item
+ * @param position Where the item was in the game's item list
+ */
+void RewindBuffer::LogRemoval(int rosterIndex, int position)
+{
+    if (rosterIndex >= 0)
+    {
+        mPendingRemovals.emplace_back(rosterIndex, position);
+    }
+}
+
+/**
+ * Get a frame for a new tick, dropping the oldest
+ * frame if the ring is full
+ * @return Empty frame at the new end of the ring
+ */
+RewindBuffer::Frame& RewindBuffer::NewFrame()
+{
+    const int size = int(mFrames.size());
+    if (mCount == size)
+    {
+        mDuration -= mFrames[mFirst].elapsed;
+        mFirst = (mFirst + 1) % size;
+        mCount--;
+    }
+
+    Frame& frame = mFrames[(mFirst + mCount) % size];
+    mCount++;
+
+    frame.elapsed = 0;
+    frame.changes = 0;
+    frame.removals = 0;
+    frame.data.Clear();
+    return frame;
+}
+
+/**
+ * Capture the tick that just ran.
+ *
+ * Only dynamic items are compared with their last captured
+ * state, and only the ones that changed are recorded.
+ *
+ * @param elapsed Time covered by the tick in seconds
+ * @param roster Items of the level by roster index
+ * @param globals Current global values
+ */
+void RewindBuffer::Capture(double elapsed, const std::vector<std::shared_ptr<Item>>& roster, const GameSnapshot& globals)
+{
+    mAll.resize(roster.size());
+    for (size_t i = 0; i < roster.size(); i++)
+    {
+        mAll[i] = int(i);
+    }
+    Capture(elapsed, roster, globals, mAll);
+}
+
+/**
+ * Capture the tick that just ran, when only some items may have changed.
+ *
+ * Items not in the list must be as they were last captured. The
+ * game passes the items it updated and the items the football
+ * touched, so a tick costs nothing for the rest of the level.
+ *
+ * @param elapsed Time covered by the tick in seconds
+ * @param roster Items of the level by roster index
+ * @param globals Current global values
+ * @param changed Roster indices of the items that may have changed, in order
+ */
+void RewindBuffer::Capture(double elapsed, const std::vector<std::shared_ptr<Item>>& roster,
+        const GameSnapshot& globals, const std::vector<int>& changed)
+{
+    if (roster.size() + 1 != mOffsets.size())
+    {
+        // Not reset for this roster, nothing to compare against
+        Reset(roster, globals);
+        return;
+    }
+
+    Frame& frame = NewFrame();
+    frame.elapsed = elapsed;
+    mDuration += elapsed;
+
+    // Globals are small and change every tick
+    frame.data.WriteBytes(mGlobals.data(), mGlobals.size());
+    mGlobals = globals.GetData();
+
+    for (int i : changed)
+    {
+        if (i < 0 || i >= int(roster.size()))
+        {
+            continue;
+        }
+
+        auto& item = roster[i];
+        if (!item->IsDynamic())
+        {
+            continue;
+        }
+
+        mScratch.Clear();
+        item->SaveState(mScratch);
+
+        char* last = mStates.data() + mOffsets[i];
+        const size_t size = mOffsets[i + 1] - mOffsets[i];
+        if (mScratch.GetSize() != size || std::memcmp(last, mScratch.GetData().data(), size) == 0)
+        {
+            continue;
+        }
+
+        frame.data.Write(i);
+        frame.data.WriteBytes(last, size);
+        std::memcpy(last, mScratch.GetData().data(), size);
+        frame.changes++;
+    }
+
+    for (auto& removal : mPendingRemovals)
+    {
+        frame.data.Write(removal.first);
+        frame.data.Write(removal.second);
+        frame.removals++;
+    }
+    mPendingRemovals.clear();
+
+    // Forget what is older than the history we keep
+    while (mCount > 1 && mDuration - mFrames[mFirst].elapsed >= mHistory)
+    {
+        mDuration -= mFrames[mFirst].elapsed;
+        mFirst = (mFirst + 1) % int(mFrames.size());
+        mCount--;
+    }
+}
+
+/**
+ * Undo the newest tick.
+ * @param roster Items of the level by roster index
+ * @param items The game's item list, removed items are put back
+ * @param globals Receives the global values from before the tick
+ * @return True if there was a tick to undo
+ */
+bool RewindBuffer::StepBack(const std::vector<std::shared_ptr<Item>>& roster,
+        std::vector<std::shared_ptr<Item>>& items, GameSnapshot& globals)
+{
+    if (mCount == 0 || roster.size() + 1 != mOffsets.size())
+    {
+        return false;
+    }
+
+    mCount--;
+    Frame& frame = mFrames[(mFirst + mCount) % int(mFrames.size())];
+    mDuration -= frame.elapsed;
+    if (mCount == 0)
+    {
+        mDuration = 0;
+    }
+
+    GameSnapshot& data = frame.data;
+    data.Rewind();
+
+    const char* previous = data.ReadBytes(mGlobals.size());
+    if (previous != nullptr)
+    {
+        mGlobals.assign(previous, previous + mGlobals.size());
+    }
+    globals.Clear();
+    globals.WriteBytes(mGlobals.data(), mGlobals.size());
+
+    for (int c = 0; c < frame.changes; c++)
+    {
+        int index = -1;
+        data.Read(index);
+        if (index < 0 || index >= int(roster.size()))
+        {
+            break;
+        }
+
+        const size_t size = mOffsets[index + 1] - mOffsets[index];
+        const char* state = data.ReadBytes(size);
+        if (state == nullptr)
+        {
+            break;
+        }
+
+        std::memcpy(mStates.data() + mOffsets[index], state, size);
+        mScratch.Clear();
+        mScratch.WriteBytes(state, size);
+        roster[index]->LoadState(mScratch);
+    }
+
+    // Removals go back in the reverse order they happened,
+    // which puts every item back at its old place in the list
+    std::vector<std::pair<int, int>> removals(frame.removals);
+    for (auto& removal : removals)
+    {
+        data.Read(removal.first);
+        data.Read(removal.second);
+    }
+    for (auto removal = removals.rbegin(); removal != removals.rend(); ++removal)
+    {
+        if (removal->first < 0 || removal->first >= int(roster.size()))
+        {
+            continue;
+        }
+        auto position = std::min<size_t>(size_t(std::max(removal->second, 0)), items.size());
+        items.insert(items.begin() + position, roster[removal->first]);
+    }
+
+    mPendingRemovals.clear();
+    return true;
+}
+
+/**
+ * Get the memory held by the buffer
+ * @return Bytes reserved for frames and captured states
+ */
+size_t RewindBuffer::GetMemoryUsed() const
+{
+    size_t bytes = mGlobals.capacity() + mStates.capacity() + mOffsets.capacity() * sizeof(size_t);
+    for (auto& frame : mFrames)
+    {
+        bytes += sizeof(Frame) + frame.data.GetData().capacity();
+    }
+    return bytes;
+}
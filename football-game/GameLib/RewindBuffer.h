@@ -0,0 +1,111 @@
+/**
+ * @file RewindBuffer.h
+ * @author Brennan Eagle
+ *
+ * Bounded history of recent game states for rewinding
+ */
+
+#ifndef REWINDBUFFER_H
+#define REWINDBUFFER_H
+
+#include <memory>
+#include <vector>
+#include "GameSnapshot.h"
+
+class Item;
+
+/**
+ * Bounded history of recent game states for rewinding.
+ *
+ * Each tick is captured as an undo record: the previous state
+ * of the global values and of each dynamic item whose state
+ * changed during the tick, plus the items removed during the
+ * tick. Items that did not change cost nothing. Stepping back
+ * applies the newest record, which puts the game exactly where
+ * it was one tick earlier.
+ *
+ * Records live in a fixed ring of frames whose memory is reused,
+ * so capturing does not allocate once the ring has warmed up.
+ * The oldest frames are dropped when the ring is full or when
+ * they are older than the history length.
+ */
+class RewindBuffer
+{
+private:
+    /// Undo record for one tick
+    struct Frame
+    {
+        /// Time covered by the tick in seconds
+        double elapsed = 0;
+        /// Number of item states in the record
+        int changes = 0;
+        /// Number of removals in the record
+        int removals = 0;
+        /// Previous globals, item states and removals
+        GameSnapshot data;
+    };
+
+    /// Seconds of play kept
+    double mHistory;
+
+    /// Ring of frames
+    std::vector<Frame> mFrames;
+    /// Index of the oldest frame
+    int mFirst = 0;
+    /// Number of frames in use
+    int mCount = 0;
+    /// Seconds of play in the frames in use
+    double mDuration = 0;
+
+    /// Last captured state of the globals
+    std::vector<char> mGlobals;
+    /// Last captured state of every roster item, back to back
+    std::vector<char> mStates;
+    /// Where each roster item's state starts in mStates
+    std::vector<size_t> mOffsets;
+
+    /// Removals since the last capture, as roster index and list position
+    std::vector<std::pair<int, int>> mPendingRemovals;
+
+    /// Scratch space for serializing one item
+    GameSnapshot mScratch;
+
+    /// Every roster index, for capturing every item
+    std::vector<int> mAll;
+
+    Frame& NewFrame();
+
+public:
+    RewindBuffer(double seconds = 10, int frames = 1200);
+
+    void Reset(const std::vector<std::shared_ptr<Item>>& roster, const GameSnapshot& globals);
+    void Capture(double elapsed, const std::vector<std::shared_ptr<Item>>& roster, const GameSnapshot& globals);
+    void Capture(double elapsed, const std::vector<std::shared_ptr<Item>>& roster,
+            const GameSnapshot& globals, const std::vector<int>& changed);
+    bool StepBack(const std::vector<std::shared_ptr<Item>>& roster,
+            std::vector<std::shared_ptr<Item>>& items, GameSnapshot& globals);
+
+    void LogRemoval(int rosterIndex, int position);
+
+    /**
+     * Can we step back?
+     * @return True if there is at least one frame to undo
+     */
+    bool CanStepBack() const { return mCount > 0; }
+
+    /**
+     * Get the number of ticks that can be undone
+     * @return Number of frames in use
+     */
+    int GetFrameCount() const { return mCount; }
+
+    /**
+     * Get the seconds of play that can be undone
+     * @return Seconds covered by the frames in use
+     */
+    double GetDuration() const { return mDuration; }
+
+    size_t GetMemoryUsed() const;
+};
+
+#endif //REWINDBUFFER_H
@@ -0,0 +1,70 @@
+/**
+ * @file ScaledBitmapCache.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "ScaledBitmapCache.h"
+#include "ItemArchetype.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Set the scale to draw at. Changing it drops every bitmap.
+ * @param scale Device pixels per virtual pixel
+ */
+void ScaledBitmapCache::SetScale(double scale)
+{
+    if (scale != mScale)
+    {
+        mScale = scale;
+        mBitmaps.clear();
+    }
+}
+
+/**
+ * Get the bitmap for an archetype at the current scale
+ * @param archetype Archetype to draw
+ * @return Bitmap at its size on the screen, nullptr if there is nothing to draw
+ */
+const wxBitmap* ScaledBitmapCache::Get(const ItemArchetype* archetype)
+{
+    auto found = mBitmaps.find(archetype);
+    if (found != mBitmaps.end())
+    {
+        return found->second.get();
+    }
+
+    std::unique_ptr<wxBitmap> bitmap;
+    if (archetype->bitmap && archetype->bitmap->IsOk())
+    {
+        int width = std::max(1, int(std::lround(archetype->width * mScale)));
+        int height = std::max(1, int(std::lround(archetype->height * mScale)));
+
+        auto image = archetype->bitmap->ConvertToImage();
+        bitmap = std::make_unique<wxBitmap>(image.Scale(width, height, wxIMAGE_QUALITY_HIGH));
+        mResamples++;
+    }
+
+    auto result = bitmap.get();
+    mBitmaps[archetype] = std::move(bitmap);
+    return result;
+}
+
+/**
+ * Get the memory the resampled bitmaps take, at 32 bits per pixel
+ * @return Bytes of bitmaps
+ */
+size_t ScaledBitmapCache::GetMemoryUsed() const
+{
+    size_t bytes = 0;
+    for (auto& entry : mBitmaps)
+    {
+        if (entry.second)
+        {
+            bytes += size_t(entry.second->GetWidth()) * entry.second->GetHeight() * 4;
+        }
+    }
+    return bytes;
+}
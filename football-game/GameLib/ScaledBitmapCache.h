@@ -0,0 +1,66 @@
+/**
+ * @file ScaledBitmapCache.h
+ * @author Brennan Eagle
+ *
+ * Item bitmaps resampled to the current display scale
+ */
+
+#ifndef SCALEDBITMAPCACHE_H
+#define SCALEDBITMAPCACHE_H
+
+#include <memory>
+#include <unordered_map>
+
+struct ItemArchetype;
+
+/**
+ * Item bitmaps resampled to the current display scale.
+ *
+ * Drawing a bitmap through a scaled graphics context resamples
+ * it on every draw. This keeps one copy of each archetype's
+ * bitmap already at its size on the screen, so items can be
+ * drawn one to one. The copies are made the first time an
+ * archetype is drawn at a scale, and all of them are dropped
+ * when the scale changes.
+ *
+ * Used only from the thread that draws.
+ */
+class ScaledBitmapCache
+{
+private:
+    /// Scale the bitmaps are made for
+    double mScale = 0;
+
+    /// Resampled bitmaps by archetype
+    std::unordered_map<const ItemArchetype*, std::unique_ptr<wxBitmap>> mBitmaps;
+
+    /// Bitmaps resampled since the cache was created
+    long mResamples = 0;
+
+public:
+    void SetScale(double scale);
+
+    /**
+     * Get the scale the bitmaps are made for
+     * @return Device pixels per virtual pixel
+     */
+    double GetScale() const { return mScale; }
+
+    const wxBitmap* Get(const ItemArchetype* archetype);
+
+    /**
+     * Get the number of bitmaps held
+     * @return Number of resampled bitmaps
+     */
+    size_t GetCount() const { return mBitmaps.size(); }
+
+    /**
+     * Get the number of bitmaps resampled so far
+     * @return Number of resamples
+     */
+    long GetResamples() const { return mResamples; }
+
+    size_t GetMemoryUsed() const;
+};
+
+#endif //SCALEDBITMAPCACHE_H
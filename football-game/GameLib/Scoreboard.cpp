@@ -4,6 +4,7 @@
  */
  
 #include "Scoreboard.h"
+#include "GameSnapshot.h"
 
 
 
@@ -35,7 +36,19 @@ void Scoreboard::Initialize(wxStopWatch* stopWatch)
 void Scoreboard::OnDraw(std::shared_ptr<wxGraphicsContext> gc, int width, int height)
 {
     if (!mStopWatch) return;
+    Draw(gc, width, mStopWatch->Time(), GetScore());
+}
 
+/**
+ * Draw a scoreboard from its values, such as ones captured
+ * on another thread
+ * @param gc Graphics context
+ * @param width of window
+ * @param elapsedMs Level time in milliseconds
+ * @param score Score to show
+ */
+void Scoreboard::Draw(std::shared_ptr<wxGraphicsContext> gc, int width, long elapsedMs, int score)
+{
     gc->PushState();
     gc->SetTransform(gc->CreateMatrix());
 
@@ -47,7 +60,6 @@ void Scoreboard::OnDraw(std::shared_ptr<wxGraphicsContext> gc, int width, int he
     gc->SetPen(*wxTRANSPARENT_PEN);
 
     //timer
-    long elapsedMs = mStopWatch->Time();
     int minutes = elapsedMs / 60000;
     int seconds = (elapsedMs / 1000) % 60;
     wxString timeStr = wxString::Format("Time: %02d:%02d", minutes, seconds);
@@ -58,7 +70,7 @@ void Scoreboard::OnDraw(std::shared_ptr<wxGraphicsContext> gc, int width, int he
     gc->DrawText(timeStr, 10, 10);
 
     //score
-    wxString scoreStr = wxString::Format("Score: %d", static_cast<int>(mScore));
+    wxString scoreStr = wxString::Format("Score: %d", score);
     double scoreWidth, scoreHeight;
     gc->GetTextExtent(scoreStr, &scoreWidth, &scoreHeight);
 
@@ -131,3 +143,23 @@ void Scoreboard::PowerUp()
         mPowerUpStart = mStopWatch->Time();
     }
 }
+
+/**
+ * Save the score to a snapshot
+ * @param snapshot Snapshot to write to
+ */
+void Scoreboard::SaveState(GameSnapshot& snapshot) const
+{
+    snapshot.Write(mScore);
+    snapshot.Write(mPowerUp);
+}
+
+/**
+ * Load the score from a snapshot
+ * @param snapshot Snapshot to read from
+ */
+void Scoreboard::LoadState(GameSnapshot& snapshot)
+{
+    snapshot.Read(mScore);
+    snapshot.Read(mPowerUp);
+}
@@ -8,6 +8,8 @@
 #ifndef SCOREBOARD_H
 #define SCOREBOARD_H
 
+class GameSnapshot;
+
 class Scoreboard
 {
 private:
@@ -31,6 +33,7 @@ public:
 
     void Initialize(wxStopWatch* stopWatch);
     void OnDraw(std::shared_ptr<wxGraphicsContext> gc, int width, int height);
+    static void Draw(std::shared_ptr<wxGraphicsContext> gc, int width, long elapsedMs, int score);
     void Update(double elapsed);
     void Reset();
     /**
@@ -45,6 +48,8 @@ public:
     int GetScore() const { return static_cast<int>(mScore); }
 
     void PowerUp();
+    void SaveState(GameSnapshot& snapshot) const;
+    void LoadState(GameSnapshot& snapshot);
     /**
      * Check if power up is active
      * @return mPowerUp
@@ -0,0 +1,157 @@
+/**
+ * @file SimulationThread.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "SimulationThread.h"
+#include "Game.h"
+#include "Telemetry.h"
+
+#include <chrono>
+
+/**
+ * Constructor
+ * @param game Game to run. It must outlive this object.
+ * @param rate Ticks per second
+ */
+SimulationThread::SimulationThread(Game* game, double rate) : mGame(game), mStep(1.0 / rate)
+{
+}
+
+/**
+ * Destructor
+ */
+SimulationThread::~SimulationThread()
+{
+    Stop();
+}
+
+/**
+ * Start ticking the game on the thread
+ */
+void SimulationThread::Start()
+{
+    if (IsRunning())
+    {
+        return;
+    }
+
+    mRunning = true;
+    mThread = std::thread(&SimulationThread::Run, this);
+}
+
+/**
+ * Stop the thread, waiting for the tick in progress. The game
+ * can then be used from the calling thread without the lock.
+ */
+void SimulationThread::Stop()
+{
+    if (!IsRunning())
+    {
+        return;
+    }
+
+    mRunning = false;
+    mThread.join();
+}
+
+/**
+ * Tick the game until stopped, sleeping between ticks
+ */
+void SimulationThread::Run()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(mStep));
+
+    auto next = Clock::now();
+    while (mRunning)
+    {
+        Tick();
+
+        // Ticks missed are made up, unless the thread was held
+        // up so long that the game would race to catch up
+        next += step;
+        auto now = Clock::now();
+        if (now - next > step * MaxBehind)
+        {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+/**
+ * Run one tick: apply the inputs sent since the last, advance
+ * the game a step and publish its render state. Called by the
+ * thread; call it directly to step a game that is not running.
+ */
+void SimulationThread::Tick()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    Input input;
+    while (mInputs.Pop(input))
+    {
+        mInput = input;
+        mInputCount++;
+    }
+
+    int width = mViewWidth.load(std::memory_order_relaxed);
+    int height = mViewHeight.load(std::memory_order_relaxed);
+    if (width > 0 && height > 0)
+    {
+        mGame->SetViewSize(width, height);
+    }
+
+    // The keys are applied every tick, as the view does when it
+    // samples them every frame
+    if (mInput.rewind)
+    {
+        mGame->Rewind(mStep);
+    }
+    else
+    {
+        mGame->ApplyInput(mInput.left, mInput.right, mInput.jump);
+        mGame->Update(mStep);
+        Telemetry::Count(Telemetry::Counter::SubSteps);
+    }
+    mTicks++;
+
+    auto& state = mStates.GetBack();
+    mGame->Capture(state);
+    state.SetTick(mTicks, mInputCount, RenderState::Clock::now());
+    mStates.Publish();
+}
+
+/**
+ * Send the keys down to the game, for the next tick.
+ * Only one thread may send.
+ * @param input Keys down
+ * @return False if the queue is full; send again later
+ */
+bool SimulationThread::Send(const Input& input)
+{
+    return mInputs.Push(input);
+}
+
+/**
+ * Set the size of the window the game is shown in
+ * @param width Width in pixels
+ * @param height Height in pixels
+ */
+void SimulationThread::SetViewSize(int width, int height)
+{
+    mViewWidth.store(width, std::memory_order_relaxed);
+    mViewHeight.store(height, std::memory_order_relaxed);
+}
+
+/**
+ * Take the latest render state, if there is a new one.
+ * Only one thread may take states.
+ * @return True if GetState changed
+ */
+bool SimulationThread::Update()
+{
+    return mStates.Update();
+}
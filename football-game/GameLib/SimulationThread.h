@@ -0,0 +1,141 @@
+/**
+ * @file SimulationThread.h
+ * @author Brennan Eagle
+ *
+ * Runs a game on its own thread at a fixed rate
+ */
+
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "RenderState.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+class Game;
+
+/**
+ * Runs a game on its own thread at a fixed rate.
+ *
+ * Updating the game in the paint handler ties the simulation to
+ * the GUI thread: while a menu is open or the window is being
+ * resized, the game stops. Here the game ticks on a thread of its
+ * own, a fixed step at a time, whatever the GUI is doing.
+ *
+ * The view never looks at the game while it runs. After each tick
+ * the game's render state is captured into a triple buffer, and
+ * the view draws the latest one. Key states come the other way
+ * through a queue. Neither ever waits for the other.
+ *
+ * Anything else that reads or changes the game, such as loading a
+ * level from a menu, holds Lock() while it does. Ticks are run
+ * under the same lock, so the change happens between two ticks.
+ */
+class SimulationThread
+{
+public:
+    /// The keys down, sent to the game
+    struct Input
+    {
+        bool left = false;      ///< Move left
+        bool right = false;     ///< Move right
+        bool jump = false;      ///< Jump
+        bool rewind = false;    ///< Play runs backwards
+    };
+
+    /// Ticks per second unless told otherwise
+    static constexpr double DefaultRate = 120;
+
+private:
+    /// Most inputs waiting for a tick
+    static constexpr size_t MaxInputs = 64;
+
+    /// Ticks the thread can fall behind before it stops catching up
+    static constexpr int MaxBehind = 10;
+
+    /// The game
+    Game* mGame;
+
+    /// Seconds of play per tick
+    double mStep;
+
+    /// Held while the game is ticked or otherwise used
+    std::mutex mMutex;
+
+    /// The thread, when running
+    std::thread mThread;
+
+    /// Should the thread keep running?
+    std::atomic<bool> mRunning{false};
+
+    /// Inputs from the view
+    SpscQueue<Input, MaxInputs> mInputs;
+
+    /// Render states for the view
+    TripleBuffer<RenderState> mStates;
+
+    /// Width of the view in pixels, 0 until known
+    std::atomic<int> mViewWidth{0};
+
+    /// Height of the view in pixels, 0 until known
+    std::atomic<int> mViewHeight{0};
+
+    /// The latest input taken from the queue
+    Input mInput;
+
+    /// Number of inputs taken from the queue
+    uint64_t mInputCount = 0;
+
+    /// Number of ticks run
+    uint64_t mTicks = 0;
+
+    void Run();
+
+public:
+    explicit SimulationThread(Game* game, double rate = DefaultRate);
+    ~SimulationThread();
+
+    /// Copy constructor (disabled)
+    SimulationThread(const SimulationThread &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const SimulationThread &) = delete;
+
+    void Start();
+    void Stop();
+    void Tick();
+    bool Send(const Input& input);
+    void SetViewSize(int width, int height);
+    bool Update();
+
+    /**
+     * Is the thread running?
+     * @return True between Start and Stop
+     */
+    bool IsRunning() const { return mThread.joinable(); }
+
+    /**
+     * Get the render state taken by the last Update
+     * @return Render state, empty before the first tick
+     */
+    const RenderState& GetState() const { return mStates.GetFront(); }
+
+    /**
+     * Get the seconds of play in a tick
+     * @return Step in seconds
+     */
+    double GetStep() const { return mStep; }
+
+    /**
+     * Lock the game against ticks, to read or change it from
+     * another thread
+     * @return Lock, held until it is destroyed
+     */
+    std::unique_lock<std::mutex> Lock() { return std::unique_lock<std::mutex>(mMutex); }
+};
+
+#endif //SIMULATIONTHREAD_H
@@ -0,0 +1,488 @@
+/**
+ * @file SoftwareRenderer.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "SoftwareRenderer.h"
+#include "ItemArchetype.h"
+
+#include <wx/rawbmp.h>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SOFTWARE_RENDERER_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+/// Compile one function for AVX2 without needing it for the whole build
+#define TARGET_AVX2 __attribute__((target("avx2")))
+/// Compile one function for SSE2 without needing it for the whole build
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define TARGET_AVX2
+#define TARGET_SSE2
+#endif
+
+/**
+ * Scale a channel by an inverse alpha, rounded, as x * inv / 255.
+ * The SIMD kernels compute exactly the same thing.
+ * @param x Channel value
+ * @param inv 255 minus the source alpha
+ * @return Scaled channel
+ */
+static inline uint32_t ScaleChannel(uint32_t x, uint32_t inv)
+{
+    uint32_t t = x * inv + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+/**
+ * Blend premultiplied pixels over a row, one at a time
+ * @param dst Row of the frame
+ * @param src Row of the sprite
+ * @param count Number of pixels
+ */
+static void BlendRowScalar(uint32_t* dst, const uint32_t* src, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const uint32_t s = src[i];
+        const uint32_t alpha = s >> 24;
+        if (alpha == 255)
+        {
+            dst[i] = s;
+            continue;
+        }
+        if (s == 0)
+        {
+            continue;
+        }
+
+        const uint32_t d = dst[i];
+        const uint32_t inv = 255 - alpha;
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            uint32_t channel = ((s >> shift) & 0xff) + ScaleChannel((d >> shift) & 0xff, inv);
+            result |= std::min(channel, 255u) << shift;
+        }
+        dst[i] = result;
+    }
+}
+
+#ifdef SOFTWARE_RENDERER_X86
+
+/**
+ * Blend four premultiplied pixels over four frame pixels
+ * @param s Source pixels
+ * @param d Frame pixels
+ * @return Blended pixels
+ */
+TARGET_SSE2 static inline __m128i Blend4(__m128i s, __m128i d)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    // 255 - alpha in both 16 bit halves of each pixel
+    __m128i alpha = _mm_srli_epi32(s, 24);
+    alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+    const __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+
+    const __m128i invLo = _mm_unpacklo_epi32(inv, inv);
+    const __m128i invHi = _mm_unpackhi_epi32(inv, inv);
+
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), invLo), _mm_set1_epi16(128));
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), invHi), _mm_set1_epi16(128));
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+    return _mm_adds_epu8(s, _mm_packus_epi16(lo, hi));
+}
+
+/**
+ * Blend premultiplied pixels over a row, four at a time
+ * @param dst Row of the frame
+ * @param src Row of the sprite
+ * @param count Number of pixels
+ */
+TARGET_SSE2 static void BlendRowSSE2(uint32_t* dst, const uint32_t* src, int count)
+{
+    int i = 0;
+    for ( ; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+        // Fully transparent runs leave the frame alone
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, _mm_setzero_si128())) == 0xffff)
+        {
+            continue;
+        }
+
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), Blend4(s, d));
+    }
+
+    BlendRowScalar(dst + i, src + i, count - i);
+}
+
+/**
+ * Blend premultiplied pixels over a row, eight at a time
+ * @param dst Row of the frame
+ * @param src Row of the sprite
+ * @param count Number of pixels
+ */
+TARGET_AVX2 static void BlendRowAVX2(uint32_t* dst, const uint32_t* src, int count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i full = _mm256_set1_epi16(255);
+    const __m256i half = _mm256_set1_epi16(128);
+
+    int i = 0;
+    for ( ; i + 8 <= count; i += 8)
+    {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+
+        if (_mm256_testz_si256(s, s))
+        {
+            continue;
+        }
+
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+
+        // Unpacking and packing both work within 128 bit lanes,
+        // so the pixel order comes back out unchanged
+        __m256i alpha = _mm256_srli_epi32(s, 24);
+        alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 16));
+        const __m256i inv = _mm256_sub_epi16(full, alpha);
+
+        __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero),
+                _mm256_unpacklo_epi32(inv, inv)), half);
+        __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero),
+                _mm256_unpackhi_epi32(inv, inv)), half);
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+        __m256i result = _mm256_adds_epu8(s, _mm256_packus_epi16(lo, hi));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), result);
+    }
+
+    BlendRowSSE2(dst + i, src + i, count - i);
+}
+
+/**
+ * Does this processor and operating system run AVX2?
+ * @return True if AVX2 is available
+ */
+static bool HasAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+/**
+ * Does this processor run SSE2?
+ * @return True if SSE2 is available
+ */
+static bool HasSSE2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif // SOFTWARE_RENDERER_X86
+
+/**
+ * Constructor. Uses the fastest kernel available.
+ */
+SoftwareRenderer::SoftwareRenderer()
+{
+    SetKernel(BestKernel());
+}
+
+/**
+ * Can this processor run a kernel?
+ * @param kernel Row blending kernel
+ * @return True if it can be used
+ */
+bool SoftwareRenderer::IsSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::Scalar:
+        return true;
+#ifdef SOFTWARE_RENDERER_X86
+    case Kernel::SSE2:
+        return HasSSE2();
+    case Kernel::AVX2:
+        return HasSSE2() && HasAVX2();
+#endif
+    default:
+        return false;
+    }
+}
+
+/**
+ * Get the fastest kernel this processor runs
+ * @return Row blending kernel
+ */
+SoftwareRenderer::Kernel SoftwareRenderer::BestKernel()
+{
+    if (IsSupported(Kernel::AVX2))
+    {
+        return Kernel::AVX2;
+    }
+    if (IsSupported(Kernel::SSE2))
+    {
+        return Kernel::SSE2;
+    }
+    return Kernel::Scalar;
+}
+
+/**
+ * Get the name of a kernel
+ * @param kernel Row blending kernel
+ * @return Name for display
+ */
+const wchar_t* SoftwareRenderer::KernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::Scalar:
+        return L"scalar";
+    case Kernel::SSE2:
+        return L"SSE2";
+    case Kernel::AVX2:
+        return L"AVX2";
+    }
+    return L"?";
+}
+
+/**
+ * Choose the row blending kernel
+ * @param kernel Kernel to use
+ * @return False if this processor cannot run it, and the kernel is unchanged
+ */
+bool SoftwareRenderer::SetKernel(Kernel kernel)
+{
+    if (!IsSupported(kernel))
+    {
+        return false;
+    }
+
+    mKernel = kernel;
+    switch (kernel)
+    {
+#ifdef SOFTWARE_RENDERER_X86
+    case Kernel::AVX2:
+        mBlend = BlendRowAVX2;
+        break;
+    case Kernel::SSE2:
+        mBlend = BlendRowSSE2;
+        break;
+#endif
+    default:
+        mBlend = BlendRowScalar;
+        break;
+    }
+    return true;
+}
+
+/**
+ * Start a frame
+ * @param width Frame width in device pixels
+ * @param height Frame height in device pixels
+ * @param clear Premultiplied ARGB colour to fill the frame with
+ */
+void SoftwareRenderer::Begin(int width, int height, uint32_t clear)
+{
+    mWidth = std::max(width, 0);
+    mHeight = std::max(height, 0);
+    mPixels.assign(size_t(mWidth) * mHeight, clear);
+}
+
+/**
+ * Set the scale to draw at. Changing it drops every sprite.
+ * @param scale Device pixels per virtual pixel
+ */
+void SoftwareRenderer::SetScale(double scale)
+{
+    if (scale != mScale)
+    {
+        mScale = scale;
+        mSprites.clear();
+    }
+}
+
+/**
+ * Get the sprite for an archetype at the current scale
+ * @param archetype Archetype to draw
+ * @return Sprite, nullptr if there is nothing to draw
+ */
+const SoftwareRenderer::Sprite* SoftwareRenderer::GetSprite(const ItemArchetype* archetype)
+{
+    auto found = mSprites.find(archetype);
+    if (found != mSprites.end())
+    {
+        return found->second.get();
+    }
+
+    std::unique_ptr<Sprite> sprite;
+    if (archetype->bitmap && archetype->bitmap->IsOk())
+    {
+        int width = std::max(1, int(std::lround(archetype->width * mScale)));
+        int height = std::max(1, int(std::lround(archetype->height * mScale)));
+
+        auto image = archetype->bitmap->ConvertToImage().Scale(width, height, wxIMAGE_QUALITY_HIGH);
+        if (!image.HasAlpha())
+        {
+            // Turns any mask colour into transparent pixels
+            image.InitAlpha();
+        }
+
+        const unsigned char* rgb = image.GetData();
+        const unsigned char* alpha = image.GetAlpha();
+        if (rgb != nullptr)
+        {
+            sprite = std::make_unique<Sprite>();
+            sprite->width = width;
+            sprite->height = height;
+            sprite->pixels.resize(size_t(width) * height);
+            for (size_t i = 0; i < sprite->pixels.size(); i++)
+            {
+                const uint32_t a = alpha != nullptr ? alpha[i] : 255;
+                auto premultiply = [a](uint32_t c) { return (c * a + 127) / 255; };
+                sprite->pixels[i] = a << 24 | premultiply(rgb[i * 3]) << 16 |
+                    premultiply(rgb[i * 3 + 1]) << 8 | premultiply(rgb[i * 3 + 2]);
+            }
+        }
+    }
+
+    auto result = sprite.get();
+    mSprites[archetype] = std::move(sprite);
+    return result;
+}
+
+/**
+ * Blend a sprite over the frame, clipped to the frame
+ * @param sprite Sprite to draw
+ * @param x Left edge in device pixels
+ * @param y Top edge in device pixels
+ */
+void SoftwareRenderer::Blit(const Sprite& sprite, int x, int y)
+{
+    const int left = std::max(x, 0);
+    const int top = std::max(y, 0);
+    const int right = std::min(x + sprite.width, mWidth);
+    const int bottom = std::min(y + sprite.height, mHeight);
+    if (left >= right || top >= bottom)
+    {
+        return;
+    }
+
+    const int count = right - left;
+    for (int row = top; row < bottom; row++)
+    {
+        const uint32_t* src = sprite.pixels.data() + size_t(row - y) * sprite.width + (left - x);
+        uint32_t* dst = mPixels.data() + size_t(row) * mWidth + left;
+        mBlend(dst, src, count);
+    }
+}
+
+/**
+ * Put the frame on a graphics context with one bitmap draw.
+ *
+ * The frame is opaque when it was cleared to an opaque colour,
+ * so premultiplied and straight alpha are the same and the
+ * pixels can be copied as they are on every platform.
+ *
+ * @param gc Graphics context in device pixels
+ */
+void SoftwareRenderer::Present(std::shared_ptr<wxGraphicsContext> gc)
+{
+    if (mWidth == 0 || mHeight == 0)
+    {
+        return;
+    }
+
+    if (!mBitmap || mBitmap->GetWidth() != mWidth || mBitmap->GetHeight() != mHeight)
+    {
+        mBitmap = std::make_unique<wxBitmap>(mWidth, mHeight, 32);
+        mBitmap->UseAlpha();
+    }
+
+    {
+        wxAlphaPixelData data(*mBitmap);
+        if (!data)
+        {
+            return;
+        }
+
+        wxAlphaPixelData::Iterator rowStart(data);
+        const uint32_t* src = mPixels.data();
+        for (int row = 0; row < mHeight; row++)
+        {
+            wxAlphaPixelData::Iterator p = rowStart;
+            for (int col = 0; col < mWidth; col++, ++p)
+            {
+                const uint32_t pixel = *src++;
+                p.Alpha() = pixel >> 24;
+                p.Red() = (pixel >> 16) & 0xff;
+                p.Green() = (pixel >> 8) & 0xff;
+                p.Blue() = pixel & 0xff;
+            }
+            rowStart.OffsetY(data, 1);
+        }
+    }
+
+    gc->DrawBitmap(*mBitmap, 0, 0, mWidth, mHeight);
+}
+
+/**
+ * Get the memory the frame, its bitmap and the sprites take
+ * @return Bytes used
+ */
+size_t SoftwareRenderer::GetMemoryUsed() const
+{
+    size_t bytes = mPixels.capacity() * sizeof(uint32_t);
+    if (mBitmap)
+    {
+        bytes += size_t(mBitmap->GetWidth()) * mBitmap->GetHeight() * 4;
+    }
+    for (auto& entry : mSprites)
+    {
+        if (entry.second)
+        {
+            bytes += sizeof(Sprite) + entry.second->pixels.capacity() * sizeof(uint32_t);
+        }
+    }
+    return bytes;
+}
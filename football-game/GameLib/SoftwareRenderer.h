@@ -0,0 +1,132 @@
+/**
+ * @file SoftwareRenderer.h
+ * @author Brennan Eagle
+ *
+ * Draws item sprites straight into a pixel buffer
+ */
+
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct ItemArchetype;
+
+/**
+ * Draws item sprites straight into a pixel buffer.
+ *
+ * The game is made of unrotated, axis aligned sprites, so the
+ * frame is composited here instead of through a graphics
+ * context, and handed to the screen as one bitmap per frame.
+ *
+ * Pixels are premultiplied ARGB, one 32 bit word each. Sprites
+ * are resampled to the display scale once, like the scaled
+ * bitmap cache, and blended over the frame with the fastest
+ * kernel the processor has: AVX2, SSE2 or plain C++.
+ *
+ * Used only from the thread that draws.
+ */
+class SoftwareRenderer
+{
+public:
+    /// Row blending kernels
+    enum class Kernel { Scalar, SSE2, AVX2 };
+
+    /// A sprite at the display scale
+    struct Sprite
+    {
+        /// Width in device pixels
+        int width = 0;
+        /// Height in device pixels
+        int height = 0;
+        /// Premultiplied ARGB pixels, row by row
+        std::vector<uint32_t> pixels;
+    };
+
+    /// Blends a row of source pixels over a row of the frame
+    typedef void (*BlendRow)(uint32_t* dst, const uint32_t* src, int count);
+
+private:
+    /// Frame width in device pixels
+    int mWidth = 0;
+
+    /// Frame height in device pixels
+    int mHeight = 0;
+
+    /// The frame, premultiplied ARGB
+    std::vector<uint32_t> mPixels;
+
+    /// Bitmap the frame is presented through
+    std::unique_ptr<wxBitmap> mBitmap;
+
+    /// Scale the sprites are made for
+    double mScale = 0;
+
+    /// Sprites by archetype at the current scale
+    std::unordered_map<const ItemArchetype*, std::unique_ptr<Sprite>> mSprites;
+
+    /// Kernel in use
+    Kernel mKernel;
+
+    /// Row blending function for the kernel
+    BlendRow mBlend;
+
+public:
+    SoftwareRenderer();
+
+    /// Copy constructor (disabled)
+    SoftwareRenderer(const SoftwareRenderer &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const SoftwareRenderer &) = delete;
+
+    void Begin(int width, int height, uint32_t clear = 0xff000000);
+    void SetScale(double scale);
+
+    /**
+     * Get the scale the sprites are made for
+     * @return Device pixels per virtual pixel
+     */
+    double GetScale() const { return mScale; }
+
+    const Sprite* GetSprite(const ItemArchetype* archetype);
+    void Blit(const Sprite& sprite, int x, int y);
+    void Present(std::shared_ptr<wxGraphicsContext> gc);
+
+    /**
+     * Get the frame width
+     * @return Width in device pixels
+     */
+    int GetWidth() const { return mWidth; }
+
+    /**
+     * Get the frame height
+     * @return Height in device pixels
+     */
+    int GetHeight() const { return mHeight; }
+
+    /**
+     * Get the frame pixels
+     * @return Premultiplied ARGB pixels, row by row
+     */
+    const std::vector<uint32_t>& GetPixels() const { return mPixels; }
+
+    /**
+     * Get the kernel in use
+     * @return Row blending kernel
+     */
+    Kernel GetKernel() const { return mKernel; }
+
+    bool SetKernel(Kernel kernel);
+
+    size_t GetMemoryUsed() const;
+
+    static bool IsSupported(Kernel kernel);
+    static Kernel BestKernel();
+    static const wchar_t* KernelName(Kernel kernel);
+};
+
+#endif //SOFTWARERENDERER_H
@@ -0,0 +1,75 @@
+/**
+ * @file SpscQueue.h
+ * @author Brennan Eagle
+ *
+ * Fixed size queue from one thread to another
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Fixed size queue from one thread to another.
+ *
+ * One thread pushes and one pops. Each only writes its own end
+ * of the queue, so neither takes a lock or waits. The ends are
+ * kept on separate cache lines so the threads do not slow each
+ * other down.
+ *
+ * @tparam T Item type
+ * @tparam Capacity Most items the queue holds
+ */
+template<class T, size_t Capacity>
+class SpscQueue
+{
+private:
+    /// The items, item n at n % Capacity
+    std::array<T, Capacity> mItems;
+
+    /// Number of items popped. Only the popping thread changes it.
+    alignas(64) std::atomic<size_t> mHead{0};
+
+    /// Number of items pushed. Only the pushing thread changes it.
+    alignas(64) std::atomic<size_t> mTail{0};
+
+public:
+    /**
+     * Add an item to the back of the queue. Pushing thread only.
+     * @param item Item to add
+     * @return False if the queue is full
+     */
+    bool Push(const T& item)
+    {
+        size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        mItems[tail % Capacity] = item;
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Take the item at the front of the queue. Popping thread only.
+     * @param item Set to the item
+     * @return False if the queue is empty
+     */
+    bool Pop(T& item)
+    {
+        size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = mItems[head % Capacity];
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+#endif //SPSCQUEUE_H
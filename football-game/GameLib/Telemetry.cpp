@@ -0,0 +1,314 @@
+/**
+ * @file Telemetry.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "Telemetry.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+/// Every thread's block, and the totals of threads that have exited
+struct TelemetryRegistry
+{
+    /// Protects the list and the retired block
+    std::mutex mutex;
+    /// Blocks of running threads
+    std::vector<Telemetry::Block*> live;
+    /// Totals of exited threads
+    Telemetry::Block retired;
+};
+
+/**
+ * Get the registry. It is never destroyed, so threads that
+ * exit after main returns can still fold their counts into it.
+ * @return The registry
+ */
+static TelemetryRegistry& Registry()
+{
+    static auto registry = new TelemetryRegistry;
+    return *registry;
+}
+
+/**
+ * Add one block into another
+ * @param to Block to add to
+ * @param from Block to add
+ */
+static void AddBlock(Telemetry::Block& to, const Telemetry::Block& from)
+{
+    const auto relaxed = std::memory_order_relaxed;
+    for (int c = 0; c < Telemetry::Counters; c++)
+    {
+        to.totals[c].fetch_add(from.totals[c].load(relaxed), relaxed);
+        for (int b = 0; b < Telemetry::Buckets; b++)
+        {
+            to.histograms[c][b].fetch_add(from.histograms[c][b].load(relaxed), relaxed);
+        }
+    }
+    for (int b = 0; b < Telemetry::Buckets; b++)
+    {
+        to.frameTimes[b].fetch_add(from.frameTimes[b].load(relaxed), relaxed);
+    }
+    to.frames.fetch_add(from.frames.load(relaxed), relaxed);
+}
+
+/// Registers a thread's block, and folds it into the totals when the thread exits
+struct TelemetryOwner
+{
+    /// This thread's block
+    Telemetry::Block* block = new Telemetry::Block;
+
+    /// Constructor
+    TelemetryOwner()
+    {
+        auto& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.live.push_back(block);
+    }
+
+    /// Destructor
+    ~TelemetryOwner()
+    {
+        auto& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        AddBlock(registry.retired, *block);
+        registry.live.erase(std::find(registry.live.begin(), registry.live.end(), block));
+        delete block;
+    }
+};
+
+/**
+ * Get this thread's block, creating it on first use
+ * @return Block for this thread
+ */
+Telemetry::Block& Telemetry::Local()
+{
+    thread_local TelemetryOwner owner;
+    return *owner.block;
+}
+
+/**
+ * Get the histogram bucket for a value
+ * @param value Value to place
+ * @return 0 for 0, otherwise b where 2^(b-1) <= value < 2^b
+ */
+int Telemetry::Bucket(uint64_t value)
+{
+    int bucket = 0;
+    while (value != 0 && bucket < Buckets - 1)
+    {
+        value >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * End a frame on this thread. What was counted since the last
+ * frame, and the frame time, go into the histograms.
+ * @param seconds How long the frame took
+ */
+void Telemetry::EndFrame(double seconds)
+{
+    const auto relaxed = std::memory_order_relaxed;
+    auto& block = Local();
+
+    for (int c = 0; c < Counters; c++)
+    {
+        uint64_t total = block.totals[c].load(relaxed);
+        uint64_t start = block.frameStart[c].exchange(total, relaxed);
+        // Less than at the last frame when Reset ran in between
+        uint64_t delta = total >= start ? total - start : total;
+
+        block.histograms[c][Bucket(delta)].fetch_add(1, relaxed);
+    }
+
+    block.frameTimes[Bucket(uint64_t(seconds > 0 ? seconds * 1e6 : 0))].fetch_add(1, relaxed);
+    block.frames.fetch_add(1, relaxed);
+}
+
+/**
+ * Get the name of a counter
+ * @param counter Counter
+ * @return Name used in the JSON output
+ */
+const char* Telemetry::Name(Counter counter)
+{
+    switch (counter)
+    {
+    case Counter::NarrowTests:
+        return "narrow_tests";
+    case Counter::VisitPlatform:
+        return "visit_platform";
+    case Counter::VisitWall:
+        return "visit_wall";
+    case Counter::VisitCoin10:
+        return "visit_coin10";
+    case Counter::VisitCoin100:
+        return "visit_coin100";
+    case Counter::VisitEnemy:
+        return "visit_enemy";
+    case Counter::VisitGoalPost:
+        return "visit_goal_post";
+    case Counter::VisitPowerUp:
+        return "visit_power_up";
+    case Counter::ItemsUpdated:
+        return "items_updated";
+    case Counter::ItemsDrawn:
+        return "items_drawn";
+    case Counter::BitmapsLoaded:
+        return "bitmaps_loaded";
+    case Counter::LevelLoads:
+        return "level_loads";
+    case Counter::SubSteps:
+        return "sub_steps";
+    case Counter::ContactsMerged:
+        return "contacts_merged";
+    case Counter::ImageCacheHits:
+        return "image_cache_hits";
+    default:
+        return "?";
+    }
+}
+
+/**
+ * Add up every thread
+ * @param sum Block to add into, initially zero
+ * @return Number of running threads that have counted
+ */
+static size_t Gather(Telemetry::Block& sum)
+{
+    auto& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    AddBlock(sum, registry.retired);
+    for (auto block : registry.live)
+    {
+        AddBlock(sum, *block);
+    }
+    return registry.live.size();
+}
+
+/**
+ * Get a counter's total over every thread
+ * @param counter Counter
+ * @return Total count
+ */
+uint64_t Telemetry::GetTotal(Counter counter)
+{
+    Block sum;
+    Gather(sum);
+    return sum.totals[int(counter)].load(std::memory_order_relaxed);
+}
+
+/**
+ * Write a histogram as a JSON array of its non-empty buckets
+ * @param out Stream to write to
+ * @param buckets Bucket counts
+ */
+static void WriteHistogram(std::ostringstream& out, const std::atomic<uint64_t>* buckets)
+{
+    out << '[';
+    bool first = true;
+    for (int b = 0; b < Telemetry::Buckets; b++)
+    {
+        uint64_t count = buckets[b].load(std::memory_order_relaxed);
+        if (count == 0)
+        {
+            continue;
+        }
+        uint64_t min = b == 0 ? 0 : uint64_t(1) << (b - 1);
+        uint64_t max = b == 0 ? 0 : (uint64_t(1) << b) - 1;
+        out << (first ? "" : ",") << "{\"min\":" << min << ",\"max\":" << max << ",\"count\":" << count << '}';
+        first = false;
+    }
+    out << ']';
+}
+
+/**
+ * Get every thread's counts as JSON.
+ *
+ * Totals are for the whole run. The per frame histograms give,
+ * for each counter, how many frames counted a number in each
+ * bucket; frame_us does the same for frame times.
+ *
+ * @return JSON object
+ */
+std::string Telemetry::ToJson()
+{
+    Block sum;
+    size_t threads = Gather(sum);
+    const auto relaxed = std::memory_order_relaxed;
+
+    std::ostringstream out;
+    out << "{\"threads\":" << threads << ",\"frames\":" << sum.frames.load(relaxed) << ",\"totals\":{";
+    for (int c = 0; c < Counters; c++)
+    {
+        out << (c ? "," : "") << '"' << Name(Counter(c)) << "\":" << sum.totals[c].load(relaxed);
+    }
+
+    out << "},\"per_frame\":{";
+    for (int c = 0; c < Counters; c++)
+    {
+        out << (c ? "," : "") << '"' << Name(Counter(c)) << "\":";
+        WriteHistogram(out, sum.histograms[c]);
+    }
+
+    out << "},\"frame_us\":";
+    WriteHistogram(out, sum.frameTimes);
+    out << '}';
+    return out.str();
+}
+
+/**
+ * Write every thread's counts to a JSON file
+ * @param filename File to write
+ * @return True if the file was written
+ */
+bool Telemetry::Write(const std::wstring& filename)
+{
+    std::ofstream out{std::filesystem::path(filename)};
+    out << ToJson() << '\n';
+    return bool(out);
+}
+
+/**
+ * Set every count and histogram back to zero.
+ *
+ * May be called from any thread while others are counting.
+ * Each thread's open frame is restarted at zero as well, so
+ * its next EndFrame sees only what was counted after the reset.
+ */
+void Telemetry::Reset()
+{
+    auto& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    auto clear = [](Block& block) {
+        for (int c = 0; c < Counters; c++)
+        {
+            block.totals[c].store(0, std::memory_order_relaxed);
+            block.frameStart[c].store(0, std::memory_order_relaxed);
+            for (auto& bucket : block.histograms[c])
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+        for (auto& bucket : block.frameTimes)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        block.frames.store(0, std::memory_order_relaxed);
+    };
+
+    clear(registry.retired);
+    for (auto block : registry.live)
+    {
+        clear(*block);
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * @file Telemetry.h
+ * @author Brennan Eagle
+ *
+ * Counters for what the game does, per thread and per frame
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * Counters for what the game does, per thread and per frame.
+ *
+ * Each thread counts into its own block, so counting is a relaxed
+ * fetch_add on memory no other thread writes to outside Reset. A
+ * frame ends when its thread calls EndFrame, which adds what was
+ * counted during the frame, and how long the frame took, to power
+ * of two histograms. Blocks of threads that exit are folded into
+ * the totals.
+ *
+ * ToJson adds up every thread, and may be called from any
+ * thread at any time. So may Reset: counts made while it runs
+ * land on one side of it or the other and none are lost, and
+ * the frame each thread is in starts again from zero.
+ */
+class Telemetry
+{
+public:
+    /// Things that are counted
+    enum class Counter
+    {
+        NarrowTests,    ///< Collision tests that reached the bounding boxes
+        VisitPlatform,  ///< Collisions with platforms
+        VisitWall,      ///< Collisions with walls
+        VisitCoin10,    ///< Collisions with 10 point coins
+        VisitCoin100,   ///< Collisions with 100 point coins
+        VisitEnemy,     ///< Collisions with enemies
+        VisitGoalPost,  ///< Collisions with goal posts
+        VisitPowerUp,   ///< Collisions with power-ups
+        ItemsUpdated,   ///< Dynamic items updated
+        ItemsDrawn,     ///< Items drawn
+        BitmapsLoaded,  ///< Image files decoded into bitmaps
+        LevelLoads,     ///< Levels loaded
+        SubSteps,       ///< Game updates run for a frame
+        ContactsMerged, ///< Terrain contacts merged into a neighbor
+        ImageCacheHits, ///< Images loaded from the disk cache instead of decoded
+        Count           ///< Number of counters
+    };
+
+    /// Number of histogram buckets. Bucket b holds values in [2^(b-1), 2^b).
+    static const int Buckets = 40;
+
+    /// Number of counters
+    static const int Counters = int(Counter::Count);
+
+    /// Counts and histograms of one thread
+    struct Block
+    {
+        /// Totals by counter
+        std::atomic<uint64_t> totals[Counters] = {};
+        /// Totals at the end of the last frame
+        std::atomic<uint64_t> frameStart[Counters] = {};
+        /// Per frame histograms by counter
+        std::atomic<uint64_t> histograms[Counters][Buckets] = {};
+        /// Frame time histogram in microseconds
+        std::atomic<uint64_t> frameTimes[Buckets] = {};
+        /// Frames ended
+        std::atomic<uint64_t> frames{0};
+    };
+
+private:
+    static Block& Local();
+
+public:
+    /**
+     * Count something on this thread
+     * @param counter What happened
+     * @param n How many times
+     */
+    static void Count(Counter counter, uint64_t n = 1)
+    {
+        Local().totals[int(counter)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    static void EndFrame(double seconds);
+    static int Bucket(uint64_t value);
+    static const char* Name(Counter counter);
+
+    static uint64_t GetTotal(Counter counter);
+    static std::string ToJson();
+    static bool Write(const std::wstring& filename);
+    static void Reset();
+};
+
+#endif //TELEMETRY_H
@@ -0,0 +1,245 @@
+/**
+ * @file TerrainMesh.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "TerrainMesh.h"
+#include "Item.h"
+#include "ContactManifold.h"
+
+#include <algorithm>
+#include <cmath>
+
+/// Edges closer than this in virtual pixels are the same edge
+const double EdgeTolerance = 0.01;
+
+/**
+ * Are two edges the same?
+ * @param a First edge
+ * @param b Second edge
+ * @return True if they are within the tolerance
+ */
+static bool SameEdge(double a, double b)
+{
+    return std::abs(a - b) <= EdgeTolerance;
+}
+
+/**
+ * Is an item part of the mesh?
+ * @param item Item
+ * @return True for terrain that cannot move
+ */
+bool TerrainMesh::Covers(const Item& item)
+{
+    return item.GetCollisionLayer() == CollisionLayer::Terrain && !item.CanMove();
+}
+
+/**
+ * Merge rectangles that share a top and bottom and touch end to end
+ * @return True if any were merged
+ */
+bool TerrainMesh::MergeRows()
+{
+    std::sort(mRects.begin(), mRects.end(), [](const Rect& a, const Rect& b) {
+        if (a.top != b.top) return a.top < b.top;
+        if (a.bottom != b.bottom) return a.bottom < b.bottom;
+        return a.left < b.left;
+    });
+
+    size_t count = 0;
+    for (auto& rect : mRects)
+    {
+        if (count > 0)
+        {
+            auto& last = mRects[count - 1];
+            if (SameEdge(last.top, rect.top) && SameEdge(last.bottom, rect.bottom) &&
+                rect.left <= last.right + EdgeTolerance)
+            {
+                last.right = std::max(last.right, rect.right);
+                continue;
+            }
+        }
+        mRects[count++] = rect;
+    }
+
+    bool merged = count < mRects.size();
+    mRects.resize(count);
+    return merged;
+}
+
+/**
+ * Merge rectangles that share a left and right and touch top to bottom
+ * @return True if any were merged
+ */
+bool TerrainMesh::MergeColumns()
+{
+    std::sort(mRects.begin(), mRects.end(), [](const Rect& a, const Rect& b) {
+        if (a.left != b.left) return a.left < b.left;
+        if (a.right != b.right) return a.right < b.right;
+        return a.top < b.top;
+    });
+
+    size_t count = 0;
+    for (auto& rect : mRects)
+    {
+        if (count > 0)
+        {
+            auto& last = mRects[count - 1];
+            if (SameEdge(last.left, rect.left) && SameEdge(last.right, rect.right) &&
+                rect.top <= last.bottom + EdgeTolerance)
+            {
+                last.bottom = std::max(last.bottom, rect.bottom);
+                continue;
+            }
+        }
+        mRects[count++] = rect;
+    }
+
+    bool merged = count < mRects.size();
+    mRects.resize(count);
+    return merged;
+}
+
+/**
+ * Get the column a location is in. Locations before the first
+ * column or after the last are put in it.
+ * @param x X location in virtual pixels
+ * @return Column index
+ */
+int TerrainMesh::Column(double x) const
+{
+    double column = std::floor((x - mLeft) / ColumnWidth);
+    return int(std::min(std::max(column, 0.0), double(mColumns.size() - 1)));
+}
+
+/**
+ * Build the mesh from the static terrain among the game's items
+ * @param items The game's items
+ */
+void TerrainMesh::Build(const std::vector<std::shared_ptr<Item>>& items)
+{
+    mRects.clear();
+    mFirst.clear();
+    mColumns.clear();
+    mSources = 0;
+
+    for (auto& item : items)
+    {
+        if (Covers(*item))
+        {
+            Rect rect;
+            rect.left = item->GetX() - item->GetWidth() / 2;
+            rect.top = item->GetY() - item->GetHeight() / 2;
+            rect.right = item->GetX() + item->GetWidth() / 2;
+            rect.bottom = item->GetY() + item->GetHeight() / 2;
+            mRects.push_back(rect);
+            mSources++;
+        }
+    }
+
+    // A merge one way can line rectangles up to merge the other way
+    bool rows = true;
+    bool columns = true;
+    while (rows || columns)
+    {
+        rows = MergeRows();
+        columns = MergeColumns();
+    }
+
+    mValid = true;
+    if (mRects.empty())
+    {
+        return;
+    }
+
+    double left = mRects[0].left;
+    double right = mRects[0].right;
+    for (auto& rect : mRects)
+    {
+        left = std::min(left, rect.left);
+        right = std::max(right, rect.right);
+    }
+
+    mLeft = left;
+    double count = std::floor((right - left) / ColumnWidth) + 1;
+    mColumns.resize(size_t(std::min(std::max(count, 1.0), double(MaxColumns))));
+
+    for (int i = 0; i < int(mRects.size()); i++)
+    {
+        int first = Column(mRects[i].left);
+        int last = Column(mRects[i].right);
+        mFirst.push_back(first);
+        for (int column = first; column <= last; column++)
+        {
+            mColumns[column].push_back(i);
+        }
+    }
+}
+
+/**
+ * Add the rectangles a box touches to a contact manifold
+ * @param left Left edge of the box in virtual pixels
+ * @param top Top edge of the box in virtual pixels
+ * @param right Right edge of the box in virtual pixels
+ * @param bottom Bottom edge of the box in virtual pixels
+ * @param contacts Manifold to add to
+ * @return Number of rectangles added
+ */
+int TerrainMesh::FindContacts(double left, double top, double right, double bottom,
+                              ContactManifold& contacts) const
+{
+    if (mColumns.empty())
+    {
+        return 0;
+    }
+
+    int found = 0;
+    int first = Column(left);
+    int last = Column(right);
+    for (int column = first; column <= last; column++)
+    {
+        for (int i : mColumns[column])
+        {
+            // A rectangle across several columns is added from the first one searched
+            if (std::max(mFirst[i], first) != column)
+            {
+                continue;
+            }
+
+            // Touching counts, as it does for items
+            auto& rect = mRects[i];
+            if (right < rect.left || left > rect.right || bottom < rect.top || top > rect.bottom)
+            {
+                continue;
+            }
+
+            ContactManifold::Contact contact;
+            contact.left = rect.left;
+            contact.top = rect.top;
+            contact.right = rect.right;
+            contact.bottom = rect.bottom;
+            contact.item = nullptr;
+            contact.fixed = true;
+            contacts.Add(contact);
+            found++;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Get the memory the mesh takes
+ * @return Bytes used
+ */
+size_t TerrainMesh::GetMemoryUsed() const
+{
+    size_t bytes = mRects.capacity() * sizeof(Rect) + mFirst.capacity() * sizeof(int) +
+        mColumns.capacity() * sizeof(std::vector<int>);
+    for (auto& column : mColumns)
+    {
+        bytes += column.capacity() * sizeof(int);
+    }
+    return bytes;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file TerrainMesh.h
+ * @author Brennan Eagle
+ *
+ * The static terrain items merged into a few large rectangles
+ */
+
+#ifndef TERRAINMESH_H
+#define TERRAINMESH_H
+
+#include <memory>
+#include <vector>
+
+class Item;
+class ContactManifold;
+
+/**
+ * The static terrain items merged into a few large rectangles.
+ *
+ * Platforms are built from segments and walls from 32 pixel
+ * pieces, so a level has many small terrain boxes. When the
+ * game's items change, the boxes of the terrain that cannot move
+ * are merged, greedy meshing style: boxes that share a top and
+ * bottom and touch end to end become one, then boxes that share
+ * a left and right and touch top to bottom, over and over until
+ * nothing more merges. The rectangles cover exactly what the
+ * boxes did.
+ *
+ * The football collides with these rectangles instead of the
+ * items. The items are still drawn as they were. Terrain on the
+ * tile map is not included; it has its own cell queries.
+ */
+class TerrainMesh
+{
+public:
+    /// A rectangle of terrain in virtual pixels
+    struct Rect
+    {
+        double left;    ///< Left edge
+        double top;     ///< Top edge
+        double right;   ///< Right edge
+        double bottom;  ///< Bottom edge
+    };
+
+private:
+    /// Width of a column of the query index in virtual pixels
+    static constexpr double ColumnWidth = 256;
+
+    /// Most columns, so terrain placed far away cannot use up memory
+    static const int MaxColumns = 4096;
+
+    /// The merged rectangles
+    std::vector<Rect> mRects;
+
+    /// First column of each rectangle
+    std::vector<int> mFirst;
+
+    /// Rectangles by column of the level
+    std::vector<std::vector<int>> mColumns;
+
+    /// Left edge of the first column in virtual pixels
+    double mLeft = 0;
+
+    /// Number of item boxes the rectangles were made from
+    int mSources = 0;
+
+    /// Does the mesh match the items?
+    bool mValid = false;
+
+    bool MergeRows();
+    bool MergeColumns();
+    int Column(double x) const;
+
+public:
+    static bool Covers(const Item& item);
+
+    void Build(const std::vector<std::shared_ptr<Item>>& items);
+    int FindContacts(double left, double top, double right, double bottom, ContactManifold& contacts) const;
+
+    /// The terrain has changed, so the mesh must be built again
+    void Invalidate() { mValid = false; }
+
+    /**
+     * Does the mesh match the items?
+     * @return True if it has been built since the terrain last changed
+     */
+    bool IsValid() const { return mValid; }
+
+    /**
+     * Get the merged rectangles
+     * @return Rectangles
+     */
+    const std::vector<Rect>& GetRects() const { return mRects; }
+
+    /**
+     * Get the number of item boxes the rectangles were made from
+     * @return Number of static terrain items
+     */
+    int GetSourceCount() const { return mSources; }
+
+    size_t GetMemoryUsed() const;
+};
+
+#endif //TERRAINMESH_H
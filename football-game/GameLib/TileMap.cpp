@@ -0,0 +1,281 @@
+/**
+ * @file TileMap.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "TileMap.h"
+#include "ItemArchetype.h"
+#include "ContactManifold.h"
+#include "ScaledBitmapCache.h"
+#include "SoftwareRenderer.h"
+#include "RenderState.h"
+
+#include <algorithm>
+#include <cmath>
+
+/// Positions closer than this in virtual pixels are on the grid
+const double GridTolerance = 0.01;
+
+/**
+ * Size the map for a level and empty it
+ * @param width Width of the level in virtual pixels
+ * @param height Height of the level in virtual pixels
+ */
+void TileMap::Reset(double width, double height)
+{
+    Clear();
+
+    double columns = std::ceil(width / TileSize);
+    double rows = std::ceil(height / TileSize);
+    if (columns < 1 || rows < 1 || columns * rows > MaxCells)
+    {
+        // Every segment stays an item
+        return;
+    }
+
+    mColumns = int(columns);
+    mRows = int(rows);
+    mCells.assign(size_t(mColumns) * mRows, 0);
+}
+
+/**
+ * Empty the map and stop using it
+ */
+void TileMap::Clear()
+{
+    mColumns = 0;
+    mRows = 0;
+    mCells.clear();
+    mTiles.clear();
+    mFilled = 0;
+}
+
+/**
+ * Place a terrain segment in the cell it covers
+ * @param archetype Archetype of the segment
+ * @param x X location of the center of the segment
+ * @param y Y location of the center of the segment
+ * @return True if it is now a tile, false if it must be an item
+ */
+bool TileMap::Place(const ItemArchetype* archetype, double x, double y)
+{
+    if (!IsActive() || archetype == nullptr || archetype->width != TileSize || archetype->height != TileSize)
+    {
+        return false;
+    }
+
+    double column = (x - TileSize / 2) / TileSize;
+    double row = (y - TileSize / 2) / TileSize;
+    if (std::abs(column - std::round(column)) * TileSize > GridTolerance ||
+        std::abs(row - std::round(row)) * TileSize > GridTolerance)
+    {
+        return false;
+    }
+
+    int c = int(std::round(column));
+    int r = int(std::round(row));
+    if (c < 0 || r < 0 || c >= mColumns || r >= mRows)
+    {
+        return false;
+    }
+
+    // Overlapping terrain keeps the segment that came first
+    auto& cell = mCells[size_t(r) * mColumns + c];
+    if (cell != 0)
+    {
+        return false;
+    }
+
+    auto found = std::find(mTiles.begin(), mTiles.end(), archetype);
+    if (found == mTiles.end())
+    {
+        if (mTiles.size() >= UINT16_MAX)
+        {
+            return false;
+        }
+        found = mTiles.insert(mTiles.end(), archetype);
+    }
+
+    cell = uint16_t(found - mTiles.begin() + 1);
+    mFilled++;
+    return true;
+}
+
+/**
+ * Add the tiles a box touches to a contact manifold. Tiles next
+ * to each other in a row are added as one box.
+ * @param left Left edge of the box in virtual pixels
+ * @param top Top edge of the box in virtual pixels
+ * @param right Right edge of the box in virtual pixels
+ * @param bottom Bottom edge of the box in virtual pixels
+ * @param contacts Manifold to add to
+ * @return True if the box touches any tile
+ */
+bool TileMap::FindContacts(double left, double top, double right, double bottom,
+                           ContactManifold& contacts) const
+{
+    if (!IsActive())
+    {
+        return false;
+    }
+
+    // Touching the edge of a cell counts, as it does for items
+    int firstColumn = std::max(int(std::floor(left / TileSize)), 0);
+    int lastColumn = std::min(int(std::floor(right / TileSize)), mColumns - 1);
+    int firstRow = std::max(int(std::floor(top / TileSize)), 0);
+    int lastRow = std::min(int(std::floor(bottom / TileSize)), mRows - 1);
+
+    bool found = false;
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        const uint16_t* cells = &mCells[size_t(row) * mColumns];
+        int column = firstColumn;
+        while (column <= lastColumn)
+        {
+            if (cells[column] == 0)
+            {
+                column++;
+                continue;
+            }
+
+            int start = column;
+            while (column <= lastColumn && cells[column] != 0)
+            {
+                column++;
+            }
+
+            ContactManifold::Contact contact;
+            contact.left = start * TileSize;
+            contact.top = row * TileSize;
+            contact.right = column * TileSize;
+            contact.bottom = (row + 1) * TileSize;
+            contact.item = nullptr;
+            contact.fixed = true;
+            contacts.Add(contact);
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Draw the tiles in view on an unscaled graphics context, the
+ * way items are drawn with Item::DrawScaled
+ * @param gc graphics context in device pixels
+ * @param bitmaps Bitmaps at the display scale
+ * @param offset Scroll offset in virtual pixels
+ * @param width Width of the view in virtual pixels
+ */
+void TileMap::DrawScaled(std::shared_ptr<wxGraphicsContext> gc, ScaledBitmapCache& bitmaps,
+                         double offset, double width) const
+{
+    if (!IsActive())
+    {
+        return;
+    }
+
+    const double scale = bitmaps.GetScale();
+    int firstColumn = std::max(int(std::floor(offset / TileSize)), 0);
+    int lastColumn = std::min(int(std::floor((offset + width) / TileSize)), mColumns - 1);
+
+    for (int row = 0; row < mRows; row++)
+    {
+        const double top = std::round(row * TileSize * scale);
+        const double bottom = std::round((row + 1) * TileSize * scale);
+        for (int column = firstColumn; column <= lastColumn; column++)
+        {
+            int tile = mCells[size_t(row) * mColumns + column];
+            if (tile == 0)
+            {
+                continue;
+            }
+
+            auto bitmap = bitmaps.Get(mTiles[tile - 1]);
+            if (bitmap == nullptr)
+            {
+                continue;
+            }
+
+            const double left = std::round((column * TileSize - offset) * scale);
+            const double right = std::round(((column + 1) * TileSize - offset) * scale);
+            gc->DrawBitmap(*bitmap, left, top, right - left, bottom - top);
+        }
+    }
+}
+
+/**
+ * Draw the tiles in view into the software renderer's frame
+ * @param renderer Renderer with a frame begun
+ * @param offset Scroll offset in virtual pixels
+ * @param width Width of the view in virtual pixels
+ */
+void TileMap::DrawSoftware(SoftwareRenderer& renderer, double offset, double width) const
+{
+    if (!IsActive())
+    {
+        return;
+    }
+
+    const double scale = renderer.GetScale();
+    int firstColumn = std::max(int(std::floor(offset / TileSize)), 0);
+    int lastColumn = std::min(int(std::floor((offset + width) / TileSize)), mColumns - 1);
+
+    for (int row = 0; row < mRows; row++)
+    {
+        const int y = int(std::lround(row * TileSize * scale));
+        for (int column = firstColumn; column <= lastColumn; column++)
+        {
+            int tile = mCells[size_t(row) * mColumns + column];
+            if (tile == 0)
+            {
+                continue;
+            }
+
+            auto sprite = renderer.GetSprite(mTiles[tile - 1]);
+            if (sprite != nullptr)
+            {
+                renderer.Blit(*sprite, int(std::lround((column * TileSize - offset) * scale)), y);
+            }
+        }
+    }
+}
+
+/**
+ * Add the tiles in view to a render state
+ * @param state Render state being captured
+ * @param offset Scroll offset in virtual pixels
+ * @param width Width of the view in virtual pixels
+ */
+void TileMap::Capture(RenderState& state, double offset, double width) const
+{
+    if (!IsActive())
+    {
+        return;
+    }
+
+    int firstColumn = std::max(int(std::floor(offset / TileSize)), 0);
+    int lastColumn = std::min(int(std::floor((offset + width) / TileSize)), mColumns - 1);
+
+    for (int row = 0; row < mRows; row++)
+    {
+        for (int column = firstColumn; column <= lastColumn; column++)
+        {
+            int tile = mCells[size_t(row) * mColumns + column];
+            if (tile != 0)
+            {
+                state.AddSprite(mTiles[tile - 1], column * TileSize, row * TileSize, TileSize, TileSize);
+            }
+        }
+    }
+}
+
+/**
+ * Get the memory the map takes
+ * @return Bytes used
+ */
+size_t TileMap::GetMemoryUsed() const
+{
+    return mCells.capacity() * sizeof(uint16_t) + mTiles.capacity() * sizeof(const ItemArchetype*);
+}
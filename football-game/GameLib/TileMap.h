@@ -0,0 +1,119 @@
+/**
+ * @file TileMap.h
+ * @author Brennan Eagle
+ *
+ * Static terrain kept as a grid of tiles instead of items
+ */
+
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct ItemArchetype;
+class ContactManifold;
+class ScaledBitmapCache;
+class SoftwareRenderer;
+class RenderState;
+
+/**
+ * Static terrain kept as a grid of tiles instead of items.
+ *
+ * Platforms and walls are built from 32 pixel segments. A segment
+ * that lies exactly on a cell of the grid is stored as the number
+ * of its kind of tile in that cell, and no item is made for it.
+ * Finding the terrain the football touches then looks only at the
+ * cells under the football, and drawing looks only at the columns
+ * in view, however big the level is.
+ *
+ * Segments off the grid, outside the level, or on a cell that is
+ * already filled are left for the game to make into items. Moving
+ * platforms are never tiles.
+ */
+class TileMap
+{
+public:
+    /// Width and height of a cell in virtual pixels
+    static constexpr double TileSize = 32;
+
+    /// Most cells, so a huge level cannot use up memory
+    static const int MaxCells = 1 << 22;
+
+private:
+    /// Number of columns, 0 when the map is not in use
+    int mColumns = 0;
+
+    /// Number of rows
+    int mRows = 0;
+
+    /// Tile in each cell by row, 0 for an empty cell
+    std::vector<uint16_t> mCells;
+
+    /// Archetype of each tile, tile n at n - 1
+    std::vector<const ItemArchetype*> mTiles;
+
+    /// Number of cells filled
+    int mFilled = 0;
+
+public:
+    void Reset(double width, double height);
+    void Clear();
+    bool Place(const ItemArchetype* archetype, double x, double y);
+    bool FindContacts(double left, double top, double right, double bottom, ContactManifold& contacts) const;
+    void DrawScaled(std::shared_ptr<wxGraphicsContext> gc, ScaledBitmapCache& bitmaps,
+                    double offset, double width) const;
+    void DrawSoftware(SoftwareRenderer& renderer, double offset, double width) const;
+    void Capture(RenderState& state, double offset, double width) const;
+
+    /**
+     * Is the map in use for this level?
+     * @return True if the map has cells to place tiles in
+     */
+    bool IsActive() const { return mColumns > 0; }
+
+    /**
+     * Get the tile in a cell
+     * @param column Column of the cell
+     * @param row Row of the cell
+     * @return Tile number, 0 if the cell is empty or outside the map
+     */
+    int GetTile(int column, int row) const
+    {
+        if (column < 0 || row < 0 || column >= mColumns || row >= mRows)
+        {
+            return 0;
+        }
+        return mCells[size_t(row) * mColumns + column];
+    }
+
+    /**
+     * Get the archetype of a tile
+     * @param tile Tile number, not 0
+     * @return Archetype the tile is drawn with
+     */
+    const ItemArchetype* GetArchetype(int tile) const { return mTiles[tile - 1]; }
+
+    /**
+     * Get the number of columns
+     * @return Number of columns
+     */
+    int GetColumns() const { return mColumns; }
+
+    /**
+     * Get the number of rows
+     * @return Number of rows
+     */
+    int GetRows() const { return mRows; }
+
+    /**
+     * Get the number of cells filled
+     * @return Number of tiles placed
+     */
+    int GetFilled() const { return mFilled; }
+
+    size_t GetMemoryUsed() const;
+};
+
+#endif //TILEMAP_H
@@ -0,0 +1,87 @@
+/**
+ * @file TripleBuffer.h
+ * @author Brennan Eagle
+ *
+ * Hands the latest of a stream of values from one thread to another
+ */
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <array>
+#include <atomic>
+
+/**
+ * Hands the latest of a stream of values from one thread to another.
+ *
+ * There are three buffers. The writer fills the back one and
+ * publishes it, swapping it with the middle one. The reader
+ * takes the middle one when a new value has been published,
+ * swapping it with the front one it reads. Neither ever waits for
+ * the other, and each owns its buffer while it uses it: the writer
+ * can publish any number of values while the reader holds one, and
+ * the reader only ever sees whole values. Values not taken before
+ * the next is published are dropped.
+ *
+ * One thread may write and one may read.
+ *
+ * @tparam T Value type. Buffers are reused, so a value that holds
+ * vectors keeps their memory from one use to the next.
+ */
+template<class T>
+class TripleBuffer
+{
+private:
+    /// Set in the middle index when it holds a value not yet taken
+    static const int Fresh = 4;
+
+    /// The buffers
+    std::array<T, 3> mBuffers;
+
+    /// Buffer between the writer and the reader, and the Fresh bit
+    std::atomic<int> mMiddle{1};
+
+    /// Buffer the writer fills
+    int mBack = 0;
+
+    /// Buffer the reader reads
+    int mFront = 2;
+
+public:
+    /**
+     * Get the buffer to fill. Writer only.
+     * @return Back buffer, holding an old value
+     */
+    T& GetBack() { return mBuffers[mBack]; }
+
+    /**
+     * Publish the back buffer and take another to fill. Writer only.
+     */
+    void Publish()
+    {
+        mBack = mMiddle.exchange(mBack | Fresh, std::memory_order_acq_rel) & ~Fresh;
+    }
+
+    /**
+     * Take the latest value if one has been published since the
+     * last call. Reader only.
+     * @return True if the front buffer changed
+     */
+    bool Update()
+    {
+        if ((mMiddle.load(std::memory_order_relaxed) & Fresh) == 0)
+        {
+            return false;
+        }
+        mFront = mMiddle.exchange(mFront, std::memory_order_acq_rel) & ~Fresh;
+        return true;
+    }
+
+    /**
+     * Get the value taken by the last Update. Reader only.
+     * @return Front buffer
+     */
+    const T& GetFront() const { return mBuffers[mFront]; }
+};
+
+#endif //TRIPLEBUFFER_H
@@ -12,7 +12,16 @@
  * @param game Game this wall is in
  * @param filename Image file for this wall
  */
-Wall::Wall(Game* game, const std::wstring& filename) : Item(game, filename)
+Wall::Wall(Game* game, const std::wstring& filename) : ItemOf(game, filename, CollisionClass::Terrain)
+{
+}
+
+/**
+ * Constructor
+ * @param game Game this wall is in
+ * @param archetype Archetype for this wall
+ */
+Wall::Wall(Game* game, const ItemArchetype* archetype) : ItemOf(game, archetype)
 {
 }
 
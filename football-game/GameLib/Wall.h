@@ -15,7 +15,7 @@ class CollisionVisitor;
 /**
  * Wall class
  */
-class Wall : public Item
+class Wall : public ItemOf<Wall>
 {
 public:
     /// Default constructor (disabled)
@@ -28,6 +28,7 @@ public:
     void operator=(const Wall &) = delete;
 
     Wall(Game* game, const std::wstring& filename);
+    Wall(Game* game, const ItemArchetype* archetype);
 
     void Accept(CollisionVisitor* visitor) override;
 };
@@ -0,0 +1,116 @@
+/**
+ * @file WorkerPool.cpp
+ * @author Brennan Eagle
+ */
+
+#include "pch.h"
+#include "WorkerPool.h"
+
+/**
+ * Constructor
+ * @param threads Number of threads tasks run on, counting the
+ * thread that calls Run, so 1 starts none
+ */
+WorkerPool::WorkerPool(int threads)
+{
+    for (int t = 1; t < threads; t++)
+    {
+        mThreads.emplace_back(&WorkerPool::Work, this);
+    }
+}
+
+/**
+ * Destructor
+ */
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    for (auto& thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+/**
+ * Run tasks until none are left
+ * @param task Task to run
+ * @param count Number of tasks
+ */
+void WorkerPool::Drain(const std::function<void(size_t)>& task, size_t count)
+{
+    for (size_t i = mNext++; i < count; i = mNext++)
+    {
+        task(i);
+    }
+}
+
+/**
+ * Run by each thread: wait for a run, help with it, and say so
+ */
+void WorkerPool::Work()
+{
+    unsigned seen = 0;
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mWake.wait(lock, [this, seen]() { return mStopping || mGeneration != seen; });
+        if (mStopping)
+        {
+            return;
+        }
+        seen = mGeneration;
+
+        auto task = mTask;
+        size_t count = mCount;
+        lock.unlock();
+        Drain(*task, count);
+        lock.lock();
+
+        if (++mFinished == mThreads.size())
+        {
+            mDone.notify_all();
+        }
+    }
+}
+
+/**
+ * Run numbered tasks on the threads and the calling thread.
+ *
+ * Every thread checks in before Run returns, so none can still
+ * be looking at this run's task when the next run starts.
+ *
+ * @param count Number of tasks
+ * @param task Called once with each number from 0 to count - 1
+ */
+void WorkerPool::Run(size_t count, const std::function<void(size_t)>& task)
+{
+    std::lock_guard<std::mutex> run(mRunMutex);
+    if (mThreads.empty() || count <= 1)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTask = &task;
+        mCount = count;
+        mNext = 0;
+        mFinished = 0;
+        mGeneration++;
+    }
+    mWake.notify_all();
+
+    Drain(task, count);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this]() { return mFinished == mThreads.size(); });
+    mTask = nullptr;
+}
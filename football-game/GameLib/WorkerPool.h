@@ -0,0 +1,86 @@
+/**
+ * @file WorkerPool.h
+ * @author Brennan Eagle
+ *
+ * Threads kept waiting to share out numbered tasks
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Threads kept waiting to share out numbered tasks.
+ *
+ * Run hands tasks 0 to count - 1 to the threads and to the thread
+ * that called it, each taking the next task not yet started, and
+ * returns when all are done. The threads are started once and
+ * wait between runs, so a run costs a wake up rather than
+ * starting and joining threads. Runs from several threads take
+ * turns.
+ */
+class WorkerPool
+{
+private:
+    /// Threads besides the one calling Run
+    std::vector<std::thread> mThreads;
+
+    /// Held for the whole of a run, so runs take turns
+    std::mutex mRunMutex;
+
+    /// Protects the run below
+    std::mutex mMutex;
+
+    /// Wakes the threads for a run, or to stop
+    std::condition_variable mWake;
+
+    /// Tells Run every thread is done
+    std::condition_variable mDone;
+
+    /// Task of the current run
+    const std::function<void(size_t)>* mTask = nullptr;
+
+    /// Number of tasks in the current run
+    size_t mCount = 0;
+
+    /// Next task to start
+    std::atomic<size_t> mNext{0};
+
+    /// Counts runs, so a thread can tell a new one has started
+    unsigned mGeneration = 0;
+
+    /// Threads done with the current run
+    size_t mFinished = 0;
+
+    /// Should the threads exit?
+    bool mStopping = false;
+
+    void Work();
+    void Drain(const std::function<void(size_t)>& task, size_t count);
+
+public:
+    explicit WorkerPool(int threads);
+    ~WorkerPool();
+
+    /// Copy constructor (disabled)
+    WorkerPool(const WorkerPool &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const WorkerPool &) = delete;
+
+    /**
+     * Get the number of threads tasks run on, counting the caller
+     * @return Number of threads
+     */
+    int GetThreads() const { return int(mThreads.size()) + 1; }
+
+    void Run(size_t count, const std::function<void(size_t)>& task);
+};
+
+#endif //WORKERPOOL_H
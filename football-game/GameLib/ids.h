@@ -16,6 +16,13 @@ enum IDs
     IDM_LEVELTWO,
     IDM_LEVELTHREE,
     IDM_RESTARTLEVEL,
+    IDM_SOFTWARERENDERER,
+    IDM_MEMORYREPORT,
+    IDM_WRITETELEMETRY,
+    IDM_LOWLATENCY,
+    IDM_LATENCYREPORT,
+    IDM_TILEDTERRAIN,
+    IDM_SIMULATIONTHREAD,
 };
 
 #endif //IDS_H
@@ -0,0 +1,112 @@
+/**
+ * @file AssetPackTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <AssetPack.h>
+#include <AssetCache.h>
+#include <LevelData.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+/**
+ * Read a whole file
+ * @param path File to read
+ * @return Its bytes
+ */
+static std::string ReadFile(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+/**
+ * Make an empty directory for a test, with an image and a level
+ * in it that the build directory does not have
+ * @param name Directory name
+ * @return Directory
+ */
+static std::filesystem::path MakeDirectory(const std::string& name)
+{
+    auto dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "images");
+    std::filesystem::create_directories(dir / "levels");
+    std::filesystem::copy_file("images/coin10.png", dir / "images" / "packed.png");
+    std::filesystem::copy_file("levels/level1.xml", dir / "levels" / "packed.xml");
+    return dir;
+}
+
+TEST(AssetPackTest, WriteAndFind)
+{
+    auto dir = MakeDirectory("assetpacktest");
+    auto file = (dir / "assets.pack").wstring();
+    ASSERT_TRUE(AssetPack::Write(file, dir.wstring(), {L"images/packed.png", L"levels/packed.xml"}));
+
+    AssetPack pack;
+    ASSERT_TRUE(pack.Open(file));
+    EXPECT_TRUE(pack.IsOpen());
+    EXPECT_EQ(pack.GetCount(), 2u);
+
+    // The assets are the files, byte for byte
+    const char* data = nullptr;
+    size_t size = 0;
+    ASSERT_TRUE(pack.Find(L"images/packed.png", data, size));
+    EXPECT_EQ(std::string(data, size), ReadFile(dir / "images" / "packed.png"));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % 16, 0u);
+    ASSERT_TRUE(pack.Find(L"levels/./packed.xml", data, size));
+    EXPECT_EQ(std::string(data, size), ReadFile(dir / "levels" / "packed.xml"));
+    EXPECT_FALSE(pack.Find(L"images/coin10.png", data, size));
+
+    // A missing asset fails the whole pack
+    EXPECT_FALSE(AssetPack::Write((dir / "missing.pack").wstring(), dir.wstring(), {L"images/none.png"}));
+
+    // A damaged pack is not opened
+    pack.Close();
+    std::filesystem::resize_file(dir / "assets.pack", std::filesystem::file_size(dir / "assets.pack") - 1);
+    EXPECT_FALSE(pack.Open(file));
+    EXPECT_FALSE(pack.IsOpen());
+    EXPECT_EQ(pack.GetCount(), 0u);
+    EXPECT_FALSE(pack.Open((dir / "none.pack").wstring()));
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(AssetPackTest, AssetCache)
+{
+    auto dir = MakeDirectory("assetpackcache");
+    auto file = (dir / "assets.pack").wstring();
+    ASSERT_TRUE(AssetPack::Write(file, dir.wstring(), {L"images/packed.png", L"levels/packed.xml"}));
+
+    AssetCache assets(true);
+    EXPECT_EQ(assets.GetPack(), nullptr);
+    EXPECT_FALSE(assets.OpenPack((dir / "none.pack").wstring()));
+    EXPECT_EQ(assets.GetPack(), nullptr);
+    ASSERT_TRUE(assets.OpenPack(file));
+    ASSERT_NE(assets.GetPack(), nullptr);
+
+    // Assets in the pack are read from it
+    auto level = assets.GetLevel(L"levels/packed.xml");
+    EXPECT_TRUE(level->GetError().empty());
+    auto loose = assets.GetLevel(L"levels/level1.xml");
+    EXPECT_TRUE(loose->GetError().empty());
+    EXPECT_EQ(level->GetWidth(), loose->GetWidth());
+
+    auto coin = assets.GetArchetype(L"images/coin10.png", CollisionClass::Pickup);
+    auto packed = assets.GetArchetype(L"images/packed.png", CollisionClass::Pickup);
+    EXPECT_GT(packed->width, 0);
+    EXPECT_EQ(packed->width, coin->width);
+    EXPECT_EQ(packed->height, coin->height);
+
+    // Preloading reads from the pack too
+    AssetCache preloaded(true);
+    ASSERT_TRUE(preloaded.OpenPack(file));
+    EXPECT_EQ(preloaded.Preload({L"images/packed.png", L"images/coin10.png"}), 2);
+    EXPECT_EQ(preloaded.GetArchetype(L"images/packed.png", CollisionClass::Pickup)->width, coin->width);
+
+    std::filesystem::remove_all(dir);
+}
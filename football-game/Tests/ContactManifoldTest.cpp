@@ -0,0 +1,107 @@
+/**
+ * @file ContactManifoldTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Game.h>
+#include <Football.h>
+#include <Platform.h>
+#include <Wall.h>
+#include <MovingPlatform.h>
+#include <ContactManifold.h>
+
+/// Platform segment image, 32x32
+const std::wstring segmentImage = L"images/metalMid.png";
+
+/// Wall segment image, 32x32
+const std::wstring wallImage = L"images/wall1.png";
+
+TEST(ContactManifoldTest, MergesSegments)
+{
+    Game game;
+    Platform left(&game, segmentImage);
+    left.SetLocation(496, 716);
+    Platform right(&game, segmentImage);
+    right.SetLocation(528, 716);
+    Wall upper(&game, wallImage);
+    upper.SetLocation(800, 400);
+    Wall lower(&game, wallImage);
+    lower.SetLocation(800, 432);
+
+    ContactManifold contacts;
+    contacts.Add(&left);
+    contacts.Add(&upper);
+    contacts.Add(&right);
+    contacts.Add(&lower);
+
+    // A floor and a wall
+    ASSERT_EQ(2, contacts.GetCount());
+    EXPECT_EQ(2, contacts.GetMerged());
+    for (int i = 0; i < contacts.GetCount(); i++)
+    {
+        auto& contact = contacts.GetContact(i);
+        if (contact.top == 700)
+        {
+            EXPECT_DOUBLE_EQ(480, contact.left);
+            EXPECT_DOUBLE_EQ(544, contact.right);
+        }
+        else
+        {
+            EXPECT_DOUBLE_EQ(384, contact.top);
+            EXPECT_DOUBLE_EQ(448, contact.bottom);
+        }
+    }
+
+    contacts.Clear();
+    EXPECT_EQ(0, contacts.GetCount());
+    EXPECT_EQ(0, contacts.GetMerged());
+}
+
+TEST(ContactManifoldTest, MovingPlatformsStayApart)
+{
+    Game game;
+    Platform floor(&game, segmentImage);
+    floor.SetLocation(496, 716);
+    MovingPlatform moving(&game, segmentImage);
+    moving.SetLocation(528, 716);
+
+    // The football rides the moving platform, so it keeps its own box
+    ContactManifold contacts;
+    contacts.Add(&floor);
+    contacts.Add(&moving);
+    EXPECT_EQ(2, contacts.GetCount());
+    EXPECT_EQ(0, contacts.GetMerged());
+}
+
+TEST(ContactManifoldTest, NoSeamJitter)
+{
+    Game game;
+    Platform left(&game, segmentImage);
+    left.SetLocation(496, 716);
+    Platform right(&game, segmentImage);
+    right.SetLocation(528, 716);
+
+    // Sunk 5 pixels into the floor, 2 pixels past the seam
+    Football football(&game);
+    double x = 514 - football.GetWidth() / 2;
+    football.SetLocation(x, 705 - football.GetHeight() / 2);
+    football.SetYVelocity(400);
+
+    // The right segment alone is closer through its side than its top
+    Football alone(&game);
+    alone.SetLocation(football.GetX(), football.GetY());
+    alone.CollisionResolve(&right);
+    EXPECT_DOUBLE_EQ(x - 2, alone.GetX());
+
+    // Merged, the floor pushes straight up
+    ContactManifold contacts;
+    contacts.Add(&left);
+    contacts.Add(&right);
+    football.CollisionResolve(contacts);
+    EXPECT_DOUBLE_EQ(x, football.GetX());
+    EXPECT_DOUBLE_EQ(700, football.GetY() + football.GetHeight() / 2);
+    EXPECT_TRUE(football.GetGrounded());
+    EXPECT_EQ(0, football.GetYVelocity());
+}
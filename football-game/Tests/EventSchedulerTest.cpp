@@ -0,0 +1,87 @@
+/**
+ * @file EventSchedulerTest.cpp
+ *
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <EventScheduler.h>
+
+/**
+ * Advance a scheduler in 60 Hz steps
+ * @param scheduler Scheduler to advance
+ * @param seconds Total time to advance
+ */
+static void Run(EventScheduler& scheduler, double seconds)
+{
+    for (int i = 0; i < int(seconds * 60); i++)
+    {
+        scheduler.Advance(1.0 / 60);
+    }
+}
+
+TEST(EventSchedulerTest, OneShot)
+{
+    EventScheduler scheduler;
+    int fired = 0;
+    auto handle = scheduler.Schedule(2.0, [&fired]() { fired++; });
+
+    ASSERT_TRUE(scheduler.IsPending(handle));
+    Run(scheduler, 1.9);
+    ASSERT_EQ(0, fired);
+
+    Run(scheduler, 0.2);
+    ASSERT_EQ(1, fired);
+    ASSERT_FALSE(scheduler.IsPending(handle));
+
+    // Fires only once
+    Run(scheduler, 5);
+    ASSERT_EQ(1, fired);
+}
+
+TEST(EventSchedulerTest, Repeating)
+{
+    EventScheduler scheduler;
+    int fired = 0;
+    auto handle = scheduler.ScheduleRepeating(0.5, [&fired]() { fired++; });
+
+    Run(scheduler, 2.1);
+    ASSERT_EQ(4, fired);
+    ASSERT_TRUE(scheduler.IsPending(handle));
+
+    ASSERT_TRUE(scheduler.Cancel(handle));
+    Run(scheduler, 2);
+    ASSERT_EQ(4, fired);
+    ASSERT_EQ(0, scheduler.GetPendingCount());
+}
+
+TEST(EventSchedulerTest, Cancel)
+{
+    EventScheduler scheduler;
+    int fired = 0;
+    auto handle = scheduler.Schedule(1.0, [&fired]() { fired++; });
+    auto copy = handle;
+
+    ASSERT_TRUE(scheduler.Cancel(handle));
+    ASSERT_FALSE(scheduler.IsPending(copy));
+
+    // A second cancel is harmless
+    ASSERT_FALSE(scheduler.Cancel(copy));
+
+    Run(scheduler, 2);
+    ASSERT_EQ(0, fired);
+}
+
+TEST(EventSchedulerTest, LongDelay)
+{
+    // Longer than one trip around the wheel
+    EventScheduler scheduler(0.01, 16);
+    int fired = 0;
+    scheduler.Schedule(3.0, [&fired]() { fired++; });
+
+    Run(scheduler, 2.9);
+    ASSERT_EQ(0, fired);
+    Run(scheduler, 0.2);
+    ASSERT_EQ(1, fired);
+}
@@ -0,0 +1,568 @@
+/**
+ * @file GameTest.cpp
+ *
+ * @author Brennan Eagle
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Game.h>
+#include <GameSnapshot.h>
+#include <BatchRunner.h>
+#include <LevelSolver.h>
+#include <Enemy.h>
+#include <Platform.h>
+#include <Wall.h>
+#include <Football.h>
+#include <PowerUp.h>
+#include <ScaledBitmapCache.h>
+#include <Telemetry.h>
+#include <cmath>
+
+using namespace std;
+
+/// Level with one enemy near the start and one far away
+string activityXML = R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="8192" height="1024" start-y="500" start-x="468">
+  <declarations>
+    <enemy id="i001" image="U-M.png"/>
+  </declarations>
+  <items>
+    <enemy id="i001" x="800" y="300"/>
+    <enemy id="i001" x="6000" y="300"/>
+  </items>
+</level>
+)";
+
+/**
+ * Write a level to a temporary file
+ * @param name File name in the temporary directory
+ * @param xml Level contents
+ * @return Path to the file
+ */
+static std::filesystem::path WriteLevel(const string& name, const string& xml)
+{
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path);
+    out << xml;
+    return path;
+}
+
+TEST(GameTest, FarEntitiesSleep)
+{
+    auto tmp = WriteLevel("level_activity.game", activityXML);
+
+    Game game;
+    game.Load(tmp.wstring());
+    game.Update(0.01);
+
+    // The football and the near enemy are awake, the far enemy sleeps
+    EXPECT_EQ(game.GetActiveCount(), 2);
+    EXPECT_EQ(game.GetSleepingCount(), 1);
+
+    // A huge margin keeps everything awake
+    game.SetActivityMargin(100);
+    game.Update(0.01);
+    EXPECT_EQ(game.GetActiveCount(), 3);
+    EXPECT_EQ(game.GetSleepingCount(), 0);
+
+    std::filesystem::remove(tmp);
+}
+
+/// Level with a power-up above a floor near the start
+string powerUpXML = R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="8192" height="1024" start-y="900" start-x="468">
+  <declarations>
+    <platform id="i001" left-image="metalLeft.png" mid-image="metalMid.png" right-image="metalRight.png"/>
+    <power-up id="i002" image="sparty.png"/>
+  </declarations>
+  <items>
+    <platform id="i001" x="4096" y="1008" width="8192" height="32"/>
+    <power-up id="i002" x="700" y="300"/>
+  </items>
+</level>
+)";
+
+TEST(GameTest, ActivatedPowerUpStaysAwake)
+{
+    auto tmp = WriteLevel("level_powerup.game", powerUpXML);
+
+    Game game;
+    game.Load(tmp.wstring());
+    PowerUp* powerUp = nullptr;
+    for (int i = 0; i < int(game.GetRosterSize()); i++)
+    {
+        if (auto found = dynamic_cast<PowerUp*>(game.GetRosterItem(i)))
+        {
+            powerUp = found;
+        }
+    }
+    ASSERT_NE(nullptr, powerUp);
+    ASSERT_TRUE(powerUp->TryActivate());
+    game.Update(0.01);
+    double items = game.CountItems();
+
+    // The view leaves it behind, but it keeps falling and is removed
+    game.GetFootball()->SetLocation(6000, 900);
+    game.Update(0.01);
+    double y = powerUp->GetY();
+    game.Update(0.1);
+    EXPECT_GT(powerUp->GetY(), y);
+    for (int i = 0; i < 100; i++)
+    {
+        game.Update(0.05);
+    }
+    EXPECT_EQ(items - 1, game.CountItems());
+
+    std::filesystem::remove(tmp);
+}
+
+TEST(GameTest, SnapshotRestore)
+{
+    auto tmp = WriteLevel("level_snapshot.game", activityXML);
+
+    Game game;
+    game.Load(tmp.wstring());
+    auto football = game.GetFootball();
+    double startX = football->GetX();
+    double startY = football->GetY();
+    double items = game.CountItems();
+
+    GameSnapshot snapshot;
+    game.Snapshot(snapshot);
+
+    // Let the football fall and move the far enemy
+    for (int i = 0; i < 10; i++)
+    {
+        game.Update(0.05);
+    }
+    ASSERT_NE(football->GetY(), startY);
+
+    auto far = game.GetRosterItem(int(game.GetRosterSize()) - 1);
+    ASSERT_NE(far, nullptr);
+    double farX = far->GetX();
+    far->SetLocation(0, 0);
+
+    ASSERT_TRUE(game.Restore(snapshot));
+    EXPECT_DOUBLE_EQ(football->GetX(), startX);
+    EXPECT_DOUBLE_EQ(football->GetY(), startY);
+    EXPECT_DOUBLE_EQ(football->GetYVelocity(), 0);
+    EXPECT_DOUBLE_EQ(game.GetLevelTime(), 0);
+    EXPECT_DOUBLE_EQ(far->GetX(), farX);
+    EXPECT_EQ(game.CountItems(), items);
+
+    std::filesystem::remove(tmp);
+}
+
+TEST(GameTest, SnapshotFile)
+{
+    GameSnapshot snapshot;
+    snapshot.Write(12);
+    snapshot.Write(3.5);
+
+    auto path = std::filesystem::temp_directory_path() / "snapshot.sav";
+    ASSERT_TRUE(snapshot.Save(path.wstring()));
+
+    GameSnapshot loaded;
+    ASSERT_TRUE(loaded.Load(path.wstring()));
+    int i = 0;
+    double d = 0;
+    loaded.Read(i);
+    loaded.Read(d);
+    EXPECT_EQ(i, 12);
+    EXPECT_DOUBLE_EQ(d, 3.5);
+    EXPECT_TRUE(loaded.IsOk());
+
+    // Reading past the end marks the snapshot bad
+    loaded.Read(i);
+    EXPECT_FALSE(loaded.IsOk());
+
+    // Files that are not snapshots are rejected
+    auto level = WriteLevel("not_a_snapshot.game", activityXML);
+    EXPECT_FALSE(loaded.Load(level.wstring()));
+
+    // A size larger than the file is rejected without reading it
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        uint64_t size = uint64_t(1) << 60;
+        file.seekp(8);
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    }
+    EXPECT_FALSE(loaded.Load(path.wstring()));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(level);
+}
+
+TEST(GameTest, SaveOpenedLevel)
+{
+    auto tmp = WriteLevel("level_saved.game", activityXML);
+    auto path = std::filesystem::temp_directory_path() / "opened.sav";
+
+    // A level opened from a file rather than by number
+    Game game;
+    game.Load(tmp.wstring());
+    for (int i = 0; i < 10; i++)
+    {
+        game.Update(0.05);
+    }
+    double y = game.GetFootball()->GetY();
+    double time = game.GetLevelTime();
+    game.Save(path.wstring());
+
+    game.LoadLevel(0);
+    ASSERT_NE(game.GetLevelFile(), tmp.wstring());
+    game.Load(path.wstring());
+    EXPECT_EQ(game.GetLevelFile(), tmp.wstring());
+    EXPECT_DOUBLE_EQ(game.GetFootball()->GetY(), y);
+    EXPECT_DOUBLE_EQ(game.GetLevelTime(), time);
+
+    // A save that no longer fits its level leaves the game alone
+    WriteLevel("level_saved.game", R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="8192" height="1024" start-y="500" start-x="468">
+  <declarations>
+    <enemy id="i001" image="U-M.png"/>
+  </declarations>
+  <items>
+    <enemy id="i001" x="800" y="300"/>
+  </items>
+</level>
+)");
+    Game other;
+    other.LoadLevel(0);
+    std::wstring file = other.GetLevelFile();
+    double items = other.CountItems();
+    other.Update(0.1);
+    double x = other.GetFootball()->GetX();
+    other.Load(path.wstring());
+    EXPECT_EQ(other.GetLevelFile(), file);
+    EXPECT_EQ(other.CountItems(), items);
+    EXPECT_DOUBLE_EQ(other.GetFootball()->GetX(), x);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(tmp);
+}
+
+/// The activity level after an edit: the near enemy moved,
+/// the far enemy removed and a new enemy added
+string editedXML = R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="8192" height="1024" start-y="500" start-x="468">
+  <declarations>
+    <enemy id="i001" image="U-M.png"/>
+  </declarations>
+  <items>
+    <enemy id="i001" x="900" y="300"/>
+    <enemy id="i001" x="3000" y="300"/>
+  </items>
+</level>
+)";
+
+TEST(GameTest, HotReload)
+{
+    auto tmp = WriteLevel("level_hotreload.game", activityXML);
+
+    Game game;
+    game.Load(tmp.wstring());
+    for (int i = 0; i < 3; i++)
+    {
+        game.Update(0.05);
+    }
+
+    auto football = game.GetFootball();
+    double footballX = football->GetX();
+    double footballY = football->GetY();
+    double levelTime = game.GetLevelTime();
+
+    // Roster: the football, then the items in file order
+    auto nearEnemy = game.GetRosterItem(1);
+    ASSERT_NE(nearEnemy, nullptr);
+
+    WriteLevel("level_hotreload.game", editedXML);
+    LevelData edited;
+    ASSERT_TRUE(edited.Load(tmp.wstring()));
+    game.HotReload(edited);
+
+    // The football and the clock carry on where they were
+    EXPECT_DOUBLE_EQ(football->GetX(), footballX);
+    EXPECT_DOUBLE_EQ(football->GetY(), footballY);
+    EXPECT_DOUBLE_EQ(game.GetLevelTime(), levelTime);
+
+    // The near enemy is the same item, moved
+    EXPECT_EQ(game.GetRosterSize(), 3u);
+    EXPECT_EQ(game.GetRosterItem(1), nearEnemy);
+    EXPECT_DOUBLE_EQ(nearEnemy->GetX(), 900);
+    EXPECT_EQ(game.CountItems(), 3);
+
+    // The new enemy is where the far enemy was in the roster
+    auto added = game.GetRosterItem(2);
+    ASSERT_NE(added, nullptr);
+    EXPECT_DOUBLE_EQ(added->GetX(), 3000);
+
+    std::filesystem::remove(tmp);
+}
+
+/// Level with a background behind the football and one enemy
+string layersXML = R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="1024" height="1024" start-y="500" start-x="468">
+  <declarations>
+    <background id="i001" image="background0.png"/>
+    <enemy id="i002" image="U-M.png"/>
+  </declarations>
+  <items>
+    <background id="i001" x="512" y="512"/>
+    <enemy id="i002" x="800" y="300"/>
+  </items>
+</level>
+)";
+
+TEST(GameTest, CollisionLayers)
+{
+    auto tmp = WriteLevel("level_layers.game", layersXML);
+
+    Game game;
+    game.Load(tmp.wstring());
+
+    // The football tests terrain, pickups, hazards and triggers
+    auto football = game.GetFootball();
+    EXPECT_EQ(football->GetCollisionLayer(), CollisionLayer::None);
+    EXPECT_TRUE(football->GetCollisionMask() & CollisionLayer::Hazard);
+    EXPECT_FALSE(football->GetCollisionMask() & CollisionLayer::Decoration);
+
+    game.Update(0.01);
+
+    // The background is rejected by mask, the enemy is tested
+    EXPECT_EQ(game.GetMaskRejects(), 1);
+    EXPECT_EQ(game.GetNarrowTests(), 1);
+
+    std::filesystem::remove(tmp);
+}
+
+TEST(GameTest, HeadlessBatch)
+{
+    // Games on a headless cache make no bitmaps and share archetypes
+    auto assets = std::make_shared<AssetCache>(true);
+    Game first(assets);
+    Game second(assets);
+    EXPECT_EQ(first.GetArchetype(L"images/coin10.png", CollisionClass::Pickup),
+              second.GetArchetype(L"images/coin10.png", CollisionClass::Pickup));
+    EXPECT_EQ(first.GetCachedImage(L"images/coin10.png"), nullptr);
+    EXPECT_GT(first.GetArchetype(L"images/coin10.png", CollisionClass::Pickup)->width, 0);
+
+    BatchRunner runner(assets, 2);
+    runner.SetPolicy([](Game& game, int instance, long tick) {
+        game.ApplyInput(false, false, false);
+    });
+
+    // Standing still never reaches the goal, so every tick runs
+    auto result = runner.Run(4, 1, 10);
+    EXPECT_EQ(result.instances, 4);
+    EXPECT_EQ(result.threads, 2);
+    EXPECT_EQ(result.ticks, 40);
+    EXPECT_EQ(result.completed, 0);
+}
+
+TEST(GameTest, SnapshotDelta)
+{
+    GameSnapshot base;
+    GameSnapshot state;
+    for (int i = 0; i < 100; i++)
+    {
+        base.Write(i);
+        state.Write(i == 50 ? -1 : i);
+    }
+    state.Write(7);
+
+    // Only the changed value and the added one are stored
+    GameSnapshot delta;
+    delta.MakeDelta(base, state);
+    EXPECT_LT(delta.GetSize(), 40u);
+
+    GameSnapshot rebuilt;
+    ASSERT_TRUE(rebuilt.ApplyDelta(base, delta));
+    EXPECT_EQ(rebuilt.GetData(), state.GetData());
+}
+
+/// A floor with a goal post a short run to the right of the start
+string solverXML = R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="2048" height="1024" start-y="500" start-x="468">
+  <declarations>
+    <platform id="i001" left-image="metalLeft.png" mid-image="metalMid.png" right-image="metalRight.png"/>
+    <goalpost id="i002" image="goalpost.png"/>
+  </declarations>
+  <items>
+    <platform id="i001" x="1024" y="720" width="2048" height="32"/>
+    <goalpost id="i002" x="900" y="620"/>
+  </items>
+</level>
+)";
+
+TEST(GameTest, SolveLevel)
+{
+    auto tmp = WriteLevel("level_solver.game", solverXML);
+
+    Game game;
+    game.Load(tmp.wstring());
+    double startX = game.GetFootball()->GetX();
+
+    LevelSolver solver(&game);
+    LevelSolver::Options options;
+    options.maxTime = 10;
+    auto result = solver.Solve(options);
+
+    // Running right reaches the goal post in a bit over a second
+    ASSERT_TRUE(result.solved);
+    EXPECT_LT(result.time, 3);
+    EXPECT_GT(result.expansions, 0);
+    EXPECT_FALSE(result.actions.empty());
+
+    // Searching by time alone finds a run no faster
+    options.astar = false;
+    options.maxExpansions = 20000;
+    auto uniform = solver.Solve(options);
+    ASSERT_TRUE(uniform.solved);
+    EXPECT_NEAR(uniform.time, result.time, 1e-9);
+    EXPECT_GE(uniform.expansions, result.expansions);
+
+    // The game is back at the start and still on its level
+    EXPECT_DOUBLE_EQ(game.GetFootball()->GetX(), startX);
+    EXPECT_FALSE(game.IsLevelComplete());
+
+    std::filesystem::remove(tmp);
+}
+
+TEST(GameTest, ScaledBitmaps)
+{
+    Game game;
+    auto coin = game.GetArchetype(L"images/coin10.png", CollisionClass::Pickup);
+
+    ScaledBitmapCache bitmaps;
+    bitmaps.SetScale(0.5);
+
+    // Bitmaps are resampled to their size on the screen, once
+    auto bitmap = bitmaps.Get(coin);
+    ASSERT_NE(bitmap, nullptr);
+    EXPECT_EQ(bitmap->GetWidth(), std::lround(coin->width * 0.5));
+    EXPECT_EQ(bitmap->GetHeight(), std::lround(coin->height * 0.5));
+    EXPECT_EQ(bitmaps.Get(coin), bitmap);
+    EXPECT_EQ(bitmaps.GetResamples(), 1);
+
+    // The same scale keeps them, a new one drops them
+    bitmaps.SetScale(0.5);
+    EXPECT_EQ(bitmaps.GetCount(), 1u);
+    bitmaps.SetScale(0.75);
+    EXPECT_EQ(bitmaps.GetCount(), 0u);
+
+    // Headless archetypes have nothing to draw
+    AssetCache headless(true);
+    EXPECT_EQ(bitmaps.Get(headless.GetArchetype(L"images/coin10.png", CollisionClass::Pickup)), nullptr);
+}
+
+TEST(GameTest, MissingImages)
+{
+    // A background without an image loads as an item that is not
+    // seen. Terrain and enemies without their images are rejected.
+    string xml = R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="2048" height="1024" start-y="900" start-x="400">
+  <declarations>
+    <background id="i001"/>
+    <platform id="i002" left-image="metalLeft.png" right-image="metalRight.png"/>
+    <wall id="i003"/>
+    <enemy id="i004"/>
+  </declarations>
+  <items>
+    <background id="i001" x="512" y="512"/>
+    <platform id="i002" x="1024" y="1008" width="256" height="32"/>
+    <wall id="i003" x="800" y="800" width="32" height="128"/>
+    <enemy id="i004" x="900" y="300"/>
+  </items>
+</level>
+)";
+    auto tmp = WriteLevel("level_missing.game", xml);
+
+    Game game;
+    game.Load(tmp.wstring());
+
+    // The football and the background
+    ASSERT_EQ(2u, game.GetRosterSize());
+    for (int i = 0; i < int(game.GetRosterSize()); i++)
+    {
+        auto item = game.GetRosterItem(i);
+        EXPECT_EQ(nullptr, dynamic_cast<Wall*>(item));
+        EXPECT_EQ(nullptr, dynamic_cast<Enemy*>(item));
+        EXPECT_EQ(nullptr, dynamic_cast<Platform*>(item));
+    }
+    game.Update(0.01);
+
+    wxImage image(1024, 768);
+    std::shared_ptr<wxGraphicsContext> graphics(wxGraphicsContext::Create(image));
+    game.OnDraw(graphics, image.GetWidth(), image.GetHeight());
+    game.SetSoftwareRendering(true);
+    game.OnDraw(graphics, image.GetWidth(), image.GetHeight());
+
+    bool empty = false;
+    for (int i = 0; i < int(game.GetRosterSize()); i++)
+    {
+        auto item = game.GetRosterItem(i);
+        ASSERT_NE(nullptr, item->GetArchetype());
+        empty = empty || item->GetArchetype() == ItemArchetype::Empty();
+    }
+    EXPECT_TRUE(empty);
+
+    std::filesystem::remove(tmp);
+}
+
+TEST(GameTest, MemoryReport)
+{
+    auto tmp = WriteLevel("level_memory.game", activityXML);
+
+    Game game(std::make_shared<AssetCache>(true));
+    game.Load(tmp.wstring());
+    auto report = game.GetMemoryReport();
+
+    // Two enemies and the football, by type
+    auto& types = report.GetItemTypes();
+    ASSERT_EQ(types.count(L"Enemy"), 1u);
+    EXPECT_EQ(types.at(L"Enemy").count, 2u);
+    EXPECT_EQ(types.at(L"Enemy").bytes, 2 * sizeof(Enemy));
+    EXPECT_EQ(types.at(L"Football").count, 1u);
+
+    // Headless images are counted at the size they would take
+    EXPECT_GT(report.GetBytes(L"images"), 0u);
+    EXPECT_EQ(report.GetBytes(L"items"), 2 * sizeof(Enemy) + sizeof(Football));
+    EXPECT_GT(report.GetTotal(), report.GetBytes(L"items"));
+
+    auto json = report.ToJson();
+    EXPECT_NE(json.find("\"Enemy\":{\"count\":2,"), std::string::npos);
+    EXPECT_NE(json.find("\"total\":"), std::string::npos);
+
+    std::filesystem::remove(tmp);
+}
+
+TEST(GameTest, PreloadImages)
+{
+    std::vector<std::wstring> names = {L"images/coin10.png", L"images/U-M.png", L"images/coin10.png",
+                                       L"images/wall1.png"};
+
+    // Decoded together on several threads, once each
+    auto headless = std::make_shared<AssetCache>(true);
+    headless->SetDecodeThreads(3);
+    EXPECT_EQ(headless->GetDecodeThreads(), 3);
+    EXPECT_EQ(headless->Preload(names), 3);
+    EXPECT_EQ(headless->Preload(names), 0);
+    EXPECT_EQ(headless->GetArchetype(L"images/U-M.png", CollisionClass::Hazard)->width, 100);
+
+    // Bitmaps are made afterwards on this thread
+    auto assets = std::make_shared<AssetCache>();
+    auto before = Telemetry::GetTotal(Telemetry::Counter::BitmapsLoaded);
+    EXPECT_EQ(assets->Preload(names), 3);
+    EXPECT_EQ(Telemetry::GetTotal(Telemetry::Counter::BitmapsLoaded), before + 3);
+    ASSERT_NE(assets->GetImage(L"images/wall1.png"), nullptr);
+    EXPECT_EQ(assets->GetImage(L"images/wall1.png")->GetWidth(), 32);
+    EXPECT_EQ(Telemetry::GetTotal(Telemetry::Counter::BitmapsLoaded), before + 3);
+
+    // Starting a game decodes the first level's images up front
+    Game game(assets);
+    EXPECT_EQ(assets->Preload({L"images/footballMid.png", L"images/goalpost.png"}), 0);
+}
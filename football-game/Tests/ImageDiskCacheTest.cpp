@@ -0,0 +1,148 @@
+/**
+ * @file ImageDiskCacheTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <ImageDiskCache.h>
+#include <MappedFile.h>
+#include <AssetCache.h>
+#include <Telemetry.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+/**
+ * Make an empty directory for a test, with a copy of an image in it
+ * @param name Directory name
+ * @return Directory
+ */
+static std::filesystem::path MakeDirectory(const std::string& name)
+{
+    auto dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::filesystem::copy_file("images/coin10.png", dir / "coin10.png");
+    return dir;
+}
+
+TEST(ImageDiskCacheTest, StoreAndLoad)
+{
+    auto dir = MakeDirectory("imagecachetest");
+    auto source = (dir / "coin10.png").wstring();
+    ImageDiskCache cache((dir / "cache").wstring());
+
+    // Nothing is cached yet
+    MappedFile file;
+    wxImage image;
+    EXPECT_FALSE(cache.Load(source, file, image));
+    EXPECT_FALSE(file.IsOpen());
+
+    wxImage decoded(source, wxBITMAP_TYPE_ANY);
+    decoded.SetMaskColour(1, 2, 3);
+    ASSERT_TRUE(decoded.IsOk());
+    ASSERT_TRUE(cache.Store(source, decoded));
+    EXPECT_TRUE(std::filesystem::exists(cache.GetCacheFile(source)));
+
+    // The cached image is the decoded one
+    auto hits = Telemetry::GetTotal(Telemetry::Counter::ImageCacheHits);
+    ASSERT_TRUE(cache.Load(source, file, image));
+    EXPECT_TRUE(file.IsOpen());
+    EXPECT_EQ(Telemetry::GetTotal(Telemetry::Counter::ImageCacheHits), hits + 1);
+    ASSERT_EQ(image.GetWidth(), decoded.GetWidth());
+    ASSERT_EQ(image.GetHeight(), decoded.GetHeight());
+    size_t pixels = size_t(image.GetWidth()) * image.GetHeight();
+    EXPECT_EQ(std::memcmp(image.GetData(), decoded.GetData(), pixels * 3), 0);
+    EXPECT_EQ(image.HasAlpha(), decoded.HasAlpha());
+    if (decoded.HasAlpha())
+    {
+        EXPECT_EQ(std::memcmp(image.GetAlpha(), decoded.GetAlpha(), pixels), 0);
+    }
+    EXPECT_TRUE(image.HasMask());
+    EXPECT_EQ(image.GetMaskBlue(), 3);
+
+    // The same path written another way finds the same file
+    auto other = (dir / "." / "coin10.png").wstring();
+    EXPECT_EQ(cache.GetCacheFile(other), cache.GetCacheFile(source));
+
+    image = wxImage();
+    file.Close();
+    std::filesystem::remove_all(dir);
+}
+
+TEST(ImageDiskCacheTest, Invalidate)
+{
+    auto dir = MakeDirectory("imagecacheinvalidate");
+    auto source = (dir / "coin10.png").wstring();
+    ImageDiskCache cache((dir / "cache").wstring());
+    wxImage decoded(source, wxBITMAP_TYPE_ANY);
+
+    // A newer image is not served from the cache
+    ASSERT_TRUE(cache.Store(source, decoded));
+    auto time = std::filesystem::last_write_time(dir / "coin10.png");
+    std::filesystem::last_write_time(dir / "coin10.png", time + std::chrono::seconds(10));
+    MappedFile file;
+    wxImage image;
+    EXPECT_FALSE(cache.Load(source, file, image));
+
+    // Nor is one of another size
+    ASSERT_TRUE(cache.Store(source, decoded));
+    EXPECT_TRUE(cache.Load(source, file, image));
+    image = wxImage();
+    file.Close();
+    {
+        std::ofstream out(dir / "coin10.png", std::ios::binary | std::ios::app);
+        out << '\0';
+    }
+    std::filesystem::last_write_time(dir / "coin10.png", time + std::chrono::seconds(10));
+    EXPECT_FALSE(cache.Load(source, file, image));
+
+    // A damaged cache file is ignored
+    ASSERT_TRUE(cache.Store(source, decoded));
+    std::filesystem::resize_file(cache.GetCacheFile(source), 100);
+    EXPECT_FALSE(cache.Load(source, file, image));
+    EXPECT_FALSE(file.IsOpen());
+
+    // A missing image is never served
+    std::filesystem::remove(dir / "coin10.png");
+    EXPECT_FALSE(cache.Load(source, file, image));
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(ImageDiskCacheTest, AssetCache)
+{
+    auto dir = MakeDirectory("imagecacheassets");
+    auto source = (dir / "coin10.png").wstring();
+    auto cacheDir = (dir / "cache").wstring();
+
+    // The first run decodes the image and stores it
+    AssetCache first;
+    EXPECT_EQ(first.GetDiskCache(), nullptr);
+    first.SetDiskCache(cacheDir);
+    ASSERT_NE(first.GetDiskCache(), nullptr);
+    auto hits = Telemetry::GetTotal(Telemetry::Counter::ImageCacheHits);
+    auto bitmap = first.GetImage(source);
+    EXPECT_EQ(Telemetry::GetTotal(Telemetry::Counter::ImageCacheHits), hits);
+    EXPECT_TRUE(std::filesystem::exists(first.GetDiskCache()->GetCacheFile(source)));
+
+    // Later runs map it, whether loaded alone or preloaded
+    AssetCache second;
+    second.SetDiskCache(cacheDir);
+    auto cached = second.GetImage(source);
+    EXPECT_EQ(Telemetry::GetTotal(Telemetry::Counter::ImageCacheHits), hits + 1);
+    EXPECT_EQ(cached->GetWidth(), bitmap->GetWidth());
+    EXPECT_EQ(cached->GetHeight(), bitmap->GetHeight());
+
+    AssetCache third(true);
+    third.SetDiskCache(cacheDir);
+    third.SetDecodeThreads(2);
+    EXPECT_EQ(third.Preload({source}), 1);
+    EXPECT_EQ(Telemetry::GetTotal(Telemetry::Counter::ImageCacheHits), hits + 2);
+    EXPECT_EQ(third.GetArchetype(source, CollisionClass::Pickup)->width, bitmap->GetWidth());
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file InputLatencyTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <InputLatency.h>
+
+using Clock = InputLatency::Clock;
+using Stage = InputLatency::Stage;
+
+/**
+ * Get a time a number of milliseconds after a fixed start
+ * @param ms Milliseconds
+ * @return Time point
+ */
+static Clock::time_point At(int ms)
+{
+    return Clock::time_point() + std::chrono::milliseconds(ms);
+}
+
+TEST(InputLatencyTest, Stages)
+{
+    InputLatency latency;
+
+    // Pressed at 0, read by the timer at 10, ticked at 12, drawn at 20
+    latency.OnInput(At(0));
+    latency.OnSample(At(10));
+
+    // A press after the timer waits for the next sample
+    latency.OnInput(At(11));
+    latency.OnTick(At(12));
+    latency.OnPresent(At(20));
+
+    auto total = latency.GetStats(Stage::Total);
+    ASSERT_EQ(total.count, 1u);
+    EXPECT_DOUBLE_EQ(total.max, 20);
+    EXPECT_DOUBLE_EQ(latency.GetStats(Stage::Sample).max, 10);
+    EXPECT_DOUBLE_EQ(latency.GetStats(Stage::Tick).max, 2);
+    EXPECT_DOUBLE_EQ(latency.GetStats(Stage::Present).max, 8);
+
+    latency.OnSample(At(26));
+    latency.OnTick(At(28));
+    latency.OnPresent(At(36));
+    total = latency.GetStats(Stage::Total);
+    EXPECT_EQ(total.count, 2u);
+    EXPECT_DOUBLE_EQ(total.mean, 22.5);
+    EXPECT_DOUBLE_EQ(total.max, 25);
+}
+
+TEST(InputLatencyTest, Percentiles)
+{
+    // Only the most recent inputs are kept
+    InputLatency latency(100);
+    for (int i = 0; i < 150; i++)
+    {
+        int start = i * 1000;
+        int ms = i < 50 ? 500 : i - 49;
+        latency.OnInput(At(start));
+        latency.OnSample(At(start));
+        latency.OnTick(At(start));
+        latency.OnPresent(At(start + ms));
+    }
+
+    auto total = latency.GetStats(Stage::Total);
+    EXPECT_EQ(total.count, 100u);
+    EXPECT_DOUBLE_EQ(total.p50, 50);
+    EXPECT_DOUBLE_EQ(total.p95, 95);
+    EXPECT_DOUBLE_EQ(total.p99, 99);
+    EXPECT_DOUBLE_EQ(total.max, 100);
+
+    latency.Reset();
+    EXPECT_EQ(latency.GetStats(Stage::Total).count, 0u);
+}
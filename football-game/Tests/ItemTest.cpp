@@ -91,4 +91,20 @@ TEST(ItemTest, UpdatePrev)
     item.UpdatePrev();
     ASSERT_NEAR(50, item.GetPrevX(), 0.0001);
     ASSERT_NEAR(60, item.GetPrevY(), 0.0001);
-}
\ No newline at end of file
+}
+
+TEST(ItemTest, SharedArchetype)
+{
+    Game game;
+    ItemMock coin1(&game);
+    ItemMock coin2(&game);
+
+    // Items with the same image share one archetype
+    ASSERT_EQ(coin1.GetArchetype(), coin2.GetArchetype());
+    ASSERT_NEAR(coin1.GetWidth(), coin1.GetBitmap()->GetWidth(), 0.0001);
+
+    // A different collision class is a different archetype
+    auto pickup = game.GetArchetype(coin10Image, CollisionClass::Pickup);
+    ASSERT_NE(coin1.GetArchetype(), pickup);
+    ASSERT_EQ(coin1.GetBitmap(), pickup->bitmap);
+}
@@ -0,0 +1,103 @@
+/**
+ * @file LevelCheckerTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <LevelChecker.h>
+
+using Problem = LevelChecker::Problem;
+
+/// A level with one of each problem
+static const char* FaultyLevel = R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="1024" height="1024" start-y="900" start-x="200">
+  <declarations>
+    <platform id="i001" left-image="metalLeft.png" mid-image="metalMid.png" right-image="metalRight.png"/>
+    <coin id="i002" image="coin10.png" value="10"/>
+  </declarations>
+  <items>
+    <platform id="i001" x="512" y="1000" width="1024" height="32"/>
+    <platform id="i001" x="512" y="990" width="64" height="32"/>
+    <coin id="i002" x="100" y="1000"/>
+    <coin id="i002" x="300" y="800"/>
+    <coin id="i002" x="700" y="200"/>
+    <coin id="i002" x="2000" y="500"/>
+    <platform id="i001" x="100" y="50" width="64" height="32"/>
+    <coin id="i002" x="100" y="500"/>
+  </items>
+</level>
+)";
+
+/**
+ * Count the issues of one kind in a report
+ * @param report Report
+ * @param problem Kind of issue
+ * @return Number found
+ */
+static int Count(const LevelChecker::Report& report, Problem problem)
+{
+    int count = 0;
+    for (auto& issue : report.issues)
+    {
+        count += issue.problem == problem ? 1 : 0;
+    }
+    return count;
+}
+
+TEST(LevelCheckerTest, Jump)
+{
+    // 750 px/s upward against 1000 px/s^2, running at 300 px/s
+    EXPECT_NEAR(281.25, LevelChecker::JumpHeight(), 0.0001);
+    EXPECT_NEAR(450, LevelChecker::JumpReach(), 0.0001);
+}
+
+TEST(LevelCheckerTest, FindsProblems)
+{
+    auto dir = std::filesystem::temp_directory_path() / "levelchecktest";
+    std::filesystem::create_directories(dir);
+    auto faulty = dir / "faulty.xml";
+    {
+        std::ofstream out(faulty);
+        ASSERT_TRUE(out.good());
+        out << FaultyLevel;
+    }
+    std::ofstream(dir / "notes.txt") << "not a level";
+
+    auto levels = LevelChecker::FindLevels(dir.wstring());
+    ASSERT_EQ(1u, levels.size());
+    EXPECT_EQ(faulty.wstring(), levels[0]);
+
+    LevelChecker checker(std::make_shared<AssetCache>(true), 2);
+    auto missing = (dir / "missing.xml").wstring();
+    auto reports = checker.CheckAll({levels[0], missing});
+    ASSERT_EQ(2u, reports.size());
+
+    // Reports come back in the order asked for
+    auto& report = reports[0];
+    EXPECT_EQ(levels[0], report.filename);
+    EXPECT_EQ(5, report.counts[L"ItemCoin10"]);
+    EXPECT_GT(Count(report, Problem::OverlappingTerrain), 0);
+    EXPECT_EQ(1, Count(report, Problem::CoinInWall));
+    EXPECT_EQ(2, Count(report, Problem::UnreachableCoin));
+    EXPECT_EQ(1, Count(report, Problem::OutOfBounds));
+    EXPECT_EQ(0, Count(report, Problem::LoadError));
+
+    for (auto& issue : report.issues)
+    {
+        // One high in the air, one far below a platform
+        if (issue.problem == Problem::UnreachableCoin)
+        {
+            EXPECT_TRUE(issue.x == 700 || issue.x == 100);
+            EXPECT_NEAR(issue.x == 700 ? 200 : 500, issue.y, 0.0001);
+        }
+    }
+
+    EXPECT_EQ(missing, reports[1].filename);
+    EXPECT_EQ(1, Count(reports[1], Problem::LoadError));
+    EXPECT_FALSE(reports[1].IsClean());
+
+    std::filesystem::remove_all(dir);
+}
@@ -11,6 +11,7 @@
 #include <Item.h>
 #include <Game.h>
 #include <MovingPlatform.h>
+#include <LevelData.h>
 
 using namespace std;
 
@@ -47,3 +48,105 @@ TEST(LoadingTest, LoadsMovingPlatformFromXML)
 
     std::filesystem::remove(tmp);
 }
+
+TEST(LoadingTest, LevelDataInternsDeclarations)
+{
+    LevelData level;
+    ASSERT_TRUE(level.Load(movingPlatformXML.data(), movingPlatformXML.size()));
+
+    EXPECT_NEAR(468, level.GetStartX(), 0.0001);
+    EXPECT_NEAR(572, level.GetStartY(), 0.0001);
+
+    // Each declaration is interned once, items refer to it by index
+    ASSERT_EQ(2u, level.GetDeclarations().size());
+    ASSERT_EQ(2u, level.GetItems().size());
+
+    auto& platform = level.GetItems()[1];
+    auto& decl = level.GetDeclarations()[platform.declaration];
+    EXPECT_TRUE(decl.type == LevelData::Type::MovingPlatform);
+    EXPECT_EQ(L"metalMid.png", decl.midImage);
+    EXPECT_NEAR(160, platform.width, 0.0001);
+
+    // Without cx/cy a moving platform circles its own location
+    EXPECT_NEAR(600, platform.cx, 0.0001);
+    EXPECT_NEAR(720, platform.cy, 0.0001);
+}
+
+TEST(LoadingTest, LevelDataRejectsBadRoot)
+{
+    string xml = "<notalevel/>";
+    LevelData level;
+    ASSERT_FALSE(level.Load(xml.data(), xml.size()));
+}
+
+TEST(LoadingTest, LevelDataDecodesReferences)
+{
+    string xml = R"(<level width="1024" height="1024" start-y="0" start-x="0">
+  <declarations>
+    <movingplatform id="i001" left-image="&#x6D;etalLeft.png" mid-image="metal&#77;id.png" right-image="a&amp;b.png"/>
+    <background id="i002" image="&#98;ack&#X67;round0.png"/>
+  </declarations>
+  <items/>
+</level>)";
+    LevelData level;
+    ASSERT_TRUE(level.Load(xml.data(), xml.size()));
+    ASSERT_EQ(2u, level.GetDeclarations().size());
+
+    auto& platform = level.GetDeclarations()[0];
+    EXPECT_EQ(L"metalLeft.png", platform.leftImage);
+    EXPECT_EQ(L"metalMid.png", platform.midImage);
+    EXPECT_EQ(L"a&b.png", platform.rightImage);
+
+    // An element with fewer attributes than the last sees only its own
+    auto& background = level.GetDeclarations()[1];
+    EXPECT_EQ(L"background0.png", background.image);
+    EXPECT_TRUE(background.leftImage.empty());
+}
+
+TEST(LoadingTest, LevelDataDropsUndeclaredItems)
+{
+    string xml = R"(<level width="1024" height="1024" start-y="0" start-x="0">
+  <declarations>
+    <background id="i001" image="background0.png"/>
+  </declarations>
+  <items>
+    <background id="i001" x="512" y="512"/>
+    <coin id="i099" x="100" y="100"/>
+  </items>
+</level>)";
+    LevelData level;
+    ASSERT_TRUE(level.Load(xml.data(), xml.size()));
+
+    // The coin names nothing that was declared, so it is not kept
+    ASSERT_EQ(1u, level.GetDeclarations().size());
+    ASSERT_EQ(1u, level.GetItems().size());
+    EXPECT_EQ(0, level.GetItems()[0].declaration);
+}
+
+TEST(LoadingTest, LevelDataRejectsEmptyNames)
+{
+    string noElement = R"(<level width="1024" height="1024"><items>< id="i001"/></items></level>)";
+    LevelData level;
+    ASSERT_FALSE(level.Load(noElement.data(), noElement.size()));
+    EXPECT_NE(wstring::npos, level.GetError().find(L"Missing element name"));
+
+    string noAttribute = R"(<level width="1024" height="1024"><items><coin ="i001"/></items></level>)";
+    ASSERT_FALSE(level.Load(noAttribute.data(), noAttribute.size()));
+    EXPECT_NE(wstring::npos, level.GetError().find(L"Missing attribute name"));
+}
+
+TEST(LoadingTest, LevelDataReportsParseError)
+{
+    auto path = filesystem::temp_directory_path() / "level_broken.xml";
+    {
+        ofstream out(path);
+        out << R"(<level width="1024" height="1024"><items></level>)";
+    }
+
+    // The reader's reason is passed on, not just that it failed
+    LevelData level;
+    ASSERT_FALSE(level.Load(path.wstring()));
+    EXPECT_NE(wstring::npos, level.GetError().find(L"Mismatched end tag"));
+
+    filesystem::remove(path);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file MovingPlatformTest.cpp
+ *
+ * @author Michael Dreon
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Game.h>
+#include <MovingPlatform.h>
+#include <LevelData.h>
+
+/// Platform segment image
+const std::wstring metalMidImage = L"images/metalMid.png";
+
+/// A floor for the football and a single moving platform near it
+static const char* MotionLevel = R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="2048" height="1024" start-y="900" start-x="400">
+  <declarations>
+    <platform id="i001" left-image="metalLeft.png" mid-image="metalMid.png" right-image="metalRight.png"/>
+    <movingplatform id="i002" left-image="metalLeft.png" mid-image="metalMid.png" right-image="metalRight.png"/>
+  </declarations>
+  <items>
+    <platform id="i001" x="1024" y="1008" width="2048" height="32"/>
+    <movingplatform id="i002" cx="500" cy="600" radius="50" omega="3.14159265358979" width="0"/>
+  </items>
+</level>
+)";
+
+TEST(MovingPlatformTest, PositionAt)
+{
+    Game game;
+    MovingPlatform platform(&game, metalMidImage);
+    platform.SetMotion(100, 200, 50, M_PI);
+
+    // Starts at angle 0, to the right of the center
+    auto start = platform.PositionAt(0);
+    ASSERT_NEAR(150, start.m_x, 0.0001);
+    ASSERT_NEAR(200, start.m_y, 0.0001);
+
+    // Half a second is a quarter turn
+    auto quarter = platform.PositionAt(0.5);
+    ASSERT_NEAR(100, quarter.m_x, 0.0001);
+    ASSERT_NEAR(250, quarter.m_y, 0.0001);
+
+    // Two seconds is a full turn, back where we started
+    auto full = platform.PositionAt(2.0);
+    ASSERT_NEAR(150, full.m_x, 0.0001);
+    ASSERT_NEAR(200, full.m_y, 0.0001);
+}
+
+TEST(MovingPlatformTest, UpdateFollowsLevelClock)
+{
+    Game game;
+    LevelData level;
+    ASSERT_TRUE(level.Load(MotionLevel, strlen(MotionLevel)));
+    game.LoadLevelData(level, L"motion.xml");
+
+    MovingPlatform* platform = nullptr;
+    for (int i = 0; i < int(game.GetRosterSize()); i++)
+    {
+        if (auto moving = dynamic_cast<MovingPlatform*>(game.GetRosterItem(i)))
+        {
+            platform = moving;
+        }
+    }
+    ASSERT_NE(nullptr, platform);
+
+    // Half a second of ticks is a quarter turn, below the center
+    for (int i = 0; i < 5; i++)
+    {
+        game.Update(0.1);
+    }
+    ASSERT_NEAR(0.5, game.GetLevelTime(), 0.0001);
+    ASSERT_NEAR(500, platform->GetX(), 0.0001);
+    ASSERT_NEAR(650, platform->GetY(), 0.0001);
+
+    // Uneven ticks land where the level clock says, not where
+    // a sum of small steps would drift to
+    for (int i = 0; i < 7; i++)
+    {
+        game.Update(i % 2 == 0 ? 0.05 : 0.1);
+    }
+    auto expected = platform->PositionAt(game.GetLevelTime());
+    ASSERT_NEAR(expected.m_x, platform->GetX(), 0.0001);
+    ASSERT_NEAR(expected.m_y, platform->GetY(), 0.0001);
+    ASSERT_GT(game.GetLevelTime(), 0.5);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file RewindBufferTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Item.h>
+#include <Game.h>
+#include <RewindBuffer.h>
+
+/// Coin filename
+const std::wstring rewindImage = L"images/coin10.png";
+
+/** Item that moves one pixel per second and can be made static */
+class RewindMock : public Item {
+public:
+    RewindMock(Game *game) : Item(game, rewindImage) {}
+
+    bool IsDynamic() const override { return mDynamic; }
+    void Update(double elapsed) override { SetLocation(GetX() + elapsed, GetY()); }
+
+    /// Should the item be captured?
+    bool mDynamic = true;
+};
+
+/**
+ * Globals holding just a tick number
+ * @param tick Tick number
+ * @return Snapshot of the globals
+ */
+static GameSnapshot Globals(int tick)
+{
+    GameSnapshot globals;
+    globals.Write(tick);
+    return globals;
+}
+
+TEST(RewindBufferTest, StepBack)
+{
+    Game game;
+    auto mover = std::make_shared<RewindMock>(&game);
+    auto still = std::make_shared<RewindMock>(&game);
+    still->mDynamic = false;
+    std::vector<std::shared_ptr<Item>> roster = {mover, still};
+    std::vector<std::shared_ptr<Item>> items = roster;
+
+    RewindBuffer rewind;
+    rewind.Reset(roster, Globals(0));
+
+    for (int tick = 1; tick <= 3; tick++)
+    {
+        mover->Update(1);
+        if (tick == 2)
+        {
+            // Removed during the second tick
+            rewind.LogRemoval(1, 1);
+            items.pop_back();
+        }
+        rewind.Capture(0.5, roster, Globals(tick));
+    }
+
+    ASSERT_EQ(rewind.GetFrameCount(), 3);
+    ASSERT_NEAR(1.5, rewind.GetDuration(), 0.0001);
+    ASSERT_EQ(items.size(), 1u);
+
+    GameSnapshot globals;
+    for (int tick = 2; tick >= 0; tick--)
+    {
+        ASSERT_TRUE(rewind.StepBack(roster, items, globals));
+        ASSERT_NEAR(tick, mover->GetX(), 0.0001);
+
+        int saved = -1;
+        globals.Rewind();
+        globals.Read(saved);
+        ASSERT_EQ(saved, tick);
+    }
+
+    // The removed item is back where it was
+    ASSERT_EQ(items.size(), 2u);
+    ASSERT_EQ(items[1], still);
+
+    ASSERT_FALSE(rewind.StepBack(roster, items, globals));
+}
+
+TEST(RewindBufferTest, Bounded)
+{
+    Game game;
+    auto mover = std::make_shared<RewindMock>(&game);
+    std::vector<std::shared_ptr<Item>> roster = {mover};
+
+    // Two seconds of history, at most 100 ticks
+    RewindBuffer rewind(2, 100);
+    rewind.Reset(roster, Globals(0));
+
+    for (int tick = 1; tick <= 1000; tick++)
+    {
+        mover->Update(1);
+        rewind.Capture(0.01, roster, Globals(tick));
+    }
+    ASSERT_EQ(rewind.GetFrameCount(), 100);
+
+    size_t memory = rewind.GetMemoryUsed();
+    for (int tick = 1; tick <= 1000; tick++)
+    {
+        mover->Update(1);
+        rewind.Capture(0.1, roster, Globals(tick));
+    }
+    ASSERT_LE(rewind.GetDuration(), 2.0001);
+    ASSERT_LT(rewind.GetFrameCount(), 100);
+
+    // Frames are reused, so memory does not grow
+    ASSERT_EQ(rewind.GetMemoryUsed(), memory);
+}
+
+TEST(RewindBufferTest, CaptureChanged)
+{
+    Game game;
+    auto listed = std::make_shared<RewindMock>(&game);
+    auto unlisted = std::make_shared<RewindMock>(&game);
+    std::vector<std::shared_ptr<Item>> roster = {listed, unlisted};
+    std::vector<std::shared_ptr<Item>> items = roster;
+
+    RewindBuffer rewind;
+    rewind.Reset(roster, Globals(0));
+
+    // Only the items in the list are compared
+    listed->Update(1);
+    unlisted->Update(1);
+    rewind.Capture(0.5, roster, Globals(1), {0});
+
+    GameSnapshot globals;
+    ASSERT_TRUE(rewind.StepBack(roster, items, globals));
+    ASSERT_NEAR(0, listed->GetX(), 0.0001);
+    ASSERT_NEAR(1, unlisted->GetX(), 0.0001);
+}
@@ -0,0 +1,169 @@
+/**
+ * @file ScalingTest.cpp
+ * @author Brennan Eagle
+ *
+ * Checks that the work done in a tick and a frame depends on what
+ * is near the view, not on how big the level is. The work is
+ * counted as the items the game looks at, not timed, so the
+ * checks do not depend on how busy the machine is.
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Game.h>
+#include <Football.h>
+#include <LevelData.h>
+#include <sstream>
+#include <vector>
+
+/// Off screen items in the smaller level
+const int SmallLevel = 1000;
+
+/// Where the items off the screen start
+const int OffScreenX = 4096;
+
+/**
+ * Generate a level. The part of it in view is the same for every
+ * size: a floor, some platforms, coins and two enemies. Past that
+ * are groups of a platform, two coins and an enemy, out of view.
+ * @param offScreen About how many items to put out of view
+ * @return Level XML
+ */
+static std::string GenerateLevel(int offScreen)
+{
+    // A group is a 3 segment platform, two coins and an enemy
+    const int groups = offScreen / 6;
+    const int spacing = 160;
+
+    std::ostringstream xml;
+    xml << R"(<?xml version="1.0" encoding="UTF-8"?>)" << '\n'
+        << "<level width=\"" << OffScreenX + groups * spacing + 1024 << R"(" height="1024" start-y="900" start-x="400">
+  <declarations>
+    <platform id="i001" left-image="metalLeft.png" mid-image="metalMid.png" right-image="metalRight.png"/>
+    <coin id="i002" image="coin10.png" value="10"/>
+    <enemy id="i003" image="U-M.png"/>
+  </declarations>
+  <items>
+    <platform id="i001" x="1024" y="1000" width="2048" height="32"/>
+)";
+    for (int i = 0; i < 8; i++)
+    {
+        xml << "    <platform id=\"i001\" x=\"" << 200 + i * 200 << "\" y=\"" << 700 - (i % 3) * 100
+            << "\" width=\"96\" height=\"32\"/>\n";
+        xml << "    <coin id=\"i002\" x=\"" << 200 + i * 200 << "\" y=\"" << 600 - (i % 3) * 100 << "\"/>\n";
+    }
+    xml << "    <enemy id=\"i003\" x=\"900\" y=\"400\"/>\n"
+        << "    <enemy id=\"i003\" x=\"1300\" y=\"300\"/>\n";
+
+    for (int g = 0; g < groups; g++)
+    {
+        int x = OffScreenX + g * spacing;
+        int y = 300 + (g % 5) * 100;
+        xml << "    <platform id=\"i001\" x=\"" << x << "\" y=\"" << y << "\" width=\"96\" height=\"32\"/>\n"
+            << "    <coin id=\"i002\" x=\"" << x - 32 << "\" y=\"" << y - 64 << "\"/>\n"
+            << "    <coin id=\"i002\" x=\"" << x + 32 << "\" y=\"" << y - 64 << "\"/>\n"
+            << "    <enemy id=\"i003\" x=\"" << x << "\" y=\"" << y - 150 << "\"/>\n";
+    }
+    xml << "  </items>\n</level>\n";
+    return xml.str();
+}
+
+/**
+ * Load a generated level into a game
+ * @param game Game to load into
+ * @param offScreen About how many items to put out of view
+ */
+static void LoadGenerated(Game& game, int offScreen)
+{
+    auto xml = GenerateLevel(offScreen);
+    LevelData level;
+    ASSERT_TRUE(level.Load(xml.data(), xml.size()));
+    game.LoadLevelData(level, L"generated.xml");
+}
+
+TEST(ScalingTest, GeneratedLevelSizes)
+{
+    Game small(std::make_shared<AssetCache>(true));
+    LoadGenerated(small, SmallLevel);
+    Game large(std::make_shared<AssetCache>(true));
+    LoadGenerated(large, SmallLevel * 10);
+
+    // Same view, 10x the items
+    ASSERT_EQ(small.GetRosterSize() - SmallLevel, large.GetRosterSize() - SmallLevel * 10);
+}
+
+TEST(ScalingTest, UpdateVisits)
+{
+    // The work of a quiet tick, of the tick a coin is picked
+    // up in and of the tick after it
+    auto tickVisits = [](int offScreen) {
+        Game game(std::make_shared<AssetCache>(true));
+        LoadGenerated(game, offScreen);
+
+        // Let the football land and the far enemies fall asleep
+        for (int i = 0; i < 100; i++)
+        {
+            game.Update(1.0 / 60);
+        }
+        std::vector<int> visits{game.GetUpdateVisitCount()};
+
+        // Put the football on the first coin in view
+        double items = game.CountItems();
+        game.GetFootball()->SetLocation(200, 600);
+        game.Update(1.0 / 60);
+        EXPECT_EQ(items - 1, game.CountItems());
+        visits.push_back(game.GetUpdateVisitCount());
+
+        game.Update(1.0 / 60);
+        visits.push_back(game.GetUpdateVisitCount());
+        return visits;
+    };
+
+    auto small = tickVisits(SmallLevel);
+    auto large = tickVisits(SmallLevel * 10);
+    for (int visits : small)
+    {
+        EXPECT_GT(visits, 0);
+        EXPECT_LT(visits, SmallLevel / 4);
+    }
+    EXPECT_EQ(small, large);
+}
+
+TEST(ScalingTest, DrawVisits)
+{
+    auto frameVisits = [](int offScreen) {
+        Game game(std::make_shared<AssetCache>(true));
+        LoadGenerated(game, offScreen);
+        game.Update(1.0 / 60);
+
+        wxImage image(1280, 1024);
+        std::shared_ptr<wxGraphicsContext> graphics(wxGraphicsContext::Create(image));
+        game.OnDraw(graphics, image.GetWidth(), image.GetHeight());
+        return std::make_pair(game.GetDrawVisitCount(), game.GetDrawnCount());
+    };
+
+    auto small = frameVisits(SmallLevel);
+    auto large = frameVisits(SmallLevel * 10);
+    EXPECT_GT(small.second, 0);
+    EXPECT_LT(small.first, SmallLevel / 4);
+    EXPECT_EQ(small, large);
+}
+
+TEST(ScalingTest, PickupKeepsIndex)
+{
+    Game game(std::make_shared<AssetCache>(true));
+    LoadGenerated(game, SmallLevel * 10);
+    game.Update(1.0 / 60);
+    long builds = game.GetIndexBuildCount();
+    double items = game.CountItems();
+
+    // Put the football on the first coin in view
+    game.GetFootball()->SetLocation(200, 600);
+    game.Update(1.0 / 60);
+    EXPECT_EQ(items - 1, game.CountItems());
+
+    // The index is kept rather than built again for every item
+    game.Update(1.0 / 60);
+    EXPECT_EQ(builds, game.GetIndexBuildCount());
+    EXPECT_GT(game.GetUpdateVisitCount(), 0);
+}
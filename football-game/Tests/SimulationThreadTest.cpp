@@ -0,0 +1,234 @@
+/**
+ * @file SimulationThreadTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Game.h>
+#include <Football.h>
+#include <LevelData.h>
+#include <RenderState.h>
+#include <SimulationThread.h>
+#include <SpscQueue.h>
+#include <TripleBuffer.h>
+
+#include <chrono>
+#include <thread>
+
+/// A floor to run along
+static const char* RunLevel = R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="2048" height="1024" start-y="900" start-x="400">
+  <declarations>
+    <platform id="i001" left-image="metalLeft.png" mid-image="metalMid.png" right-image="metalRight.png"/>
+  </declarations>
+  <items>
+    <platform id="i001" x="1024" y="1008" width="2048" height="32"/>
+  </items>
+</level>
+)";
+
+/**
+ * Load the test level
+ * @param game Game to load into
+ */
+static void LoadRunLevel(Game& game)
+{
+    LevelData level;
+    ASSERT_TRUE(level.Load(RunLevel, strlen(RunLevel)));
+    game.LoadLevelData(level, L"run.xml");
+}
+
+TEST(SimulationThreadTest, TripleBuffer)
+{
+    TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.Update());
+
+    buffer.GetBack() = 1;
+    buffer.Publish();
+    ASSERT_TRUE(buffer.Update());
+    EXPECT_EQ(1, buffer.GetFront());
+    EXPECT_FALSE(buffer.Update());
+    EXPECT_EQ(1, buffer.GetFront());
+
+    // Only the latest of several is seen
+    for (int i = 2; i <= 5; i++)
+    {
+        buffer.GetBack() = i;
+        buffer.Publish();
+    }
+    ASSERT_TRUE(buffer.Update());
+    EXPECT_EQ(5, buffer.GetFront());
+    EXPECT_FALSE(buffer.Update());
+}
+
+TEST(SimulationThreadTest, TripleBufferThreads)
+{
+    TripleBuffer<int> buffer;
+    const int count = 100000;
+
+    std::thread writer([&buffer]() {
+        for (int i = 1; i <= count; i++)
+        {
+            buffer.GetBack() = i;
+            buffer.Publish();
+        }
+    });
+
+    // Values only ever go forward
+    int last = 0;
+    while (last < count)
+    {
+        if (buffer.Update())
+        {
+            ASSERT_GT(buffer.GetFront(), last);
+            last = buffer.GetFront();
+        }
+    }
+    writer.join();
+}
+
+TEST(SimulationThreadTest, SpscQueue)
+{
+    SpscQueue<int, 4> queue;
+    int item;
+    EXPECT_FALSE(queue.Pop(item));
+
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(queue.Push(i));
+    }
+    EXPECT_FALSE(queue.Push(4));
+
+    EXPECT_TRUE(queue.Pop(item));
+    EXPECT_EQ(0, item);
+    EXPECT_TRUE(queue.Push(4));
+    for (int i = 1; i <= 4; i++)
+    {
+        ASSERT_TRUE(queue.Pop(item));
+        EXPECT_EQ(i, item);
+    }
+    EXPECT_FALSE(queue.Pop(item));
+}
+
+TEST(SimulationThreadTest, SpscQueueThreads)
+{
+    SpscQueue<int, 16> queue;
+    const int count = 100000;
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < count; i++)
+        {
+            while (!queue.Push(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // Every item arrives once and in order
+    int next = 0;
+    while (next < count)
+    {
+        int item;
+        if (queue.Pop(item))
+        {
+            ASSERT_EQ(next, item);
+            next++;
+        }
+    }
+    producer.join();
+}
+
+TEST(SimulationThreadTest, Capture)
+{
+    Game game;
+    LoadRunLevel(game);
+    game.Update(0.001);
+
+    // The same items are captured as are drawn
+    wxImage image(1024, 768);
+    std::shared_ptr<wxGraphicsContext> graphics(wxGraphicsContext::Create(image));
+    game.OnDraw(graphics, image.GetWidth(), image.GetHeight());
+
+    RenderState state;
+    game.Capture(state);
+    EXPECT_EQ(size_t(game.GetDrawnCount()), state.GetSprites().size());
+    EXPECT_GT(state.GetSprites().size(), 0u);
+}
+
+TEST(SimulationThreadTest, CaptureText)
+{
+    Game game;
+    LoadRunLevel(game);
+    game.AddFloatingText(L"+100", 600, 400, 100);
+
+    // Colours are captured as bytes and made into a wxColour when drawn
+    RenderState state;
+    game.Capture(state);
+    ASSERT_EQ(1u, state.GetTexts().size());
+    auto& text = state.GetTexts()[0];
+    EXPECT_EQ(255, text.red);
+    EXPECT_EQ(215, text.green);
+    EXPECT_EQ(0, text.blue);
+    EXPECT_EQ(255, text.alpha);
+}
+
+TEST(SimulationThreadTest, Tick)
+{
+    // The same play run directly and through the simulation
+    Game direct;
+    LoadRunLevel(direct);
+    direct.SetViewSize(1024, 768);
+
+    Game threaded;
+    LoadRunLevel(threaded);
+    SimulationThread simulation(&threaded);
+    simulation.SetViewSize(1024, 768);
+
+    SimulationThread::Input input;
+    input.right = true;
+    ASSERT_TRUE(simulation.Send(input));
+
+    const int ticks = 60;
+    for (int i = 0; i < ticks; i++)
+    {
+        direct.ApplyInput(false, true, false);
+        direct.Update(simulation.GetStep());
+        simulation.Tick();
+    }
+
+    EXPECT_DOUBLE_EQ(direct.GetFootball()->GetX(), threaded.GetFootball()->GetX());
+    EXPECT_GT(threaded.GetFootball()->GetX(), 400);
+
+    ASSERT_TRUE(simulation.Update());
+    auto& state = simulation.GetState();
+    EXPECT_EQ(uint64_t(ticks), state.GetTick());
+    EXPECT_EQ(1u, state.GetInputs());
+    EXPECT_GT(state.GetSprites().size(), 0u);
+    EXPECT_FALSE(simulation.Update());
+}
+
+TEST(SimulationThreadTest, Run)
+{
+    Game game;
+    LoadRunLevel(game);
+    SimulationThread simulation(&game);
+    simulation.SetViewSize(1024, 768);
+
+    EXPECT_FALSE(simulation.IsRunning());
+    simulation.Start();
+    EXPECT_TRUE(simulation.IsRunning());
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // The game can be used between ticks
+    {
+        auto lock = simulation.Lock();
+        EXPECT_GT(game.GetFootball()->GetY(), 0);
+    }
+
+    simulation.Stop();
+    EXPECT_FALSE(simulation.IsRunning());
+    ASSERT_TRUE(simulation.Update());
+    EXPECT_GT(simulation.GetState().GetTick(), 0u);
+}
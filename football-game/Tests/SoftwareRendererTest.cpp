@@ -0,0 +1,104 @@
+/**
+ * @file SoftwareRendererTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <SoftwareRenderer.h>
+#include <random>
+
+using Kernel = SoftwareRenderer::Kernel;
+
+/**
+ * Make a sprite filled with one colour
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param pixel Premultiplied ARGB colour
+ * @return Sprite
+ */
+static SoftwareRenderer::Sprite Solid(int width, int height, uint32_t pixel)
+{
+    SoftwareRenderer::Sprite sprite;
+    sprite.width = width;
+    sprite.height = height;
+    sprite.pixels.assign(size_t(width) * height, pixel);
+    return sprite;
+}
+
+TEST(SoftwareRendererTest, Blend)
+{
+    SoftwareRenderer renderer;
+    renderer.Begin(4, 1, 0xff204060);
+
+    // Opaque replaces, transparent leaves, half alpha mixes
+    auto opaque = Solid(1, 1, 0xff0000ff);
+    auto clear = Solid(1, 1, 0);
+    auto half = Solid(1, 1, 0x80800000);
+    renderer.Blit(opaque, 0, 0);
+    renderer.Blit(clear, 1, 0);
+    renderer.Blit(half, 2, 0);
+
+    auto& pixels = renderer.GetPixels();
+    EXPECT_EQ(pixels[0], 0xff0000ffu);
+    EXPECT_EQ(pixels[1], 0xff204060u);
+    EXPECT_EQ(pixels[2], 0xff902030u);
+    EXPECT_EQ(pixels[3], 0xff204060u);
+}
+
+TEST(SoftwareRendererTest, Clipping)
+{
+    SoftwareRenderer renderer;
+    renderer.Begin(8, 8, 0xff000000);
+
+    // Hangs off the top left corner, and one entirely outside
+    auto sprite = Solid(4, 4, 0xffffffff);
+    renderer.Blit(sprite, -2, -3);
+    renderer.Blit(sprite, 8, 0);
+
+    int lit = 0;
+    for (auto pixel : renderer.GetPixels())
+    {
+        lit += pixel == 0xffffffff;
+    }
+    EXPECT_EQ(lit, 2);
+    EXPECT_EQ(renderer.GetPixels()[0], 0xffffffffu);
+    EXPECT_EQ(renderer.GetPixels()[1], 0xffffffffu);
+    EXPECT_EQ(renderer.GetPixels()[2], 0xff000000u);
+}
+
+TEST(SoftwareRendererTest, KernelsAgree)
+{
+    // Random premultiplied sprite with odd sizes to exercise the row tails
+    std::mt19937 random(335);
+    SoftwareRenderer::Sprite sprite;
+    sprite.width = 37;
+    sprite.height = 5;
+    for (int i = 0; i < sprite.width * sprite.height; i++)
+    {
+        uint32_t alpha = i % 7 == 0 ? 0 : i % 5 == 0 ? 255 : random() % 256;
+        uint32_t pixel = alpha << 24;
+        for (int shift = 0; shift < 24; shift += 8)
+        {
+            pixel |= (random() % (alpha + 1)) << shift;
+        }
+        sprite.pixels.push_back(pixel);
+    }
+
+    SoftwareRenderer reference;
+    ASSERT_TRUE(reference.SetKernel(Kernel::Scalar));
+    reference.Begin(41, 9, 0xff336699);
+    reference.Blit(sprite, 3, 2);
+
+    for (auto kernel : {Kernel::SSE2, Kernel::AVX2})
+    {
+        SoftwareRenderer renderer;
+        if (!renderer.SetKernel(kernel))
+        {
+            continue;
+        }
+        renderer.Begin(41, 9, 0xff336699);
+        renderer.Blit(sprite, 3, 2);
+        EXPECT_EQ(renderer.GetPixels(), reference.GetPixels()) << SoftwareRenderer::KernelName(kernel);
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ * @file TelemetryTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Telemetry.h>
+#include <thread>
+
+using Counter = Telemetry::Counter;
+
+TEST(TelemetryTest, Buckets)
+{
+    EXPECT_EQ(Telemetry::Bucket(0), 0);
+    EXPECT_EQ(Telemetry::Bucket(1), 1);
+    EXPECT_EQ(Telemetry::Bucket(2), 2);
+    EXPECT_EQ(Telemetry::Bucket(3), 2);
+    EXPECT_EQ(Telemetry::Bucket(4), 3);
+    EXPECT_EQ(Telemetry::Bucket(~uint64_t(0)), Telemetry::Buckets - 1);
+}
+
+TEST(TelemetryTest, Threads)
+{
+    Telemetry::Reset();
+
+    // Counts on a thread that has exited are kept
+    std::thread worker([]() {
+        Telemetry::Count(Counter::NarrowTests, 5);
+        Telemetry::EndFrame(0.001);
+    });
+    worker.join();
+
+    Telemetry::Count(Counter::NarrowTests, 2);
+    Telemetry::Count(Counter::SubSteps);
+    EXPECT_EQ(Telemetry::GetTotal(Counter::NarrowTests), 7u);
+    EXPECT_EQ(Telemetry::GetTotal(Counter::SubSteps), 1u);
+
+    // Two frames, with 3 and then 0 narrow tests counted in them
+    Telemetry::Count(Counter::NarrowTests);
+    Telemetry::EndFrame(0.002);
+    Telemetry::EndFrame(0.002);
+
+    auto json = Telemetry::ToJson();
+    EXPECT_NE(json.find("\"frames\":3"), std::string::npos);
+    EXPECT_NE(json.find("\"narrow_tests\":8"), std::string::npos);
+    EXPECT_NE(json.find("\"narrow_tests\":[{\"min\":0,\"max\":0,\"count\":1},"
+                        "{\"min\":2,\"max\":3,\"count\":1},{\"min\":4,\"max\":7,\"count\":1}]"), std::string::npos);
+
+    Telemetry::Reset();
+    EXPECT_EQ(Telemetry::GetTotal(Counter::NarrowTests), 0u);
+}
+
+TEST(TelemetryTest, ResetFromAnotherThread)
+{
+    Telemetry::Reset();
+    Telemetry::Count(Counter::ContactsMerged, 200);
+    Telemetry::EndFrame(0.001);
+
+    // The frame open on this thread starts again from zero
+    Telemetry::Count(Counter::ContactsMerged, 50);
+    std::thread other([]() { Telemetry::Reset(); });
+    other.join();
+    Telemetry::Count(Counter::ContactsMerged, 250);
+    Telemetry::EndFrame(0.001);
+
+    EXPECT_EQ(Telemetry::GetTotal(Counter::ContactsMerged), 250u);
+    auto json = Telemetry::ToJson();
+    EXPECT_NE(json.find("\"contacts_merged\":[{\"min\":128,\"max\":255,\"count\":1}]"), std::string::npos);
+}
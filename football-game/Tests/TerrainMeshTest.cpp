@@ -0,0 +1,127 @@
+/**
+ * @file TerrainMeshTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Game.h>
+#include <Football.h>
+#include <LevelData.h>
+#include <TerrainMesh.h>
+
+/// A floor, a block of two stacked walls side by side, a short platform and a moving one
+static const char* MeshLevel = R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="2048" height="1024" start-y="900" start-x="400">
+  <declarations>
+    <platform id="i001" left-image="metalLeft.png" mid-image="metalMid.png" right-image="metalRight.png"/>
+    <wall id="i002" image="wall1.png"/>
+    <movingplatform id="i003" left-image="metalLeft.png" mid-image="metalMid.png" right-image="metalRight.png"/>
+  </declarations>
+  <items>
+    <platform id="i001" x="1024" y="1008" width="2048" height="32"/>
+    <wall id="i002" x="1200" y="928" width="32" height="128"/>
+    <wall id="i002" x="1232" y="928" width="32" height="128"/>
+    <platform id="i001" x="205" y="700" width="96" height="32"/>
+    <movingplatform id="i003" cx="1600" cy="600" radius="50" omega="1" width="96"/>
+  </items>
+</level>
+)";
+
+/**
+ * Load the test level
+ * @param game Game to load into
+ */
+static void LoadMeshLevel(Game& game)
+{
+    LevelData level;
+    ASSERT_TRUE(level.Load(MeshLevel, strlen(MeshLevel)));
+    game.LoadLevelData(level, L"mesh.xml");
+}
+
+/**
+ * Find the rectangle with a top left corner
+ * @param mesh Mesh to look in
+ * @param left Left edge
+ * @param top Top edge
+ * @return The rectangle, or nullptr if there is none
+ */
+static const TerrainMesh::Rect* Find(const TerrainMesh& mesh, double left, double top)
+{
+    for (auto& rect : mesh.GetRects())
+    {
+        if (rect.left == left && rect.top == top)
+        {
+            return &rect;
+        }
+    }
+    return nullptr;
+}
+
+TEST(TerrainMeshTest, Merges)
+{
+    Game game;
+    LoadMeshLevel(game);
+    game.Update(0.001);
+
+    // 64 floor segments, 8 wall pieces and 3 platform segments
+    auto& mesh = game.GetTerrainMesh();
+    ASSERT_TRUE(mesh.IsValid());
+    EXPECT_EQ(75, mesh.GetSourceCount());
+    ASSERT_EQ(3u, mesh.GetRects().size());
+
+    auto floor = Find(mesh, 0, 992);
+    ASSERT_NE(nullptr, floor);
+    EXPECT_DOUBLE_EQ(2048, floor->right);
+    EXPECT_DOUBLE_EQ(1024, floor->bottom);
+
+    // The walls stack, then the stacks merge side by side
+    auto walls = Find(mesh, 1184, 864);
+    ASSERT_NE(nullptr, walls);
+    EXPECT_DOUBLE_EQ(1248, walls->right);
+    EXPECT_DOUBLE_EQ(992, walls->bottom);
+
+    auto platform = Find(mesh, 157, 684);
+    ASSERT_NE(nullptr, platform);
+    EXPECT_DOUBLE_EQ(253, platform->right);
+}
+
+TEST(TerrainMeshTest, FindContacts)
+{
+    Game game;
+    LoadMeshLevel(game);
+    game.Update(0.001);
+    auto& mesh = game.GetTerrainMesh();
+
+    // The floor spans every column but is found once
+    ContactManifold contacts;
+    EXPECT_EQ(2, mesh.FindContacts(1100, 900, 1190, 992, contacts));
+    EXPECT_EQ(2, contacts.GetCount());
+
+    contacts.Clear();
+    EXPECT_EQ(0, mesh.FindContacts(500, 100, 600, 200, contacts));
+}
+
+TEST(TerrainMeshTest, FootballLands)
+{
+    Game game;
+    LoadMeshLevel(game);
+    for (int i = 0; i < 120; i++)
+    {
+        game.Update(1.0 / 60);
+    }
+
+    // One floor rectangle instead of the segments under the football
+    auto football = game.GetFootball();
+    EXPECT_TRUE(football->GetGrounded());
+    EXPECT_DOUBLE_EQ(992, football->GetY() + football->GetHeight() / 2);
+    EXPECT_EQ(1, game.GetNarrowTests());
+
+    // Running into the walls stops at their left side
+    for (int i = 0; i < 300; i++)
+    {
+        game.ApplyInput(false, true, false);
+        game.Update(1.0 / 60);
+    }
+    EXPECT_DOUBLE_EQ(1184, football->GetX() + football->GetWidth() / 2);
+}
@@ -0,0 +1,142 @@
+/**
+ * @file TileMapTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Game.h>
+#include <Football.h>
+#include <LevelData.h>
+#include <ItemArchetype.h>
+#include <TileMap.h>
+
+/// A floor on the tile grid, a platform off it and a wall on it
+static const char* TiledLevel = R"(<?xml version="1.0" encoding="UTF-8"?>
+<level width="2048" height="1024" start-y="900" start-x="400">
+  <declarations>
+    <platform id="i001" left-image="metalLeft.png" mid-image="metalMid.png" right-image="metalRight.png"/>
+    <wall id="i002" image="wall1.png"/>
+  </declarations>
+  <items>
+    <platform id="i001" x="1024" y="1008" width="2048" height="32"/>
+    <platform id="i001" x="200" y="700" width="96" height="32"/>
+    <wall id="i002" x="1200" y="928" width="32" height="128"/>
+  </items>
+</level>
+)";
+
+/**
+ * Load the test level
+ * @param game Game to load into
+ * @param tiled Put the terrain on the tile map?
+ */
+static void LoadTiled(Game& game, bool tiled)
+{
+    LevelData level;
+    ASSERT_TRUE(level.Load(TiledLevel, strlen(TiledLevel)));
+    game.SetTiledTerrain(tiled);
+    game.LoadLevelData(level, L"tiled.xml");
+}
+
+TEST(TileMapTest, Place)
+{
+    ItemArchetype tile;
+    tile.width = 32;
+    tile.height = 32;
+    ItemArchetype other = tile;
+    ItemArchetype large = tile;
+    large.width = 64;
+
+    TileMap map;
+    EXPECT_FALSE(map.Place(&tile, 16, 16));
+
+    map.Reset(100, 64);
+    EXPECT_EQ(4, map.GetColumns());
+    EXPECT_EQ(2, map.GetRows());
+
+    EXPECT_TRUE(map.Place(&tile, 16, 16));
+    EXPECT_TRUE(map.Place(&other, 48, 16));
+    EXPECT_TRUE(map.Place(&tile, 112, 48));
+
+    // Off the grid, taken, the wrong size or outside the level
+    EXPECT_FALSE(map.Place(&tile, 20, 48));
+    EXPECT_FALSE(map.Place(&tile, 16, 16));
+    EXPECT_FALSE(map.Place(&large, 80, 48));
+    EXPECT_FALSE(map.Place(&tile, 144, 16));
+
+    EXPECT_EQ(3, map.GetFilled());
+    EXPECT_EQ(&tile, map.GetArchetype(map.GetTile(0, 0)));
+    EXPECT_EQ(&other, map.GetArchetype(map.GetTile(1, 0)));
+    EXPECT_EQ(map.GetTile(0, 0), map.GetTile(3, 1));
+    EXPECT_EQ(0, map.GetTile(2, 0));
+    EXPECT_EQ(0, map.GetTile(-1, 0));
+
+    map.Clear();
+    EXPECT_FALSE(map.IsActive());
+    EXPECT_EQ(0, map.GetFilled());
+}
+
+TEST(TileMapTest, FindContacts)
+{
+    ItemArchetype tile;
+    tile.width = 32;
+    tile.height = 32;
+
+    TileMap map;
+    map.Reset(256, 256);
+    for (int column = 0; column < 8; column++)
+    {
+        map.Place(&tile, column * 32 + 16, 208);
+    }
+    map.Place(&tile, 112, 176);
+
+    // A row of tiles is one box, the tile above it another
+    ContactManifold contacts;
+    EXPECT_TRUE(map.FindContacts(70, 150, 130, 200, contacts));
+    ASSERT_EQ(2, contacts.GetCount());
+    auto& floor = contacts.GetContact(0).top == 192 ? contacts.GetContact(0) : contacts.GetContact(1);
+    EXPECT_DOUBLE_EQ(64, floor.left);
+    EXPECT_DOUBLE_EQ(160, floor.right);
+    EXPECT_EQ(nullptr, floor.item);
+
+    contacts.Clear();
+    EXPECT_FALSE(map.FindContacts(0, 0, 100, 100, contacts));
+    EXPECT_EQ(0, contacts.GetCount());
+}
+
+TEST(TileMapTest, TiledLevel)
+{
+    Game items;
+    LoadTiled(items, false);
+    Game tiles;
+    LoadTiled(tiles, true);
+
+    // The floor and the wall are tiles, the platform off the grid is not
+    auto& map = tiles.GetTileMap();
+    ASSERT_TRUE(map.IsActive());
+    EXPECT_EQ(64, map.GetColumns());
+    EXPECT_EQ(32, map.GetRows());
+    EXPECT_EQ(64 + 4, map.GetFilled());
+    EXPECT_EQ(items.CountItems() - 68, tiles.CountItems());
+    EXPECT_FALSE(items.GetTileMap().IsActive());
+
+    // The football lands on the floor the same way either way
+    for (int i = 0; i < 120; i++)
+    {
+        items.Update(1.0 / 60);
+        tiles.Update(1.0 / 60);
+    }
+    EXPECT_TRUE(tiles.GetFootball()->GetGrounded());
+    EXPECT_DOUBLE_EQ(992, tiles.GetFootball()->GetY() + tiles.GetFootball()->GetHeight() / 2);
+    EXPECT_DOUBLE_EQ(items.GetFootball()->GetX(), tiles.GetFootball()->GetX());
+    EXPECT_DOUBLE_EQ(items.GetFootball()->GetY(), tiles.GetFootball()->GetY());
+
+    // The wall stops the football running right
+    for (int i = 0; i < 300; i++)
+    {
+        tiles.ApplyInput(false, true, false);
+        tiles.Update(1.0 / 60);
+    }
+    EXPECT_DOUBLE_EQ(1184, tiles.GetFootball()->GetX() + tiles.GetFootball()->GetWidth() / 2);
+}
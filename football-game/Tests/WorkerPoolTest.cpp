@@ -0,0 +1,56 @@
+/**
+ * @file WorkerPoolTest.cpp
+ * @author Brennan Eagle
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <WorkerPool.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(WorkerPoolTest, RunsEveryTaskOnce)
+{
+    WorkerPool pool(4);
+    EXPECT_EQ(4, pool.GetThreads());
+
+    // The same threads serve run after run
+    for (size_t count : {0, 1, 3, 100, 1000})
+    {
+        std::vector<std::atomic<int>> runs(count);
+        pool.Run(count, [&runs](size_t i) { runs[i]++; });
+        for (auto& run : runs)
+        {
+            EXPECT_EQ(1, run.load());
+        }
+    }
+}
+
+TEST(WorkerPoolTest, RunsTakeTurns)
+{
+    WorkerPool pool(3);
+    std::atomic<int> total(0);
+
+    auto work = [&pool, &total]() {
+        for (int r = 0; r < 50; r++)
+        {
+            pool.Run(20, [&total](size_t) { total++; });
+        }
+    };
+    std::thread other(work);
+    work();
+    other.join();
+
+    EXPECT_EQ(2 * 50 * 20, total.load());
+}
+
+TEST(WorkerPoolTest, NoThreads)
+{
+    WorkerPool pool(1);
+    EXPECT_EQ(1, pool.GetThreads());
+
+    int sum = 0;
+    pool.Run(10, [&sum](size_t i) { sum += int(i); });
+    EXPECT_EQ(45, sum);
+}
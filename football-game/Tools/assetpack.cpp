@@ -0,0 +1,108 @@
+/**
+ * @file assetpack.cpp
+ * @author Brennan Eagle
+ *
+ * Bundles the levels and images into one pack file.
+ *
+ * Usage: assetpack [--data DIR] [--output FILE]
+ *
+ * DIR holds the images and levels directories, the build
+ * directory by default. Every file under them is put in the
+ * pack, named by its path from DIR. FILE is DIR/assets.pack by
+ * default, which is where the game looks for it. Delete the
+ * pack to go back to reading loose files.
+ */
+
+#include <pch.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <AssetPack.h>
+
+/// Directories under the data directory that are packed
+const char* PackedDirectories[] = {"images", "levels"};
+
+/**
+ * Print how to use the tool
+ */
+static void Usage()
+{
+    std::printf("usage: assetpack [--data DIR] [--output FILE]\n");
+}
+
+/**
+ * Build the pack
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Exit status
+ */
+int main(int argc, char** argv)
+{
+    std::filesystem::path data = ".";
+    std::filesystem::path output;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--data") == 0)
+        {
+            data = argv[++i];
+        }
+        else if (hasValue && std::strcmp(argv[i], "--output") == 0)
+        {
+            output = argv[++i];
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    if (output.empty())
+    {
+        output = data / "assets.pack";
+    }
+
+    std::vector<std::wstring> names;
+    for (auto directory : PackedDirectories)
+    {
+        std::error_code error;
+        for (auto& entry : std::filesystem::recursive_directory_iterator(data / directory, error))
+        {
+            if (entry.is_regular_file())
+            {
+                names.push_back(entry.path().lexically_relative(data).generic_wstring());
+            }
+        }
+    }
+    std::sort(names.begin(), names.end());
+
+    if (names.empty())
+    {
+        std::fprintf(stderr, "No images or levels in %s\n", data.string().c_str());
+        return 1;
+    }
+
+    if (!AssetPack::Write(output.wstring(), data.wstring(), names))
+    {
+        std::fprintf(stderr, "Unable to write %s\n", output.string().c_str());
+        return 1;
+    }
+
+    // Read it back, so a pack the game cannot open is never left behind
+    AssetPack pack;
+    if (!pack.Open(output.wstring()) || pack.GetCount() != names.size())
+    {
+        std::fprintf(stderr, "%s did not read back\n", output.string().c_str());
+        pack.Close();
+        std::filesystem::remove(output);
+        return 1;
+    }
+
+    std::printf("%zu assets, %zu bytes in %s\n", pack.GetCount(), pack.GetSize(), output.string().c_str());
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file batchsim.cpp
+ * @author Brennan Eagle
+ *
+ * Plays many headless games at once and reports the simulation rate.
+ *
+ * Usage: batchsim [--instances N] [--threads T] [--ticks K] [--level L] [--data DIR]
+ *                 [--telemetry FILE]
+ *
+ * DIR holds the images and levels directories, the build
+ * directory by default.
+ */
+
+#include <pch.h>
+#include <wx/init.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <BatchRunner.h>
+#include <Telemetry.h>
+
+/**
+ * Print how to use the tool
+ */
+static void Usage()
+{
+    std::printf("usage: batchsim [--instances N] [--threads T] [--ticks K] [--level L] [--data DIR]\n"
+                "                [--telemetry FILE]\n");
+}
+
+/**
+ * Run the batch
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Exit status
+ */
+int main(int argc, char** argv)
+{
+    int instances = 1000;
+    int threads = 0;
+    long ticks = 600;
+    int level = 1;
+    const char* data = nullptr;
+    const char* telemetry = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--instances") == 0)
+        {
+            instances = std::atoi(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--threads") == 0)
+        {
+            threads = std::atoi(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--ticks") == 0)
+        {
+            ticks = std::atol(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--level") == 0)
+        {
+            level = std::atoi(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--data") == 0)
+        {
+            data = argv[++i];
+        }
+        else if (hasValue && std::strcmp(argv[i], "--telemetry") == 0)
+        {
+            telemetry = argv[++i];
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    // wxWidgets without a GUI, for the image handlers and logging
+    wxInitializer initializer(argc, argv);
+    if (!initializer.IsOk())
+    {
+        std::fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+    wxInitAllImageHandlers();
+
+    if (data != nullptr && !wxSetWorkingDirectory(data))
+    {
+        std::fprintf(stderr, "No such directory: %s\n", data);
+        return 1;
+    }
+
+    BatchRunner runner(std::make_shared<AssetCache>(true), threads);
+    auto result = runner.Run(instances, level, ticks);
+
+    std::printf("instances:        %d\n", result.instances);
+    std::printf("threads:          %d\n", result.threads);
+    std::printf("ticks:            %lld\n", result.ticks);
+    std::printf("reached goal:     %d\n", result.completed);
+    std::printf("wall time:        %.3f s\n", result.seconds);
+    std::printf("ticks/s:          %.0f\n", result.TicksPerSecond());
+    std::printf("ticks/s per core: %.0f\n", result.TicksPerSecondPerCore());
+
+    if (telemetry != nullptr && !Telemetry::Write(wxString(telemetry).ToStdWstring()))
+    {
+        std::fprintf(stderr, "Unable to write %s\n", telemetry);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file drawbench.cpp
+ * @author Brennan Eagle
+ *
+ * Times drawing a level with each renderer.
+ *
+ * Plays the same run through a level once per renderer, drawing
+ * every tick into an offscreen image, and reports the draw time
+ * per frame: the graphics context, then the software renderer
+ * with each blending kernel this processor runs.
+ *
+ * Usage: drawbench [--level L] [--frames N] [--width W] [--height H] [--data DIR]
+ *
+ * DIR holds the images and levels directories, the build
+ * directory by default. Bitmaps are made, so this needs a
+ * display on platforms where wxWidgets does.
+ */
+
+#include <pch.h>
+#include <wx/init.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <Game.h>
+#include <BatchRunner.h>
+
+/**
+ * Print how to use the tool
+ */
+static void Usage()
+{
+    std::printf("usage: drawbench [--level L] [--frames N] [--width W] [--height H] [--data DIR]\n");
+}
+
+/**
+ * Play the run and time the drawing
+ * @param game Game at the start of the level
+ * @param start Snapshot of the level start
+ * @param frames Frames to draw
+ * @param width Frame width in pixels
+ * @param height Frame height in pixels
+ * @return Milliseconds per frame
+ */
+static double TimeFrames(Game& game, GameSnapshot& start, int frames, int width, int height)
+{
+    game.Restore(start);
+
+    wxImage image(width, height);
+    auto graphics = std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create(image));
+
+    std::chrono::duration<double> drawing(0);
+    for (int frame = 0; frame < frames; frame++)
+    {
+        BatchRunner::DefaultPolicy(game, 0, frame);
+        game.Update(1.0 / 60);
+
+        auto before = std::chrono::steady_clock::now();
+        game.OnDraw(graphics, width, height);
+        drawing += std::chrono::steady_clock::now() - before;
+    }
+    return frames > 0 ? drawing.count() * 1000 / frames : 0;
+}
+
+/**
+ * Run the benchmark
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Exit status
+ */
+int main(int argc, char** argv)
+{
+    int level = 1;
+    int frames = 600;
+    int width = 1280;
+    int height = 720;
+    const char* data = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--level") == 0)
+        {
+            level = std::atoi(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--frames") == 0)
+        {
+            frames = std::atoi(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--width") == 0)
+        {
+            width = std::atoi(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--height") == 0)
+        {
+            height = std::atoi(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--data") == 0)
+        {
+            data = argv[++i];
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    // A GUI application object without a main loop, so bitmaps can be made
+    wxApp::SetInstance(new wxApp());
+    if (!wxEntryStart(argc, argv) || !wxTheApp->CallOnInit())
+    {
+        std::fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+    wxInitAllImageHandlers();
+
+    if (data != nullptr && !wxSetWorkingDirectory(data))
+    {
+        std::fprintf(stderr, "No such directory: %s\n", data);
+        wxEntryCleanup();
+        return 1;
+    }
+
+    Game game;
+    game.SetRewindEnabled(false);
+    game.SetAdvanceOnGoal(false);
+    game.LoadLevel(level);
+
+    GameSnapshot start;
+    game.Snapshot(start);
+
+    std::printf("%d frames at %dx%d\n", frames, width, height);
+
+    game.SetSoftwareRendering(false);
+    std::printf("graphics context:   %.3f ms/frame\n", TimeFrames(game, start, frames, width, height));
+
+    game.SetSoftwareRendering(true);
+    auto& renderer = game.GetSoftwareRenderer();
+    for (auto kernel : {SoftwareRenderer::Kernel::Scalar, SoftwareRenderer::Kernel::SSE2,
+                        SoftwareRenderer::Kernel::AVX2})
+    {
+        if (renderer.SetKernel(kernel))
+        {
+            double ms = TimeFrames(game, start, frames, width, height);
+            std::printf("software (%-6ls):  %.3f ms/frame\n", SoftwareRenderer::KernelName(kernel), ms);
+        }
+    }
+
+    wxEntryCleanup();
+    return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file levelcheck.cpp
+ * @author Brennan Eagle
+ *
+ * Checks every level in a directory for mistakes.
+ *
+ * Usage: levelcheck [--dir DIR] [--threads T] [--data DIR] [--quiet]
+ *
+ * --dir holds the levels, the levels directory by default.
+ * --data holds the images and levels directories, the build
+ * directory by default. Each problem is printed with where it
+ * is, followed by a line per level with its item counts. The
+ * exit status is 2 if any level has a problem, so the tool can
+ * gate a build.
+ */
+
+#include <pch.h>
+#include <wx/init.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <LevelChecker.h>
+
+/**
+ * Print how to use the tool
+ */
+static void Usage()
+{
+    std::printf("usage: levelcheck [--dir DIR] [--threads T] [--data DIR] [--quiet]\n");
+}
+
+/**
+ * Check the levels
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Exit status
+ */
+int main(int argc, char** argv)
+{
+    const char* dir = "levels";
+    int threads = 0;
+    const char* data = nullptr;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--dir") == 0)
+        {
+            dir = argv[++i];
+        }
+        else if (hasValue && std::strcmp(argv[i], "--threads") == 0)
+        {
+            threads = std::atoi(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--data") == 0)
+        {
+            data = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--quiet") == 0)
+        {
+            quiet = true;
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    // wxWidgets without a GUI, for the image handlers and logging
+    wxInitializer initializer(argc, argv);
+    if (!initializer.IsOk())
+    {
+        std::fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+    wxInitAllImageHandlers();
+
+    // The level directory is taken before moving to the data directory
+    wxFileName levelDir = wxFileName::DirName(dir);
+    levelDir.MakeAbsolute();
+
+    if (data != nullptr && !wxSetWorkingDirectory(data))
+    {
+        std::fprintf(stderr, "No such directory: %s\n", data);
+        return 1;
+    }
+
+    auto levels = LevelChecker::FindLevels(levelDir.GetPath().ToStdWstring());
+    if (levels.empty())
+    {
+        std::fprintf(stderr, "No levels in %s\n", dir);
+        return 1;
+    }
+
+    LevelChecker checker(std::make_shared<AssetCache>(true), threads);
+    auto start = std::chrono::steady_clock::now();
+    auto reports = checker.CheckAll(levels);
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    int problems = 0;
+    for (auto& report : reports)
+    {
+        auto name = wxFileName(report.filename).GetFullName();
+        for (auto& issue : report.issues)
+        {
+            std::printf("%s:%.0f,%.0f: %ls: %ls\n", name.utf8_str().data(), issue.x, issue.y,
+                        LevelChecker::ProblemName(issue.problem), issue.detail.c_str());
+        }
+        problems += int(report.issues.size());
+
+        if (!quiet)
+        {
+            std::printf("%s: %zu problems in %.1f ms;", name.utf8_str().data(), report.issues.size(),
+                        report.seconds * 1000);
+            for (auto& count : report.counts)
+            {
+                std::printf(" %ls %d", count.first.c_str(), count.second);
+            }
+            std::printf("\n");
+        }
+    }
+
+    std::printf("%zu levels, %d problems, %d threads, %.3f s\n", reports.size(), problems,
+                checker.GetThreads(), wall.count());
+    return problems > 0 ? 2 : 0;
+}
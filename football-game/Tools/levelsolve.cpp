@@ -0,0 +1,139 @@
+/**
+ * @file levelsolve.cpp
+ * @author Brennan Eagle
+ *
+ * Checks that a level can be completed and finds the fastest route.
+ *
+ * Usage: levelsolve [--level L | --file LEVEL.xml] [--window TICKS]
+ *                   [--max-time SECONDS] [--max-expansions N] [--bfs] [--data DIR]
+ *
+ * DIR holds the images and levels directories, the build
+ * directory by default.
+ */
+
+#include <pch.h>
+#include <wx/init.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <Game.h>
+#include <LevelSolver.h>
+
+/**
+ * Print how to use the tool
+ */
+static void Usage()
+{
+    std::printf("usage: levelsolve [--level L | --file LEVEL.xml] [--window TICKS]\n"
+                "                  [--max-time SECONDS] [--max-expansions N] [--bfs] [--data DIR]\n");
+}
+
+/**
+ * Run the solver
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return 0 if the level was solved, 2 if not, 1 on error
+ */
+int main(int argc, char** argv)
+{
+    int level = 1;
+    const char* file = nullptr;
+    const char* data = nullptr;
+    LevelSolver::Options options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--level") == 0)
+        {
+            level = std::atoi(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--file") == 0)
+        {
+            file = argv[++i];
+        }
+        else if (hasValue && std::strcmp(argv[i], "--window") == 0)
+        {
+            options.window = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (hasValue && std::strcmp(argv[i], "--max-time") == 0)
+        {
+            options.maxTime = std::atof(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--max-expansions") == 0)
+        {
+            options.maxExpansions = std::atol(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--bfs") == 0)
+        {
+            options.astar = false;
+        }
+        else if (hasValue && std::strcmp(argv[i], "--data") == 0)
+        {
+            data = argv[++i];
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    // wxWidgets without a GUI, for the image handlers and logging
+    wxInitializer initializer(argc, argv);
+    if (!initializer.IsOk())
+    {
+        std::fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+    wxInitAllImageHandlers();
+
+    if (data != nullptr && !wxSetWorkingDirectory(data))
+    {
+        std::fprintf(stderr, "No such directory: %s\n", data);
+        return 1;
+    }
+
+    Game game(std::make_shared<AssetCache>(true));
+    if (file != nullptr)
+    {
+        game.Load(wxString(file));
+    }
+    else
+    {
+        game.LoadLevel(level);
+    }
+
+    LevelSolver solver(&game);
+    auto result = solver.Solve(options);
+
+    std::printf("expansions:       %ld\n", result.expansions);
+    std::printf("nodes:            %ld\n", result.generated);
+    std::printf("state memory:     %zu bytes\n", result.stateBytes);
+    std::printf("search time:      %.3f s\n", result.seconds);
+    std::printf("expansions/s:     %.0f\n", result.ExpansionsPerSecond());
+
+    if (!result.solved)
+    {
+        std::printf("no route to the goal post found\n");
+        return 2;
+    }
+
+    std::printf("time to goal:     %.3f s\n", result.time);
+    std::printf("route:           ");
+
+    // Print repeated actions as one step
+    for (size_t i = 0; i < result.actions.size(); )
+    {
+        size_t run = i;
+        while (run < result.actions.size() && result.actions[run] == result.actions[i])
+        {
+            run++;
+        }
+        std::printf(" %ls x%zu", LevelSolver::ActionName(result.actions[i]), run - i);
+        i = run;
+    }
+    std::printf("\n");
+    return 0;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file loadbench.cpp
+ * @author Brennan Eagle
+ *
+ * Times starting the game and loading each level.
+ *
+ * Every run starts from an empty image cache, so each image is
+ * decoded again. The game is started, then every level is loaded
+ * in turn, first decoding on one thread and then on T threads.
+ * The best of N runs is reported for each.
+ *
+ * Usage: loadbench [--threads T] [--runs N] [--data DIR] [--disk-cache CACHE]
+ *
+ * DIR holds the images and levels directories, the build
+ * directory by default. With --disk-cache, decoded images are
+ * kept in the CACHE directory. The first run fills it and the
+ * rest map the images from it, so the best run shows a warm
+ * start. Bitmaps are made, so this needs a
+ * display on platforms where wxWidgets does.
+ */
+
+#include <pch.h>
+#include <wx/init.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <Game.h>
+
+/**
+ * Print how to use the tool
+ */
+static void Usage()
+{
+    std::printf("usage: loadbench [--threads T] [--runs N] [--data DIR] [--disk-cache CACHE]\n");
+}
+
+/**
+ * Start a game on an empty cache and load every level
+ * @param threads Threads to decode images on
+ * @param diskCache Directory decoded images are kept in, empty for none
+ * @return Seconds to start, then seconds to load each level
+ */
+static std::vector<double> TimeLoads(int threads, const std::wstring& diskCache)
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto assets = std::make_shared<AssetCache>();
+    assets->SetDecodeThreads(threads);
+    assets->SetDiskCache(diskCache);
+
+    auto start = Clock::now();
+    Game game(assets);
+    std::vector<double> times = {std::chrono::duration<double>(Clock::now() - start).count()};
+
+    for (int level = 0; level < game.GetLevelCount(); level++)
+    {
+        start = Clock::now();
+        game.LoadLevel(level);
+        times.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return times;
+}
+
+/**
+ * Run the benchmark
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Exit status
+ */
+int main(int argc, char** argv)
+{
+    int threads = 0;
+    int runs = 5;
+    const char* data = nullptr;
+    std::wstring diskCache;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--threads") == 0)
+        {
+            threads = std::atoi(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--runs") == 0)
+        {
+            runs = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (hasValue && std::strcmp(argv[i], "--data") == 0)
+        {
+            data = argv[++i];
+        }
+        else if (hasValue && std::strcmp(argv[i], "--disk-cache") == 0)
+        {
+            diskCache = wxString(argv[++i]).ToStdWstring();
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    // A GUI application object without a main loop, so bitmaps can be made
+    wxApp::SetInstance(new wxApp());
+    if (!wxEntryStart(argc, argv) || !wxTheApp->CallOnInit())
+    {
+        std::fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+    wxInitAllImageHandlers();
+
+    if (data != nullptr && !wxSetWorkingDirectory(data))
+    {
+        std::fprintf(stderr, "No such directory: %s\n", data);
+        wxEntryCleanup();
+        return 1;
+    }
+
+    AssetCache probe;
+    probe.SetDecodeThreads(threads);
+    threads = probe.GetDecodeThreads();
+
+    for (int decode : {1, threads})
+    {
+        std::vector<double> best;
+        for (int run = 0; run < runs; run++)
+        {
+            auto times = TimeLoads(decode, diskCache);
+            if (best.empty())
+            {
+                best = times;
+            }
+            for (size_t i = 0; i < times.size(); i++)
+            {
+                best[i] = std::min(best[i], times[i]);
+            }
+        }
+
+        std::printf("%2d decode threads: start %.1f ms;", decode, best[0] * 1000);
+        for (size_t level = 1; level < best.size(); level++)
+        {
+            std::printf(" level %zu %.1f ms;", level - 1, best[level] * 1000);
+        }
+        std::printf("\n");
+
+        if (threads == 1)
+        {
+            break;
+        }
+    }
+
+    wxEntryCleanup();
+    return 0;
+}
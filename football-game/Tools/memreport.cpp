@@ -0,0 +1,97 @@
+/**
+ * @file memreport.cpp
+ * @author Brennan Eagle
+ *
+ * Reports the memory each level uses, as JSON.
+ *
+ * Usage: memreport [--level L] [--data DIR]
+ *
+ * Every level is reported unless one is chosen. Each level is
+ * loaded into its own headless game and asset cache, so the
+ * images counted are the ones that level uses. Images are
+ * counted at the size their bitmaps would take.
+ *
+ * DIR holds the images and levels directories, the build
+ * directory by default.
+ */
+
+#include <pch.h>
+#include <wx/init.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <Game.h>
+
+/**
+ * Print how to use the tool
+ */
+static void Usage()
+{
+    std::printf("usage: memreport [--level L] [--data DIR]\n");
+}
+
+/**
+ * Report the levels
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Exit status
+ */
+int main(int argc, char** argv)
+{
+    int only = -1;
+    const char* data = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--level") == 0)
+        {
+            only = std::atoi(argv[++i]);
+        }
+        else if (hasValue && std::strcmp(argv[i], "--data") == 0)
+        {
+            data = argv[++i];
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    // wxWidgets without a GUI, for the image handlers and logging
+    wxInitializer initializer(argc, argv);
+    if (!initializer.IsOk())
+    {
+        std::fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+    wxInitAllImageHandlers();
+
+    if (data != nullptr && !wxSetWorkingDirectory(data))
+    {
+        std::fprintf(stderr, "No such directory: %s\n", data);
+        return 1;
+    }
+
+    const int count = Game(std::make_shared<AssetCache>(true)).GetLevelCount();
+
+    std::printf("[");
+    bool first = true;
+    for (int level = 0; level < count; level++)
+    {
+        if (only >= 0 && level != only)
+        {
+            continue;
+        }
+
+        Game game(std::make_shared<AssetCache>(true));
+        game.LoadLevel(level);
+
+        std::printf("%s\n  {\"level\":%d,\"memory\":%s}", first ? "" : ",", level,
+                    game.GetMemoryReport().ToJson().c_str());
+        first = false;
+    }
+    std::printf("\n]\n");
+    return 0;
+}